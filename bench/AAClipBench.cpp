@@ -210,6 +210,34 @@ private:
     using INHERITED = Benchmark;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// This bench tests intersecting a complex aaclip with a path, e.g. a rounded rect nested inside a
+// circular clip.
+class AAClipPathOpBench : public Benchmark {
+    SkString fName;
+    SkAAClip fClip;
+    SkPath   fPath;
+    bool     fDoAA;
+
+public:
+    AAClipPathOpBench(bool doAA) : fDoAA(doAA) {
+        fName.printf("aaclip_op_path_%s", doAA ? "AA" : "BW");
+        fClip.setPath(SkPath::Circle(320, 240, 230), {0, 0, 640, 480}, true);
+        fPath.addRoundRect(SkRect::MakeLTRB(40.5f, 30.5f, 600.5f, 450.5f), 30, 30);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkAAClip clip = fClip;
+            clip.op(fPath, SkClipOp::kIntersect, fDoAA);
+        }
+    }
+private:
+    using INHERITED = Benchmark;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 class AAClipRegionBench : public Benchmark {
 public:
@@ -246,6 +274,8 @@ DEF_BENCH(return new AAClipBuilderBench(false, false);)
 DEF_BENCH(return new AAClipBuilderBench(false, true);)
 DEF_BENCH(return new AAClipBuilderBench(true, false);)
 DEF_BENCH(return new AAClipBuilderBench(true, true);)
+DEF_BENCH(return new AAClipPathOpBench(false);)
+DEF_BENCH(return new AAClipPathOpBench(true);)
 DEF_BENCH(return new AAClipRegionBench();)
 DEF_BENCH(return new AAClipBench(false, false);)
 DEF_BENCH(return new AAClipBench(false, true);)
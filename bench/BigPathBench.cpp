@@ -7,8 +7,11 @@
 
 #include "bench/Benchmark.h"
 #include "bench/BigPath.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPath.h"
+#include "src/core/SkBitmapDevice.h"
 #include "tools/ToolUtils.h"
 
 enum Align {
@@ -83,3 +86,62 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+// Fills the big path, scaled up to cover a 2048x2048 device, either with the usual scan converter
+// or split into bands on a thread pool (threads > 0).
+class BigPathBandsBench : public Benchmark {
+    static constexpr int kSize = 2048;
+
+    SkPath                      fPath;
+    SkString                    fName;
+    int                         fThreads;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+    std::unique_ptr<SkCanvas>   fCanvas;
+
+public:
+    explicit BigPathBandsBench(int threads) : fThreads(threads) {
+        if (threads > 0) {
+            fName.printf("bigpath_fill_bands_%d", threads);
+        } else {
+            fName.set("bigpath_fill_serial");
+        }
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fPath = BenchUtils::make_big_path();
+        fPath.transform(SkMatrix::RectToRect(fPath.getBounds(), SkRect::MakeIWH(kSize, kSize)));
+
+        fBitmap.allocN32Pixels(kSize, kSize);
+        auto device = sk_make_sp<SkBitmapDevice>(fBitmap);
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+            device->setPathExecutor(fExecutor.get());
+        }
+        fCanvas = std::make_unique<SkCanvas>(std::move(device));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < loops; i++) {
+            fCanvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new BigPathBandsBench(0); )
+DEF_BENCH( return new BigPathBandsBench(1); )
+DEF_BENCH( return new BigPathBandsBench(2); )
+DEF_BENCH( return new BigPathBandsBench(4); )
+DEF_BENCH( return new BigPathBandsBench(8); )
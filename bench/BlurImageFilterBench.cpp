@@ -161,3 +161,46 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+// Draws a blurred image that is much larger than the canvas, scrolling it a few pixels on every
+// draw, as a page with a blurred background would.
+class BlurImageFilterScrollBench : public Benchmark {
+public:
+    BlurImageFilterScrollBench(SkScalar sigma) : fSigma(sigma) {
+        fName.printf("blur_image_filter_scroll_%.2f", SkScalarToFloat(sigma));
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        if (!fCheckerboard) {
+            fCheckerboard = make_checkerboard(1024, 4096);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setImageFilter(SkImageFilters::Blur(fSigma, fSigma, nullptr));
+        SkSamplingOptions sampling;
+
+        for (int i = 0; i < loops; i++) {
+            int scroll = (i * 3) % (fCheckerboard->height() - canvas->imageInfo().height());
+            canvas->save();
+            canvas->translate(0, SkIntToScalar(-scroll));
+            canvas->drawImage(fCheckerboard, 0, 0, sampling, &paint);
+            canvas->restore();
+        }
+    }
+
+private:
+    SkString fName;
+    sk_sp<SkImage> fCheckerboard;
+    SkScalar fSigma;
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new BlurImageFilterScrollBench(BLUR_SIGMA_SMALL);)
+DEF_BENCH(return new BlurImageFilterScrollBench(BLUR_SIGMA_LARGE);)
@@ -7,6 +7,9 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
@@ -22,9 +25,11 @@
 class EncodeBench : public Benchmark {
 public:
     using Encoder = bool (*)(SkWStream*, const SkPixmap&);
-    EncodeBench(const char* filename, Encoder encoder, const char* encoderName)
+    // The source image is scaled up by |scale|, to measure encodes of larger images.
+    EncodeBench(const char* filename, Encoder encoder, const char* encoderName, int scale = 1)
         : fSourceFilename(filename)
         , fEncoder(encoder)
+        , fScale(scale)
         , fName(SkStringPrintf("Encode_%s_%s", filename, encoderName)) {}
 
     bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
@@ -33,6 +38,15 @@ public:
 
     void onDelayedSetup() override {
         SkAssertResult(GetResourceAsBitmap(fSourceFilename, &fBitmap));
+        if (fScale > 1) {
+            SkBitmap scaled;
+            scaled.allocPixels(fBitmap.info().makeWH(fBitmap.width()  * fScale,
+                                                     fBitmap.height() * fScale));
+            SkCanvas canvas(scaled);
+            canvas.scale(fScale, fScale);
+            canvas.drawImage(fBitmap.asImage(), 0, 0, SkSamplingOptions(SkFilterMode::kLinear));
+            fBitmap = scaled;
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
@@ -48,6 +62,7 @@ public:
 private:
     const char* fSourceFilename;
     Encoder     fEncoder;
+    int         fScale;
     SkString    fName;
     SkBitmap    fBitmap;
 };
@@ -58,6 +73,14 @@ static bool encode_jpeg(SkWStream* dst, const SkPixmap& src) {
     return SkJpegEncoder::Encode(dst, src, opts);
 }
 
+static bool encode_jpeg_strips(SkWStream* dst, const SkPixmap& src) {
+    static std::unique_ptr<SkExecutor> gExecutor = SkExecutor::MakeFIFOThreadPool();
+    SkJpegEncoder::Options opts;
+    opts.fQuality = 90;
+    opts.fExecutor = gExecutor.get();
+    return SkJpegEncoder::Encode(dst, src, opts);
+}
+
 static bool encode_webp_lossy(SkWStream* dst, const SkPixmap& src) {
     SkWebpEncoder::Options opts;
     opts.fCompression = SkWebpEncoder::Compression::kLossy;
@@ -82,6 +105,16 @@ static bool encode_png(SkWStream* dst,
     return SkPngEncoder::Encode(dst, src, opts);
 }
 
+static bool encode_png_bands(SkWStream* dst,
+                             const SkPixmap& src,
+                             SkPngEncoder::FilterSelection selection) {
+    static std::unique_ptr<SkExecutor> gExecutor = SkExecutor::MakeFIFOThreadPool();
+    SkPngEncoder::Options opts;
+    opts.fExecutor = gExecutor.get();
+    opts.fFilterSelection = selection;
+    return SkPngEncoder::Encode(dst, src, opts);
+}
+
 #define PNG(FLAG, ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
            return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL); }
 
@@ -90,6 +123,8 @@ static const char* srcs[2] = {"images/mandrill_512.png", "images/color_wheel.jpg
 // The Android Photos app uses a quality of 90 on JPEG encodes
 DEF_BENCH(return new EncodeBench(srcs[0], &encode_jpeg, "JPEG"));
 DEF_BENCH(return new EncodeBench(srcs[1], &encode_jpeg, "JPEG"));
+DEF_BENCH(return new EncodeBench(srcs[0], &encode_jpeg, "JPEG_4x", 4));
+DEF_BENCH(return new EncodeBench(srcs[0], &encode_jpeg_strips, "JPEG_strips_4x", 4));
 
 // TODO: What is the appropriate quality to use to benchmark WEBP encodes?
 DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossy, "WEBP"));
@@ -122,4 +157,11 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 6), "PNG_6n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
+#define PNG_BANDS(SELECTION) [](SkWStream* d, const SkPixmap& s) { \
+           return encode_png_bands(d, s, SkPngEncoder::FilterSelection::SELECTION); }
+
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_BANDS(kPerRow), "PNG_bands"));
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_BANDS(kPerBand), "PNG_bands_fast"));
+
+#undef PNG_BANDS
 #undef PNG
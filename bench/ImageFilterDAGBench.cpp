@@ -6,11 +6,15 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkPoint3.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/GrRecordingContext.h"
+#include "src/core/SkBitmapDevice.h"
 #include "tools/Resources.h"
 
 // Exercise a blur filter connected to 5 inputs of the same merge filter.
@@ -164,7 +168,79 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Draws a layer through a filter chain shaped like a heavy SVG filter: several independent
+// branches of blurs, morphology, convolution and lighting, merged at the end. The layer is drawn
+// into a 1024x1024 raster device, either serially or with the filters running on a thread pool
+// (threads > 0).
+class ImageFilterExecutorDAGBench : public Benchmark {
+    static constexpr int kSize = 1024;
+
+    SkString                    fName;
+    int                         fThreads;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+    std::unique_ptr<SkCanvas>   fCanvas;
+    SkPaint                     fLayerPaint;
+
+public:
+    explicit ImageFilterExecutorDAGBench(int threads) : fThreads(threads) {
+        if (threads > 0) {
+            fName.printf("image_filter_dag_svg_threads_%d", threads);
+        } else {
+            fName.set("image_filter_dag_svg_serial");
+        }
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(kSize, kSize);
+        auto device = sk_make_sp<SkBitmapDevice>(fBitmap);
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+            device->setImageFilterExecutor(fExecutor.get());
+        }
+        fCanvas = std::make_unique<SkCanvas>(std::move(device));
+
+        const SkScalar kernel[9] = { 0, -1, 0, -1, 5, -1, 0, -1, 0 };
+        sk_sp<SkImageFilter> blur = SkImageFilters::Blur(6, 6, nullptr);
+        sk_sp<SkImageFilter> shadow = SkImageFilters::Offset(
+                8, 8, SkImageFilters::Blur(12, 12, SkImageFilters::Erode(2, 2, nullptr)));
+        sk_sp<SkImageFilter> lit = SkImageFilters::Arithmetic(
+                0, 1, 1, 0, true, nullptr,
+                SkImageFilters::PointLitSpecular({512, 256, 300}, SK_ColorWHITE, 4, 0.8f, 16,
+                                                 blur));
+        sk_sp<SkImageFilter> edges = SkImageFilters::MatrixConvolution(
+                {3, 3}, kernel, 1, 0, {1, 1}, SkTileMode::kClamp, false,
+                SkImageFilters::Dilate(3, 3, nullptr));
+        sk_sp<SkImageFilter> inputs[] = { shadow, lit, edges };
+        fLayerPaint.setImageFilter(SkImageFilters::Merge(inputs, SK_ARRAY_COUNT(inputs)));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < loops; ++i) {
+            // Every layer is a new source image, so the filters can't reuse cached results.
+            fCanvas->saveLayer(nullptr, &fLayerPaint);
+            paint.setColor(0xFF2080C0 + i);
+            fCanvas->drawCircle(512, 512, 400, paint);
+            fCanvas->restore();
+        }
+    }
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
+DEF_BENCH(return new ImageFilterExecutorDAGBench(0);)
+DEF_BENCH(return new ImageFilterExecutorDAGBench(1);)
+DEF_BENCH(return new ImageFilterExecutorDAGBench(2);)
+DEF_BENCH(return new ImageFilterExecutorDAGBench(4);)
+DEF_BENCH(return new ImageFilterExecutorDAGBench(8);)
@@ -13,9 +13,10 @@
 #include "include/effects/SkImageFilters.h"
 #include "include/utils/SkRandom.h"
 
-#define SMALL   SkIntToScalar(2)
-#define REAL    1.5f
-#define BIG     SkIntToScalar(10)
+#define SMALL    SkIntToScalar(2)
+#define REAL     1.5f
+#define BIG      SkIntToScalar(10)
+#define VERY_BIG SkIntToScalar(64)
 
 enum MorphologyType {
     kErode_MT,
@@ -90,6 +91,9 @@ DEF_BENCH( return new MorphologyBench(SMALL, kDilate_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kDilate_MT); )
 
+DEF_BENCH( return new MorphologyBench(VERY_BIG, kErode_MT); )
+DEF_BENCH( return new MorphologyBench(VERY_BIG, kDilate_MT); )
+
 DEF_BENCH( return new MorphologyBench(REAL, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(REAL, kDilate_MT); )
 
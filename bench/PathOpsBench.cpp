@@ -81,6 +81,99 @@ private:
 DEF_BENCH( return new PathOpsBench("sect", kIntersect_SkPathOp); )
 DEF_BENCH( return new PathOpsBench("join", kUnion_SkPathOp); )
 
+enum class SmallPaths {
+    kOverlap,   // curves which cross each other
+    kDisjoint,  // shapes whose bounds don't touch
+    kRects,     // rects, one inside the other
+    kConvex,    // overlapping convex polygons
+};
+
+// Combines many small pairs of paths, either through Op() or through one reused SkOpContext.
+class PathOpsSmallBench : public Benchmark {
+    SkString    fName;
+    SkPathOp    fOp;
+    bool        fUseContext;
+    SmallPaths  fPaths;
+    SkTArray<SkPath> fOnes, fTwos;
+
+    enum { N = 100 };
+
+public:
+    PathOpsSmallBench(SmallPaths paths, SkPathOp op, bool useContext)
+            : fOp(op), fUseContext(useContext), fPaths(paths) {
+        const char* pathnames[] = { "overlap", "disjoint", "rects", "convex" };
+        fName.printf("pathops_small_%s_%s_%s", pathnames[(int)paths],
+                     op == kUnion_SkPathOp ? "join" : "sect", useContext ? "context" : "op");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < N; ++i) {
+            SkScalar x = rand.nextRangeScalar(0, 100),
+                     y = rand.nextRangeScalar(0, 100),
+                     size = rand.nextRangeScalar(5, 20);
+            SkRect rect = SkRect::MakeXYWH(x, y, size, size);
+            switch (fPaths) {
+                case SmallPaths::kOverlap:
+                    fOnes.push_back(SkPath::Oval(rect));
+                    fTwos.push_back(SkPath::Oval(rect.makeOffset(size / 2, size / 3)));
+                    break;
+                case SmallPaths::kDisjoint:
+                    fOnes.push_back(SkPath::Oval(rect));
+                    fTwos.push_back(SkPath::Rect(rect.makeOffset(size * 2, 0)));
+                    break;
+                case SmallPaths::kRects:
+                    fOnes.push_back(SkPath::Rect(rect));
+                    fTwos.push_back(SkPath::Rect(rect.makeInset(size / 4, size / 4)));
+                    break;
+                case SmallPaths::kConvex:
+                    fOnes.push_back(SkPath::Polygon({{x, y}, {x + size, y + size / 2},
+                                                     {x, y + size}}, true));
+                    fTwos.push_back(SkPath::Polygon({{x + size * 3 / 4, y},
+                                                     {x + size * 3 / 4, y + size},
+                                                     {x - size / 4, y + size / 2}}, true));
+                    break;
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkOpContext context;
+        SkPath result;
+        for (int i = 0; i < loops; i++) {
+            for (int j = 0; j < N; ++j) {
+                if (fUseContext) {
+                    context.op(fOnes[j], fTwos[j], fOp, &result);
+                } else {
+                    Op(fOnes[j], fTwos[j], fOp, &result);
+                }
+            }
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH( return new PathOpsSmallBench(SmallPaths::kOverlap, kUnion_SkPathOp, false); )
+DEF_BENCH( return new PathOpsSmallBench(SmallPaths::kOverlap, kUnion_SkPathOp, true); )
+DEF_BENCH( return new PathOpsSmallBench(SmallPaths::kOverlap, kIntersect_SkPathOp, false); )
+DEF_BENCH( return new PathOpsSmallBench(SmallPaths::kOverlap, kIntersect_SkPathOp, true); )
+DEF_BENCH( return new PathOpsSmallBench(SmallPaths::kDisjoint, kUnion_SkPathOp, false); )
+DEF_BENCH( return new PathOpsSmallBench(SmallPaths::kDisjoint, kUnion_SkPathOp, true); )
+DEF_BENCH( return new PathOpsSmallBench(SmallPaths::kRects, kUnion_SkPathOp, false); )
+DEF_BENCH( return new PathOpsSmallBench(SmallPaths::kRects, kUnion_SkPathOp, true); )
+DEF_BENCH( return new PathOpsSmallBench(SmallPaths::kConvex, kIntersect_SkPathOp, false); )
+DEF_BENCH( return new PathOpsSmallBench(SmallPaths::kConvex, kIntersect_SkPathOp, true); )
+
 static SkPath makerects() {
     SkRandom rand;
     SkPath path;
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkShader.h"
+#include "include/utils/SkRandom.h"
+
+// Fills the canvas with a picture shader pattern at a slightly different scale each draw, the way
+// a document being zoomed would.
+class PictureShaderZoomBench : public Benchmark {
+public:
+    PictureShaderZoomBench() {}
+
+protected:
+    const char* onGetName() override { return "picture_shader_zoom"; }
+
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(200, 200);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkRandom rand;
+        for (int i = 0; i < 100; ++i) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas->drawCircle(rand.nextRangeF(0, 200), rand.nextRangeF(0, 200),
+                               rand.nextRangeF(5, 30), paint);
+        }
+        fShader = recorder.finishRecordingAsPicture()->makeShader(
+                SkTileMode::kRepeat, SkTileMode::kRepeat, SkFilterMode::kLinear);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setShader(fShader);
+        for (int i = 0; i < loops; ++i) {
+            // Scales between 1 and 2, which don't repeat for a long while.
+            SkScalar scale = 1 + (fStep++ % 997) / 997.0f;
+            SkAutoCanvasRestore acr(canvas, true);
+            canvas->scale(scale, scale);
+            canvas->drawRect(SkRect::MakeWH(400, 400), paint);
+        }
+    }
+
+private:
+    sk_sp<SkShader> fShader;
+    int             fStep = 0;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new PictureShaderZoomBench(); )
@@ -26,7 +26,9 @@
 
 class SkAndroidCodec;
 class SkColorSpace;
+class SkColorXformPlan;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -289,6 +291,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -332,6 +335,13 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, codecs that color transform a large image after decoding it (currently
+         *  JPEG and WEBP) split the transform into bands of rows that run in parallel on this
+         *  executor.  Otherwise the transform runs on the calling thread.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -864,6 +874,10 @@ protected:
     // - WBMP is just Black/White
     virtual bool usesColorXform() const { return true; }
     void applyColorXform(void* dst, const void* src, int count) const;
+    // Transforms a block of rows at once, which is faster than a row at a time.  If 'executor' is
+    // not null, large blocks are split into bands that run on it in parallel.
+    void applyColorXform(void* dst, size_t dstRowBytes, const void* src, size_t srcRowBytes,
+                         int width, int height, SkExecutor* executor) const;
 
     bool colorXform() const { return fXformTime != kNo_XformTime; }
     bool xformOnDecode() const { return fXformTime == kDecodeRow_XformTime; }
@@ -899,6 +913,7 @@ private:
     XformFormat                        fDstXformFormat; // Based on fDstInfo.
     skcms_ICCProfile                   fDstProfile;
     skcms_AlphaFormat                  fDstXformAlphaFormat;
+    std::unique_ptr<SkColorXformPlan>  fColorXformPlan;    // Set up by initializeColorXform().
 
     // Only meaningful during scanline decodes.
     int                                fCurrScanline;
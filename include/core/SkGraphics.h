@@ -100,6 +100,21 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  Return the current limit to the number of compiled runtime effects that Skia keeps around
+     *  for its internally created effects (e.g. for color filters and image filters).
+     */
+    static int GetRuntimeEffectCacheCountLimit();
+
+    /**
+     *  Set the limit to the number of compiled runtime effects that Skia keeps around, and return
+     *  the previous value. If this new value is lower than the previous, the least recently used
+     *  effects are purged to meet the new limit.
+     *
+     *  See SkRuntimeEffect::PersistentCache for caching compiled effects across processes.
+     */
+    static int SetRuntimeEffectCacheCountLimit(int count);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -20,12 +20,14 @@
 #include "include/private/SkSLSampleUsage.h"
 #include "include/private/SkTOptional.h"
 
+#include <functional>
 #include <string>
 #include <vector>
 
 #ifdef SK_ENABLE_SKSL
 
 class GrRecordingContext;
+class SkExecutor;
 class SkFilterColorProgram;
 class SkImage;
 class SkRuntimeImageFilter;
@@ -101,12 +103,49 @@ public:
         int       index;
     };
 
+    /**
+     * Abstract class to provide access to a persistent cache of compiled SkSL programs. When one is
+     * passed in Options, the Make*() factories that take SkSL source look up the compiled (parsed,
+     * inlined and optimized) program there before invoking the compiler, and store it after a
+     * successful compile. This lets clients that create many effects at startup skip compilation
+     * entirely on subsequent runs.
+     *
+     * Keys capture the SkSL source, the effect kind, the options which affect compilation, and the
+     * version of the serialized format. Stored data is assumed to be trusted: it is checked for
+     * truncation and accidental corruption (and then compiled from source again), but it is not
+     * otherwise validated.
+     */
+    class SK_API PersistentCache {
+    public:
+        virtual ~PersistentCache() = default;
+
+        /**
+         * Returns the data for the key if it exists in the cache, otherwise returns null.
+         */
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        /**
+         * Stores data in the cache, indexed by key.
+         */
+        virtual void store(const SkData& key, const SkData& data) = 0;
+
+    protected:
+        PersistentCache() = default;
+        PersistentCache(const PersistentCache&) = delete;
+        PersistentCache& operator=(const PersistentCache&) = delete;
+    };
+
     class Options {
     public:
         // For testing purposes, completely disable the inliner. (Normally, Runtime Effects don't
         // run the inliner directly, but they still get an inlining pass once they are painted.)
         bool forceNoInline = false;
 
+        // If set, programs are loaded from and stored to this cache (see PersistentCache above).
+        // It is only used during the Make*() call, which doesn't take ownership. MakeBatch may use
+        // it from multiple threads at once. It does not affect the compiled effect.
+        PersistentCache* persistentCache = nullptr;
+
     private:
         friend class SkRuntimeEffect;
         friend class SkRuntimeEffectPriv;
@@ -163,6 +202,25 @@ public:
         return MakeForBlender(std::move(sksl), Options{});
     }
 
+    // A single effect to compile with MakeBatch: `make` is one of the SkString-based factories
+    // above (e.g. &SkRuntimeEffect::MakeForShader), which is called with `sksl` and `options`.
+    struct BatchRequest {
+        Result (*make)(SkString sksl, const Options&);
+        SkString sksl;
+        Options options;
+    };
+
+    /**
+     * Compiles a batch of effects (e.g. an application's effect library at startup) concurrently,
+     * on `executor`, or SkExecutor::GetDefault() if it is null. `callback` is invoked once for each
+     * request, with the request's index and its result. Callbacks may be invoked from any thread
+     * and in any order, but never at the same time. Returns once every request has completed. If the
+     * requests' options have a PersistentCache, it is also used from multiple threads.
+     */
+    static void MakeBatch(SkSpan<const BatchRequest> requests,
+                          const std::function<void(int index, Result)>& callback,
+                          SkExecutor* executor = nullptr);
+
     // DSL entry points
     static Result MakeForColorFilter(std::unique_ptr<SkSL::Program> program, const Options&);
     static Result MakeForColorFilter(std::unique_ptr<SkSL::Program> program);
@@ -279,6 +337,15 @@ private:
 
     static Result MakeFromSource(SkString sksl, const Options& options, SkSL::ProgramKind kind);
 
+    static sk_sp<SkData> MakePersistentCacheKey(const SkString& sksl,
+                                                const Options& options,
+                                                SkSL::ProgramKind kind);
+
+    static Result MakeFromPersistentData(sk_sp<SkData> data,
+                                         const SkString& sksl,
+                                         const Options& options,
+                                         SkSL::ProgramKind kind);
+
     static Result MakeFromDSL(std::unique_ptr<SkSL::Program> program,
                               const Options& options,
                               SkSL::ProgramKind kind);
@@ -319,6 +386,10 @@ private:
 
     uint32_t fHash;
 
+    // When the program was loaded from a PersistentCache, it refers to this serialized data, which
+    // must outlive it.
+    sk_sp<SkData> fPersistentData;
+
     std::unique_ptr<SkSL::Program> fBaseProgram;
     const SkSL::FunctionDefinition& fMain;
     std::vector<Uniform> fUniforms;
@@ -10,6 +10,7 @@
 
 #include "include/encode/SkEncoder.h"
 
+class SkExecutor;
 class SkJpegEncoderMgr;
 class SkWStream;
 
@@ -61,6 +62,18 @@ public:
          *  In the second case, the encoder supports linear or legacy blending.
          */
         AlphaOption fAlphaOption = AlphaOption::kIgnore;
+
+        /**
+         *  If not null, Encode() splits large images into strips of rows, which are color
+         *  converted and compressed in parallel on this executor, and then joined with restart
+         *  markers.  The strips share the standard Huffman tables, rather than computing optimal
+         *  ones for the image, so the output is typically a few percent larger.  It decodes to the
+         *  same pixels.
+         *
+         *  Images too small to split into several strips are encoded serially.  This is not used
+         *  by the encoder returned by Make().
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
@@ -11,6 +11,7 @@
 #include "include/core/SkDataTable.h"
 #include "include/encode/SkEncoder.h"
 
+class SkExecutor;
 class SkPngEncoderMgr;
 class SkWStream;
 
@@ -27,6 +28,21 @@ public:
         kAll   = kNone | kSub | kUp | kAvg | kPaeth,
     };
 
+    enum class FilterSelection {
+        /**
+         *  Every row tries each of the allowed filters, and uses the one that is likely to
+         *  compress best.  This matches libpng.
+         */
+        kPerRow,
+
+        /**
+         *  Each band of rows tries the allowed filters on its first few rows, and then uses the
+         *  best of them for the rest of the band.  This is much faster than kPerRow when several
+         *  filters are allowed, and usually compresses nearly as well.
+         */
+        kPerBand,
+    };
+
     struct Options {
         /**
          *  Selects which filtering strategies to use.
@@ -53,6 +69,25 @@ public:
          */
         int fZLibLevel = 6;
 
+        /**
+         *  If not null, Encode() splits the image into bands of rows, which are filtered and
+         *  compressed in parallel on this executor.  Each band is flushed to a byte boundary, so
+         *  the bands still join up into a single zlib stream, and the output is a valid png.
+         *  It is not byte-for-byte the same as the serial output, and may be slightly larger.
+         *  Only a few bands are encoded at a time, and each group is written to the stream before
+         *  the next one starts, so the memory used doesn't grow with the size of the image.
+         *
+         *  Images too small to split into several bands are encoded serially.  This is not used
+         *  by the encoder returned by Make().
+         */
+        SkExecutor* fExecutor = nullptr;
+
+        /**
+         *  How to choose between the allowed filters when the image is encoded in bands.  Serial
+         *  encodes always use kPerRow.
+         */
+        FilterSelection fFilterSelection = FilterSelection::kPerRow;
+
         /**
          *  Represents comments in the tEXt ancillary chunk of the png.
          *  The 2i-th entry is the keyword for the i-th comment,
@@ -10,6 +10,7 @@
 
 #include "include/encode/SkEncoder.h"
 
+class SkExecutor;
 class SkWStream;
 
 namespace SkWebpEncoder {
@@ -34,6 +35,13 @@ namespace SkWebpEncoder {
          */
         Compression fCompression = Compression::kLossy;
         float fQuality = 100.0f;
+
+        /**
+         *  If not null, pixels which need converting before they are compressed are converted
+         *  in parallel strips on this executor, and libwebp is allowed to use its own worker
+         *  threads (if it was built with them).  The output is unchanged.
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
@@ -11,6 +11,9 @@
 #include "include/private/SkTArray.h"
 #include "include/private/SkTDArray.h"
 
+#include <memory>
+
+class SkExecutor;
 class SkPath;
 struct SkRect;
 
@@ -45,6 +48,28 @@ enum SkPathOp {
   */
 bool SK_API Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result);
 
+/** Set the result to the union or the intersection of many paths at once.
+    Only kUnion_SkPathOp and kIntersect_SkPathOp are supported.
+
+    Rather than folding the paths into the result one at a time, as SkOpBuilder
+    does, paths are combined pairwise in a balanced tree. For a union, paths are
+    first split into clusters whose bounds touch (directly or through other
+    paths), and clusters are resolved independently, so each Op only involves
+    the paths that actually interact.
+
+    Returns true if operation was able to produce a result;
+    otherwise, result is unmodified.
+
+    @param paths The paths to combine.
+    @param count The number of paths.
+    @param op The operator to apply, either kUnion_SkPathOp or kIntersect_SkPathOp.
+    @param result The product of the paths. The result may be one of the inputs.
+    @param executor If not null, independent ops are run concurrently on it.
+    @return True if the operation succeeded.
+  */
+bool SK_API BatchOp(const SkPath paths[], int count, SkPathOp op, SkPath* result,
+                    SkExecutor* executor = nullptr);
+
 /** Set this path to a set of non-overlapping contours that describe the
     same area as the original path.
     The curve order is reduced where possible so that cubics may
@@ -110,4 +135,28 @@ private:
     void reset();
 };
 
+/** Performs the same operations as Op and Simplify, but keeps the memory used to compute them
+    from one call to the next, rather than allocating and freeing it each time. Use a context
+    when combining many paths, one pair at a time.
+
+    A context must not be used by more than one thread at a time.
+  */
+class SK_API SkOpContext {
+public:
+    SkOpContext();
+    ~SkOpContext();
+
+    /** Same as Op(one, two, op, result). */
+    bool op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result);
+
+    /** Same as Simplify(path, result). */
+    bool simplify(const SkPath& path, SkPath* result);
+
+private:
+    template <typename Fn> bool run(Fn&& fn);
+
+    std::unique_ptr<char[]> fStorage;
+    size_t fStorageSize;
+};
+
 #endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageDecodeScheduler_DEFINED
+#define SkImageDecodeScheduler_DEFINED
+
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTypes.h"
+
+#include <memory>
+
+class SkExecutor;
+class SkImage;
+class SkTaskGroup;
+
+/**
+ *  Decodes lazily generated images (e.g. from SkImage::MakeFromEncoded) ahead of the draws that
+ *  need them, so those draws find the pixels in the raster cache instead of decoding on the
+ *  calling thread. Decodes run on an SkExecutor, highest priority first.
+ *
+ *  All methods are thread safe.
+ */
+class SK_API SkImageDecodeScheduler {
+public:
+    /**
+     *  Decodes run on 'executor', which must outlive the scheduler. If it is null, they run on
+     *  SkExecutor::GetDefault(), which by default runs each decode inside enqueue().
+     */
+    explicit SkImageDecodeScheduler(SkExecutor* executor = nullptr);
+
+    /**
+     *  Drops the decodes that have not started yet, and waits for the running ones to finish.
+     */
+    ~SkImageDecodeScheduler();
+
+    /**
+     *  Queues a decode of 'image' for drawing at 'scale' (device pixels per image pixel). Higher
+     *  priorities are decoded first, and equal priorities in the order they were enqueued.
+     *  Enqueuing an image that is still queued updates its priority and scale.
+     *
+     *  When 'scale' is less than 1 and the image's encoding can be decoded at a reduced size
+     *  (e.g. JPEG), the smallest such size covering 'scale' is decoded instead. Raster draws that
+     *  need no more resolution than that use it in place of the full image, as long as the full
+     *  image has not been decoded too.
+     *
+     *  Images that are not lazily generated are ignored.
+     */
+    void enqueue(sk_sp<SkImage> image, int priority, float scale = 1);
+
+    /**
+     *  Removes 'image' from the queue. Returns false if it was not queued, e.g. because its
+     *  decode has already started.
+     */
+    bool cancel(const SkImage* image);
+
+    /**
+     *  Blocks until all queued decodes have finished.
+     */
+    void waitForAll();
+
+    /**
+     *  Returns true if the raster cache currently holds a decode of 'image' that draws at 'scale'
+     *  can use, or if the image is not lazily generated. Clients that would rather not block a
+     *  draw on decoding can draw a placeholder until this returns true.
+     */
+    static bool IsDecoded(const SkImage* image, float scale = 1);
+
+private:
+    struct Request;
+    class Queue;
+
+    void decodeNext();
+
+    std::unique_ptr<Queue>       fQueue;
+    std::unique_ptr<SkTaskGroup> fTasks;
+};
+
+#endif
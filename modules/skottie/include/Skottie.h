@@ -95,6 +95,9 @@ public:
                                          // frames are only resolved when needed, at seek() time.
             kPreferEmbeddedFonts = 0x02, // Attempt to use the embedded fonts (glyph paths,
                                          // normally used as fallback) over native Skia typefaces.
+            kCacheLayerEffects   = 0x04, // Cache the rasterized output of layer effects (blurs,
+                                         // shadows, etc) while their content is unchanged
+                                         // (see sksg::LayerCacheEffect).
         };
 
         explicit Builder(uint32_t flags = 0);
@@ -157,6 +160,9 @@ public:
 
         /**
          * Animation factories.
+         *
+         * In addition to Lottie JSON, these accept the precompiled binary form produced by
+         * skottie_binary_tool (detected automatically), which loads without JSON parsing.
          */
         sk_sp<Animation> make(SkStream*);
         sk_sp<Animation> make(const char* data, size_t length);
@@ -15,6 +15,7 @@
 #include "modules/sksg/include/SkSGClipEffect.h"
 #include "modules/sksg/include/SkSGDraw.h"
 #include "modules/sksg/include/SkSGGroup.h"
+#include "modules/sksg/include/SkSGLayerCacheEffect.h"
 #include "modules/sksg/include/SkSGMaskEffect.h"
 #include "modules/sksg/include/SkSGMerge.h"
 #include "modules/sksg/include/SkSGPaint.h"
@@ -491,6 +492,10 @@ sk_sp<sksg::RenderNode> LayerBuilder::buildRenderTree(const AnimationBuilder& ab
     if (const skjson::ArrayValue* jeffects = fJlayer["ef"]) {
         layer = EffectBuilder(&abuilder, fInfo.fSize, cbuilder)
                 .attachEffects(*jeffects, std::move(layer));
+
+        if (abuilder.fFlags & Animation::Builder::kCacheLayerEffects) {
+            layer = sksg::LayerCacheEffect::Make(std::move(layer));
+        }
     }
 
     // Attach the transform after effects, when needed.
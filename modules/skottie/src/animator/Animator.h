@@ -25,6 +25,7 @@ namespace internal {
 
 class AnimationBuilder;
 class AnimatorBuilder;
+class ScalarKeyframeBatch;
 
 class Animator : public SkRefCnt {
 public:
@@ -75,6 +76,7 @@ private:
     bool bindImpl(const AnimationBuilder&, const skjson::ObjectValue*, AnimatorBuilder&);
 
     std::vector<sk_sp<Animator>> fAnimators;
+    ScalarKeyframeBatch*         fScalarBatch = nullptr; // owned by fAnimators, when present
     bool                         fHasSynced = false;
 };
 
@@ -9,6 +9,8 @@
 
 #include "modules/skottie/src/SkottieJson.h"
 
+#include <cmath>
+
 #define DUMP_KF_RECORDS 0
 
 namespace skottie::internal {
@@ -27,24 +29,67 @@ KeyframeAnimator::LERPInfo KeyframeAnimator::getLERPInfo(float t) const {
         return { 0, fKFs.back().v, fKFs.back().v };
     }
 
-    // Cache the current segment (most queries have good locality).
-    if (!fCurrentSegment.contains(t)) {
-        fCurrentSegment = this->find_segment(t);
-    }
-    SkASSERT(fCurrentSegment.contains(t));
+    const auto& seg = this->update_segment(t);
 
-    if (fCurrentSegment.kf0->mapping == Keyframe::kConstantMapping) {
+    if (seg.kf0->mapping == Keyframe::kConstantMapping) {
         // Constant/hold segment.
-        return { 0, fCurrentSegment.kf0->v, fCurrentSegment.kf0->v };
+        return { 0, seg.kf0->v, seg.kf0->v };
+    }
+
+    return {
+        this->compute_weight(seg, t),
+        seg.kf0->v,
+        seg.kf1->v,
+    };
+}
+
+KeyframeAnimator::SegmentInfo KeyframeAnimator::getSegmentInfo(float t) const {
+    SkASSERT(!fKFs.empty());
+
+    static constexpr float kInf = SK_FloatInfinity;
+
+    if (t <= fKFs.front().t) {
+        // Constant/clamped segment (inclusive of front().t).
+        return { -kInf, std::nextafter(fKFs.front().t, kInf),
+                 fKFs.front().v, fKFs.front().v, Keyframe::kConstantMapping, nullptr };
+    }
+    if (t >= fKFs.back().t) {
+        // Constant/clamped segment.
+        return { fKFs.back().t, kInf,
+                 fKFs.back().v, fKFs.back().v, Keyframe::kConstantMapping, nullptr };
     }
 
+    const auto& seg = this->update_segment(t);
+    const auto mapping = seg.kf0->mapping;
+
     return {
-        this->compute_weight(fCurrentSegment, t),
-        fCurrentSegment.kf0->v,
-        fCurrentSegment.kf1->v,
+        seg.kf0->t,
+        seg.kf1->t,
+        seg.kf0->v,
+        mapping == Keyframe::kConstantMapping ? seg.kf0->v : seg.kf1->v,
+        mapping,
+        mapping >= Keyframe::kCubicIndexOffset
+            ? &fCMs[SkToSizeT(mapping - Keyframe::kCubicIndexOffset)]
+            : nullptr,
     };
 }
 
+const KeyframeAnimator::KFSegment& KeyframeAnimator::update_segment(float t) const {
+    // Cache the current segment (most queries have good locality).
+    if (!fCurrentSegment.contains(t)) {
+        // Sequential seeks are the common case: try the next segment before searching.
+        if (fCurrentSegment.kf1 && fCurrentSegment.kf1 != &fKFs.back()) {
+            const KFSegment next = { fCurrentSegment.kf1, fCurrentSegment.kf1 + 1 };
+            fCurrentSegment = next.contains(t) ? next : this->find_segment(t);
+        } else {
+            fCurrentSegment = this->find_segment(t);
+        }
+    }
+    SkASSERT(fCurrentSegment.contains(t));
+
+    return fCurrentSegment;
+}
+
 KeyframeAnimator::KFSegment KeyframeAnimator::find_segment(float t) const {
     SkASSERT(fKFs.size() > 1);
     SkASSERT(t > fKFs.front().t);
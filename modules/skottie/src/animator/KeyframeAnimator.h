@@ -83,6 +83,17 @@ protected:
     // Main entry point: |t| -> LERPInfo
     LERPInfo getLERPInfo(float t) const;
 
+    // Segment-level flavor of the above, for batched evaluation: the returned values and
+    // mapping apply to all t in [t0 .. t1).
+    struct SegmentInfo {
+        float             t0, t1;
+        Keyframe::Value   vrec0, vrec1;
+        uint32_t          mapping;
+        const SkCubicMap* cubic_mapper; // non-null for cubic mappings
+    };
+
+    SegmentInfo getSegmentInfo(float t) const;
+
 private:
     // Two sequential KFRecs determine how the value varies within [kf0 .. kf1)
     struct KFSegment {
@@ -100,6 +111,9 @@ private:
     // Find the KFSegment containing |t|.
     KFSegment find_segment(float t) const;
 
+    // Update the cached segment to contain |t| (front.t < t < back.t).
+    const KFSegment& update_segment(float t) const;
+
     // Given a |t| and a containing KFSegment, compute the local interpolation weight.
     float compute_weight(const KFSegment& seg, float t) const;
 
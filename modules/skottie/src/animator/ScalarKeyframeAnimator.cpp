@@ -5,11 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "include/private/SkVx.h"
 #include "modules/skottie/src/SkottieJson.h"
 #include "modules/skottie/src/SkottieValue.h"
 #include "modules/skottie/src/animator/Animator.h"
 #include "modules/skottie/src/animator/KeyframeAnimator.h"
 
+#include <algorithm>
+
 namespace skottie::internal {
 
 namespace  {
@@ -24,6 +27,7 @@ public:
         , fTarget(target_value) {}
 
 private:
+    friend class skottie::internal::ScalarKeyframeBatch;
 
     StateChanged onSeek(float t) override {
         const auto& lerp_info = this->getLERPInfo(t);
@@ -74,8 +78,14 @@ class ScalarAnimatorBuilder final : public AnimatorBuilder {
                 return nullptr;
             }
 
-            return sk_sp<ScalarKeyframeAnimator>(
+            fKeyframeAnimator = sk_sp<ScalarKeyframeAnimator>(
                         new ScalarKeyframeAnimator(std::move(fKFs), std::move(fCMs), fTarget));
+
+            return fKeyframeAnimator;
+        }
+
+        const sk_sp<ScalarKeyframeAnimator>& keyframeAnimator() const {
+            return fKeyframeAnimator;
         }
 
         sk_sp<Animator> makeFromExpression(ExpressionManager& em, const char* expr) override {
@@ -97,20 +107,144 @@ class ScalarAnimatorBuilder final : public AnimatorBuilder {
             return Parse(jv, &v->flt);
         }
 
-        ScalarValue* fTarget;
+        ScalarValue*                  fTarget;
+        sk_sp<ScalarKeyframeAnimator> fKeyframeAnimator;
 
         using INHERITED = AnimatorBuilder;
     };
 
 } // namespace
 
+// Evaluates all keyframed scalar properties bound to a container in lockstep, using a
+// structure-of-arrays segment cache:
+//
+//   - segments are only refreshed (scalar path) when |t| leaves the cached [t0 .. t1) interval
+//   - linear weights and interpolation are computed four properties at a time
+//   - cubic easing is applied per property (SkCubicMap)
+//
+// This avoids per-property virtual dispatch and keyframe lookups for the common case of
+// sequential seeks.
+class ScalarKeyframeBatch final : public Animator {
+public:
+    void add(sk_sp<ScalarKeyframeAnimator> animator) {
+        const auto lane = fAnimators.size();
+        fAnimators.push_back(std::move(animator));
+
+        // Padding lanes are never stale and always evaluate to 0.
+        const auto lane_count = SkAlign4(fAnimators.size());
+        fT0    .resize(lane_count, -SK_FloatInfinity);
+        fT1    .resize(lane_count,  SK_FloatInfinity);
+        fOrigin.resize(lane_count, 0);
+        fScale .resize(lane_count, 0);
+        fV0    .resize(lane_count, 0);
+        fV1    .resize(lane_count, 0);
+        fW     .resize(lane_count, 0);
+        fMappers.resize(fAnimators.size(), nullptr);
+
+        // An empty interval forces a refresh on first seek.
+        fT0[lane] =  SK_FloatInfinity;
+        fT1[lane] = -SK_FloatInfinity;
+    }
+
+private:
+    using F4 = skvx::Vec<4, float>;
+
+    StateChanged onSeek(float t) override {
+        const auto count = fAnimators.size();
+        const F4 t4(t);
+
+        // Refresh stale segments.
+        for (size_t i = 0; i < count; i += 4) {
+            const auto stale = (t4 < F4::Load(fT0.data() + i)) | (t4 >= F4::Load(fT1.data() + i));
+            if (skvx::any(stale)) {
+                for (size_t j = i; j < std::min(i + 4, count); ++j) {
+                    if (t < fT0[j] || t >= fT1[j]) {
+                        this->refreshSegment(j, t);
+                    }
+                }
+            }
+        }
+
+        // Linear weights.
+        for (size_t i = 0; i < count; i += 4) {
+            const auto w = (t4 - F4::Load(fOrigin.data() + i)) * F4::Load(fScale.data() + i);
+            w.store(fW.data() + i);
+        }
+
+        // Optional cubic easing.
+        for (size_t i = 0; i < count; ++i) {
+            if (fMappers[i]) {
+                fW[i] = fMappers[i]->computeYFromX(fW[i]);
+            }
+        }
+
+        // Interpolation.
+        for (size_t i = 0; i < count; i += 4) {
+            const auto v0 = F4::Load(fV0.data() + i),
+                       v1 = F4::Load(fV1.data() + i),
+                        w = F4::Load(fW.data() + i);
+            (v0 + (v1 - v0) * w).store(fW.data() + i);
+        }
+
+        bool changed = false;
+        for (size_t i = 0; i < count; ++i) {
+            auto* target = fAnimators[i]->fTarget;
+
+            changed |= (*target != fW[i]);
+            *target = fW[i];
+        }
+
+        return changed;
+    }
+
+    void refreshSegment(size_t i, float t) {
+        const auto seg = fAnimators[i]->getSegmentInfo(t);
+        const auto is_constant = seg.mapping == Keyframe::kConstantMapping;
+
+        fT0[i]      = seg.t0;
+        fT1[i]      = seg.t1;
+        fOrigin[i]  = is_constant ? 0 : seg.t0;
+        fScale[i]   = is_constant ? 0 : 1 / (seg.t1 - seg.t0);
+        fV0[i]      = seg.vrec0.flt;
+        fV1[i]      = seg.vrec1.flt;
+        fMappers[i] = seg.cubic_mapper;
+    }
+
+    std::vector<sk_sp<ScalarKeyframeAnimator>> fAnimators;
+
+    // Per-property segment cache (SoA, padded to a multiple of 4).
+    std::vector<float>             fT0, fT1,       // segment validity interval [t0 .. t1)
+                                   fOrigin, fScale,// linear weight: (t - origin) * scale
+                                   fV0, fV1,       // segment values
+                                   fW;             // scratch weights/results
+    std::vector<const SkCubicMap*> fMappers;
+};
+
 template <>
 bool AnimatablePropertyContainer::bind<ScalarValue>(const AnimationBuilder& abuilder,
                                                     const skjson::ObjectValue* jprop,
                                                     ScalarValue* v) {
     ScalarAnimatorBuilder builder(v);
 
-    return this->bindImpl(abuilder, jprop, builder);
+    const auto animator_count = fAnimators.size();
+    if (!this->bindImpl(abuilder, jprop, builder)) {
+        return false;
+    }
+
+    // Keyframed scalar properties are consolidated into a per-container batch animator.
+    const auto& kf_animator = builder.keyframeAnimator();
+    if (fAnimators.size() > animator_count && kf_animator && fAnimators.back() == kf_animator) {
+        if (!fScalarBatch) {
+            auto batch = sk_make_sp<ScalarKeyframeBatch>();
+            fScalarBatch = batch.get();
+            fAnimators.back() = std::move(batch);
+        } else {
+            fAnimators.pop_back();
+        }
+        fScalarBatch->add(kf_animator);
+    }
+
+    return true;
 }
 
 } // namespace skottie::internal
@@ -5,6 +5,8 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkCubicMap.h"
+#include "include/private/SkTPin.h"
 #include "modules/skottie/include/ExternalLayer.h"
 #include "modules/skottie/src/SkottiePriv.h"
 #include "modules/skottie/src/SkottieValue.h"
@@ -168,3 +170,76 @@ DEF_TEST(Skottie_Keyframe, reporter) {
         REPORTER_ASSERT(reporter, SkScalarNearlyEqual(prop(0).y, 2));
     }
 }
+
+namespace {
+
+// Binds multiple scalar properties to the same container (batched evaluation).
+class MockScalarProperties final : public AnimatablePropertyContainer {
+public:
+    explicit MockScalarProperties(size_t count) : fValues(count) {
+        AnimationBuilder abuilder(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                  nullptr, {100, 100}, 10, 1, 0);
+
+        for (size_t i = 0; i < count; ++i) {
+            // [i .. i + 10] over t: [0 .. 10], then [i + 10 .. i] over t: [10 .. 20],
+            // with the first segment eased for odd properties.
+            static constexpr char kEased[] = R"(, "o": {"x": [0.5], "y": [0]},)"
+                                             R"( "i": {"x": [0.5], "y": [1]})";
+            const auto jprop = SkStringPrintf(R"({
+                                                "a": 1,
+                                                "k": [
+                                                  { "t":  0, "s": %zu %s },
+                                                  { "t": 10, "s": %zu },
+                                                  { "t": 20, "s": %zu }
+                                                ]
+                                              })",
+                                              i, i & 1 ? kEased : "",
+                                              i + 10, i);
+            skjson::DOM json_dom(jprop.c_str(), jprop.size());
+
+            fDidBind &= this->bind(abuilder, json_dom.root(), &fValues[i]);
+        }
+    }
+
+    explicit operator bool() const { return fDidBind; }
+
+    const std::vector<ScalarValue>& operator()(float t) { this->seek(t); return fValues; }
+
+private:
+    void onSync() override {}
+
+    std::vector<ScalarValue> fValues;
+    bool                     fDidBind = true;
+};
+
+}  // namespace
+
+DEF_TEST(Skottie_Keyframe_Batch, reporter) {
+    static constexpr size_t kCount = 7;
+
+    MockScalarProperties props(kCount);
+    REPORTER_ASSERT(reporter, props);
+
+    auto expected = [](size_t i, float t) {
+        t = SkTPin(t, 0.0f, 20.0f);
+        if (t > 10) {
+            return i + (20 - t);
+        }
+        return i + 10 * (i & 1 ? SkCubicMap({0.5f, 0}, {0.5f, 1}).computeYFromX(t / 10)
+                               : t / 10);
+    };
+
+    // Forward, backward and random access seeks.
+    static constexpr float gTimes[] = {
+        -1, 0, 0.5f, 1, 2.5f, 5, 9.9f, 10, 10.1f, 15, 19.9f, 20, 21,
+        19, 11, 10, 9, 0, -5, 13, 2, 20, 7.5f, 0,
+    };
+
+    for (const auto t : gTimes) {
+        const auto& values = props(t);
+        for (size_t i = 0; i < kCount; ++i) {
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(values[i], expected(i, t)),
+                            "prop %zu @ %f: %f (expected %f)", i, t, values[i], expected(i, t));
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2022 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
+#include "modules/skottie/include/Skottie.h"
+#include "src/core/SkOSFile.h"
+#include "src/utils/SkJSON.h"
+#include "src/utils/SkOSPath.h"
+#include "tools/flags/CommandLineFlags.h"
+
+// Converts Lottie .json files to the compact binary DOM encoding (see skjson::DOM::writeBinary),
+// which skottie::Animation::Builder loads without JSON parsing.
+
+static DEFINE_string2(input , i, nullptr, "Input .json file, or directory of .json files.");
+static DEFINE_string2(output, o, nullptr, "Output file (single input) or directory.");
+static DEFINE_bool(verify, true, "Check that the converted animation loads successfully.");
+
+namespace {
+
+bool Convert(const SkString& input, const SkString& output) {
+    const auto data = SkData::MakeFromFileName(input.c_str());
+    if (!data) {
+        SkDebugf("Could not load %s.\n", input.c_str());
+        return false;
+    }
+
+    const skjson::DOM dom(static_cast<const char*>(data->data()), data->size());
+    if (!dom.root().is<skjson::ObjectValue>()) {
+        SkDebugf("Failed to parse JSON input: %s.\n", input.c_str());
+        return false;
+    }
+
+    SkDynamicMemoryWStream buf;
+    dom.writeBinary(&buf);
+    const auto bin = buf.detachAsData();
+
+    if (FLAGS_verify) {
+        skottie::Animation::Builder builder;
+        if (!builder.make(static_cast<const char*>(bin->data()), bin->size())) {
+            SkDebugf("Converted animation failed to load: %s.\n", input.c_str());
+            return false;
+        }
+    }
+
+    SkFILEWStream out(output.c_str());
+    if (!out.isValid() || !out.write(bin->data(), bin->size())) {
+        SkDebugf("Could not write %s.\n", output.c_str());
+        return false;
+    }
+
+    SkDebugf("%s: %zu -> %zu bytes.\n", input.c_str(), data->size(), bin->size());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CommandLineFlags::Parse(argc, argv);
+
+    if (FLAGS_input.isEmpty() || FLAGS_output.isEmpty()) {
+        SkDebugf("Missing required 'input' and 'output' args.\n");
+        return 1;
+    }
+
+    if (!sk_isdir(FLAGS_input[0])) {
+        return Convert(SkString(FLAGS_input[0]), SkString(FLAGS_output[0])) ? 0 : 1;
+    }
+
+    if (!sk_mkdir(FLAGS_output[0])) {
+        return 1;
+    }
+
+    int failures = 0;
+    SkOSFile::Iter iter(FLAGS_input[0], "json");
+    for (SkString file; iter.next(&file); ) {
+        SkString out_name = SkOSPath::Basename(file.c_str());
+        out_name.resize(out_name.size() - strlen("json"));
+        out_name.append("lottiebin");
+
+        if (!Convert(SkOSPath::Join(FLAGS_input[0] , file.c_str()),
+                     SkOSPath::Join(FLAGS_output[0], out_name.c_str()))) {
+            failures++;
+        }
+    }
+
+    return failures ? 1 : 0;
+}
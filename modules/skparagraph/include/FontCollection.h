@@ -6,6 +6,7 @@
 #include <set>
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkRefCnt.h"
+#include "include/private/SkMutex.h"
 #include "include/private/SkTHash.h"
 #include "modules/skparagraph/include/ParagraphCache.h"
 #include "modules/skparagraph/include/TextStyle.h"
@@ -15,6 +16,10 @@ namespace textlayout {
 
 class TextStyle;
 class Paragraph;
+
+// Font lookups and the paragraph cache are safe to use from multiple threads (e.g. when laying
+// out paragraphs with Paragraph::LayoutAll), but the font managers and the fallback settings
+// should only be changed while no layout is in progress.
 class FontCollection : public SkRefCnt {
 public:
     FontCollection();
@@ -65,7 +70,10 @@ private:
     };
 
     bool fEnableFontFallback;
-    SkTHashMap<FamilyKey, std::vector<sk_sp<SkTypeface>>, FamilyKey::Hasher> fTypefaces;
+
+    SkMutex fTypefacesMutex;
+    SkTHashMap<FamilyKey, std::vector<sk_sp<SkTypeface>>, FamilyKey::Hasher> fTypefaces
+            SK_GUARDED_BY(fTypefacesMutex);
     sk_sp<SkFontMgr> fDefaultFontManager;
     sk_sp<SkFontMgr> fAssetFontManager;
     sk_sp<SkFontMgr> fDynamicFontManager;
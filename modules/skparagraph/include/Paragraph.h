@@ -2,12 +2,14 @@
 #ifndef Paragraph_DEFINED
 #define Paragraph_DEFINED
 
+#include "include/core/SkSpan.h"
 #include "modules/skparagraph/include/FontCollection.h"
 #include "modules/skparagraph/include/Metrics.h"
 #include "modules/skparagraph/include/ParagraphStyle.h"
 #include "modules/skparagraph/include/TextStyle.h"
 
 class SkCanvas;
+class SkExecutor;
 
 namespace skia {
 namespace textlayout {
@@ -37,6 +39,12 @@ public:
 
     virtual void layout(SkScalar width) = 0;
 
+    // Lays out a batch of paragraphs concurrently on the given executor, and returns once all of
+    // them are done.  The paragraphs may share a FontCollection, but must otherwise be
+    // independent (each paragraph appears at most once, and is not accessed by the caller
+    // until the call returns).
+    static void LayoutAll(SkSpan<Paragraph* const> paragraphs, SkScalar width, SkExecutor&);
+
     virtual void paint(SkCanvas* canvas, SkScalar x, SkScalar y) = 0;
 
     // Returns a vector of bounding boxes that enclose all text between
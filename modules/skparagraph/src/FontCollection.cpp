@@ -77,11 +77,16 @@ std::vector<sk_sp<SkFontMgr>> FontCollection::getFontManagerOrder() const {
 std::vector<sk_sp<SkTypeface>> FontCollection::findTypefaces(const std::vector<SkString>& familyNames, SkFontStyle fontStyle) {
     // Look inside the font collections cache first
     FamilyKey familyKey(familyNames, fontStyle);
-    auto found = fTypefaces.find(familyKey);
-    if (found) {
-        return *found;
+    {
+        SkAutoMutexExclusive lock(fTypefacesMutex);
+        if (auto found = fTypefaces.find(familyKey)) {
+            return *found;
+        }
     }
 
+    // The font managers are queried without holding the lock: concurrent misses for the same
+    // key resolve to the same typefaces, so the last one to finish simply wins.
+
     std::vector<sk_sp<SkTypeface>> typefaces;
     for (const SkString& familyName : familyNames) {
         sk_sp<SkTypeface> match = matchTypeface(familyName, fontStyle);
@@ -111,6 +116,7 @@ std::vector<sk_sp<SkTypeface>> FontCollection::findTypefaces(const std::vector<S
         }
     }
 
+    SkAutoMutexExclusive lock(fTypefacesMutex);
     fTypefaces.set(familyKey, typefaces);
     return typefaces;
 }
@@ -168,7 +174,10 @@ void FontCollection::enableFontFallback() { fEnableFontFallback = true; }
 
 void FontCollection::clearCaches() {
     fParagraphCache.reset();
-    fTypefaces.reset();
+    {
+        SkAutoMutexExclusive lock(fTypefacesMutex);
+        fTypefaces.reset();
+    }
     SkShaper::PurgeCaches();
 }
 
@@ -279,10 +279,10 @@ bool ParagraphCache::findParagraph(ParagraphImpl* paragraph) {
     if (!fCacheIsOn) {
         return false;
     }
+    SkAutoMutexExclusive lock(fParagraphMutex);
 #ifdef PARAGRAPH_CACHE_STATS
     ++fTotalRequests;
 #endif
-    SkAutoMutexExclusive lock(fParagraphMutex);
     ParagraphCacheKey key(paragraph);
     std::unique_ptr<Entry>* entry = fLRUCacheMap.find(key);
 
@@ -303,10 +303,10 @@ bool ParagraphCache::updateParagraph(ParagraphImpl* paragraph) {
     if (!fCacheIsOn) {
         return false;
     }
+    SkAutoMutexExclusive lock(fParagraphMutex);
 #ifdef PARAGRAPH_CACHE_STATS
     ++fTotalRequests;
 #endif
-    SkAutoMutexExclusive lock(fParagraphMutex);
 
     ParagraphCacheKey key(paragraph);
     std::unique_ptr<Entry>* entry = fLRUCacheMap.find(key);
@@ -17,6 +17,7 @@
 #include "modules/skparagraph/src/Run.h"
 #include "modules/skparagraph/src/TextLine.h"
 #include "modules/skparagraph/src/TextWrapper.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/utils/SkUTF.h"
 #include <math.h>
 #include <algorithm>
@@ -61,6 +62,17 @@ Paragraph::Paragraph(ParagraphStyle style, sk_sp<FontCollection> fonts)
             , fExceededMaxLines(0)
 { }
 
+void Paragraph::LayoutAll(SkSpan<Paragraph* const> paragraphs, SkScalar width,
+                          SkExecutor& executor) {
+    // Shaping dominates the cost of layout and is independent per paragraph; the shared state
+    // (font collection, paragraph cache, shaper caches) is internally synchronized.
+    SkTaskGroup tasks(executor);
+    tasks.batch(SkToInt(paragraphs.size()), [paragraphs, width](int i) {
+        paragraphs[i]->layout(width);
+    });
+    tasks.wait();
+}
+
 ParagraphImpl::ParagraphImpl(const SkString& text,
                              ParagraphStyle style,
                              SkTArray<Block, true> blocks,
@@ -3,6 +3,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkImageEncoder.h"
@@ -6746,3 +6747,70 @@ UNIX_ONLY_TEST(SkParagraph_SimpleParagraphReset, reporter) {
         }
     }
 }
+
+UNIX_ONLY_TEST(SkParagraph_LayoutAll, reporter) {
+    ParagraphStyle paragraph_style;
+    paragraph_style.turnHintingOff();
+
+    TextStyle text_style;
+    text_style.setFontFamilies({SkString("Roboto")});
+    text_style.setFontSize(20);
+    text_style.setColor(SK_ColorBLACK);
+
+    auto make_paragraph = [&](int i, sk_sp<FontCollection> fontCollection) {
+        ParagraphBuilderImpl builder(paragraph_style, std::move(fontCollection));
+        builder.pushStyle(text_style);
+        for (int j = 0; j <= i % 7; ++j) {
+            SkString text = SkStringPrintf("Paragraph %d sentence %d goes on and on. ", i, j);
+            builder.addText(text.c_str(), text.size());
+        }
+        builder.pop();
+        return builder.Build();
+    };
+
+    static constexpr int kCount = 64;
+    static constexpr int kDistinct = 16;  // each paragraph is laid out kCount / kDistinct times
+    static constexpr SkScalar kWidth = 300;
+
+    // Reference layouts, one at a time and without the paragraph cache.
+    sk_sp<ResourceFontCollection> serialCollection = sk_make_sp<ResourceFontCollection>();
+    if (!serialCollection->fontsFound()) return;
+    serialCollection->getParagraphCache()->turnOn(false);
+
+    std::vector<std::unique_ptr<Paragraph>> expected;
+    for (int i = 0; i < kDistinct; ++i) {
+        expected.push_back(make_paragraph(i, serialCollection));
+        expected.back()->layout(kWidth);
+    }
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // With the cache on, concurrent layouts of the same text look up and fill the same entries.
+    for (bool useCache : {false, true}) {
+        sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+        fontCollection->getParagraphCache()->turnOn(useCache);
+
+        std::vector<std::unique_ptr<Paragraph>> actual;
+        std::vector<Paragraph*> batch;
+        for (int i = 0; i < kCount; ++i) {
+            actual.push_back(make_paragraph(i % kDistinct, fontCollection));
+            batch.push_back(actual.back().get());
+        }
+
+        Paragraph::LayoutAll(SkMakeSpan(batch), kWidth, *executor);
+
+        for (int i = 0; i < kCount; ++i) {
+            const auto& want = expected[i % kDistinct];
+            REPORTER_ASSERT(reporter, actual[i]->lineNumber() == want->lineNumber(),
+                            "cache %d", useCache);
+            REPORTER_ASSERT(reporter, actual[i]->getHeight() == want->getHeight(),
+                            "cache %d", useCache);
+            REPORTER_ASSERT(reporter, actual[i]->getLongestLine() == want->getLongestLine(),
+                            "cache %d", useCache);
+            REPORTER_ASSERT(reporter, actual[i]->unresolvedGlyphs() == 0, "cache %d", useCache);
+        }
+        if (useCache) {
+            REPORTER_ASSERT(reporter, fontCollection->getParagraphCache()->count() > 0);
+        }
+    }
+}
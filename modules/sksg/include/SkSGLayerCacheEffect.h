@@ -0,0 +1,60 @@
+/*
+ * Copyright 2022 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSGLayerCacheEffect_DEFINED
+#define SkSGLayerCacheEffect_DEFINED
+
+#include "modules/sksg/include/SkSGEffectNode.h"
+
+#include "include/core/SkMatrix.h"
+
+namespace sksg {
+
+/**
+ * Opt-in raster cache for expensive sub-DAGs (image filters, masks, etc).
+ *
+ * Once its content has been stable (not invalidated) for a few renders, the node snapshots the
+ * visible part of the sub-DAG to an image at device scale, and reuses it for as long as the
+ * content and the scale/skew components of the CTM remain unchanged.  Translation and paint
+ * overrides (opacity, color filters, blend modes) are applied when drawing the cached image.
+ * Snapshots are rendered at the subpixel phase of the translation (in quarter pixel steps), so
+ * they are drawn without resampling.  Changing the scale/skew restarts the stability count.
+ *
+ * The content is always rendered in isolation (as a layer), whether cached or not.
+ *
+ * Cached images are stored in the global SkResourceCache, and are subject to its budget.
+ * Caching is only performed for raster canvases, and is bypassed for perspective CTMs.
+ */
+class LayerCacheEffect final : public EffectNode {
+public:
+    static sk_sp<LayerCacheEffect> Make(sk_sp<RenderNode> child) {
+        return child ? sk_sp<LayerCacheEffect>(new LayerCacheEffect(std::move(child))) : nullptr;
+    }
+
+    ~LayerCacheEffect() override;
+
+protected:
+    void onRender(SkCanvas*, const RenderContext*) const override;
+
+    SkRect onRevalidate(InvalidationController*, const SkMatrix&) override;
+
+private:
+    explicit LayerCacheEffect(sk_sp<RenderNode>);
+
+    bool renderCached(SkCanvas*, const RenderContext*) const;
+
+    const uint32_t   fUniqueID;
+    uint32_t         fContentID     = 0;  // bumped on content invalidation
+    mutable uint32_t fStableRenders = 0;  // renders since the last content or scale change
+    mutable SkMatrix fSnapshotMatrix = SkMatrix::I();  // CTM scale/skew of the last render
+
+    using INHERITED = EffectNode;
+};
+
+} // namespace sksg
+
+#endif // SkSGLayerCacheEffect_DEFINED
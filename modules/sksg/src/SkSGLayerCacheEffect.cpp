@@ -0,0 +1,233 @@
+/*
+ * Copyright 2022 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "modules/sksg/include/SkSGLayerCacheEffect.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkSurface.h"
+#include "include/private/SkTo.h"
+#include "src/core/SkResourceCache.h"
+
+#include <atomic>
+
+namespace sksg {
+
+namespace {
+
+// Content must be stable for this many renders before we bother caching.
+static constexpr uint32_t kMinStableRenders = 2;
+
+// Don't cache huge layers (single dimension, in device pixels).
+static constexpr int kMaxCacheDimension = 4096;
+
+// Snapshots are rendered at the subpixel phase of the CTM translation, quantized to this many
+// steps per pixel (same as subpixel glyph positioning).
+static constexpr int kSubpixelSteps = 4;
+
+static unsigned gLayerCacheKeyNamespaceLabel;
+
+uint64_t make_shared_id(uint32_t unique_id) {
+    return (static_cast<uint64_t>(SkSetFourByteTag('s', 'k', 's', 'g')) << 32) | unique_id;
+}
+
+struct LayerCacheKey : public SkResourceCache::Key {
+    LayerCacheKey(uint32_t unique_id, uint32_t content_id, const SkMatrix& m,
+                  const SkIPoint& phase)
+        : fContentID(content_id)
+        , fScaleX(m.getScaleX())
+        , fSkewX (m.getSkewX())
+        , fSkewY (m.getSkewY())
+        , fScaleY(m.getScaleY())
+        , fPhaseX(SkToU16(phase.x()))
+        , fPhaseY(SkToU16(phase.y())) {
+        this->init(&gLayerCacheKeyNamespaceLabel, make_shared_id(unique_id),
+                   sizeof(fContentID) + 4 * sizeof(float) + 2 * sizeof(uint16_t));
+    }
+
+    uint32_t fContentID;
+    float    fScaleX,
+             fSkewX,
+             fSkewY,
+             fScaleY;
+    uint16_t fPhaseX,  // subpixel translation, in 1/kSubpixelSteps pixel units
+             fPhaseY;
+};
+
+struct LayerCacheRec : public SkResourceCache::Rec {
+    LayerCacheRec(const LayerCacheKey& key, sk_sp<SkImage> image, const SkIPoint& origin)
+        : fKey(key)
+        , fImage(std::move(image))
+        , fOrigin(origin) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fImage->imageInfo().computeMinByteSize();
+    }
+    const char* getCategory() const override { return "sksg-layer-cache"; }
+
+    struct Result {
+        sk_sp<SkImage> fImage;
+        SkIPoint       fOrigin;
+    };
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* context) {
+        const auto& rec = static_cast<const LayerCacheRec&>(baseRec);
+        auto* result = static_cast<Result*>(context);
+
+        result->fImage  = rec.fImage;
+        result->fOrigin = rec.fOrigin;
+        return true;
+    }
+
+    LayerCacheKey  fKey;
+    sk_sp<SkImage> fImage;
+    SkIPoint       fOrigin;  // device space offset of the image, relative to the integral
+                             // part of the CTM translation
+};
+
+uint32_t next_unique_id() {
+    static std::atomic<uint32_t> gNextID{1};
+    return gNextID.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+LayerCacheEffect::LayerCacheEffect(sk_sp<RenderNode> child)
+    : INHERITED(std::move(child))
+    , fUniqueID(next_unique_id()) {}
+
+LayerCacheEffect::~LayerCacheEffect() {
+    SkResourceCache::PostPurgeSharedID(make_shared_id(fUniqueID));
+}
+
+SkRect LayerCacheEffect::onRevalidate(InvalidationController* ic, const SkMatrix& ctm) {
+    SkASSERT(this->hasInval());
+
+    // Any content invalidation implicitly retires previously cached snapshots.
+    fContentID++;
+    fStableRenders = 0;
+
+    return this->INHERITED::onRevalidate(ic, ctm);
+}
+
+void LayerCacheEffect::onRender(SkCanvas* canvas, const RenderContext* ctx) const {
+    if (this->renderCached(canvas, ctx)) {
+        return;
+    }
+
+    const auto local_ctx = ScopedRenderContext(canvas, ctx).setIsolation(this->bounds(),
+                                                                         canvas->getTotalMatrix(),
+                                                                         true);
+    this->INHERITED::onRender(canvas, local_ctx);
+}
+
+bool LayerCacheEffect::renderCached(SkCanvas* canvas, const RenderContext* ctx) const {
+    // Shader overrides are applied per-draw in the sub-DAG, and cannot be deferred to the
+    // cached image draw.
+    if (ctx && (ctx->fShader || ctx->fMaskShader)) {
+        return false;
+    }
+
+    // Only raster backends, for now.
+    if (canvas->recordingContext() || canvas->imageInfo().colorType() == kUnknown_SkColorType) {
+        return false;
+    }
+
+    const auto& ctm = canvas->getTotalMatrix();
+    if (ctm.hasPerspective()) {
+        return false;
+    }
+
+    // The snapshot is rendered with the CTM scale/skew components and the subpixel part of the
+    // translation, and drawn at the integral part of the translation.
+    auto snapshot_matrix = ctm;
+    snapshot_matrix.setTranslateX(0);
+    snapshot_matrix.setTranslateY(0);
+
+    // Scale/skew animations would miss the cache on every frame: only cache once the scale has
+    // been stable for a few renders too.
+    if (snapshot_matrix != fSnapshotMatrix) {
+        fSnapshotMatrix = snapshot_matrix;
+        fStableRenders  = 0;
+    }
+    if (fStableRenders < kMinStableRenders) {
+        fStableRenders++;
+        return false;
+    }
+
+    const auto qx = SkScalarRoundToScalar(ctm.getTranslateX() * kSubpixelSteps) / kSubpixelSteps,
+               qy = SkScalarRoundToScalar(ctm.getTranslateY() * kSubpixelSteps) / kSubpixelSteps;
+    // Past this, floats don't have enough precision for the subpixel phase anyway (also rejects
+    // non-finite values).
+    static constexpr SkScalar kMaxTranslate = 1 << 22;
+    if (!(SkScalarAbs(qx) <= kMaxTranslate && SkScalarAbs(qy) <= kMaxTranslate)) {
+        return false;
+    }
+    const SkIPoint offset = { SkScalarFloorToInt(qx), SkScalarFloorToInt(qy) };
+    const SkVector phase  = { qx - offset.x(), qy - offset.y() };
+    snapshot_matrix.postTranslate(phase.x(), phase.y());
+
+    // Only the visible part of the layer is snapshotted.
+    auto dev_bounds = snapshot_matrix.mapRect(this->bounds()).roundOut();
+    if (!dev_bounds.intersect(canvas->getDeviceClipBounds().makeOffset(-offset.x(),
+                                                                       -offset.y()))) {
+        return true;
+    }
+
+    const LayerCacheKey key(fUniqueID, fContentID, fSnapshotMatrix,
+                            { SkScalarRoundToInt(phase.x() * kSubpixelSteps),
+                              SkScalarRoundToInt(phase.y() * kSubpixelSteps) });
+    LayerCacheRec::Result cached;
+
+    // Cached snapshots are clipped too, and may not cover what is visible now.
+    if (!SkResourceCache::Find(key, LayerCacheRec::Visitor, &cached) ||
+        !SkIRect::MakePtSize(cached.fOrigin, cached.fImage->dimensions()).contains(dev_bounds)) {
+        if (dev_bounds.width()  > kMaxCacheDimension ||
+            dev_bounds.height() > kMaxCacheDimension) {
+            return false;
+        }
+
+        const auto info = SkImageInfo::MakeN32Premul(dev_bounds.width(), dev_bounds.height(),
+                                                     canvas->imageInfo().refColorSpace());
+        auto surface = SkSurface::MakeRaster(info);
+        if (!surface) {
+            return false;
+        }
+
+        auto* snapshot_canvas = surface->getCanvas();
+        snapshot_canvas->translate(-dev_bounds.x(), -dev_bounds.y());
+        snapshot_canvas->concat(snapshot_matrix);
+        this->INHERITED::onRender(snapshot_canvas, nullptr);
+
+        cached.fImage  = surface->makeImageSnapshot();
+        cached.fOrigin = dev_bounds.topLeft();
+        if (!cached.fImage) {
+            return false;
+        }
+
+        SkResourceCache::Add(new LayerCacheRec(key, cached.fImage, cached.fOrigin));
+    }
+
+    SkPaint paint;
+    if (ctx) {
+        ctx->modulatePaint(ctm, &paint, /*is_layer_paint = */true);
+    }
+
+    // Integral offsets are pixel-exact.
+    canvas->save();
+    canvas->resetMatrix();
+    canvas->drawImage(cached.fImage,
+                      SkIntToScalar(offset.x() + cached.fOrigin.x()),
+                      SkIntToScalar(offset.y() + cached.fOrigin.y()),
+                      SkSamplingOptions(), &paint);
+    canvas->restore();
+
+    return true;
+}
+
+} // namespace sksg
@@ -9,11 +9,15 @@
 
 #if !defined(SK_BUILD_FOR_GOOGLE3)
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkSurface.h"
 #include "include/private/SkTo.h"
 #include "modules/sksg/include/SkSGDraw.h"
 #include "modules/sksg/include/SkSGGroup.h"
 #include "modules/sksg/include/SkSGInvalidationController.h"
+#include "modules/sksg/include/SkSGLayerCacheEffect.h"
 #include "modules/sksg/include/SkSGPaint.h"
 #include "modules/sksg/include/SkSGRect.h"
 #include "modules/sksg/include/SkSGRenderEffect.h"
@@ -355,4 +359,108 @@ DEF_TEST(SGInvalidation, reporter) {
     inval_group_remove(reporter);
 }
 
+DEF_TEST(SGLayerCache, reporter) {
+    auto color = sksg::Color::Make(SK_ColorRED);
+    auto draw  = sksg::Draw::Make(sksg::Rect::Make(SkRect::MakeWH(10, 10)), color);
+    auto xform = sksg::Matrix<SkMatrix>::Make(SkMatrix::Translate(10, 10));
+    auto root  = sksg::TransformEffect::Make(sksg::LayerCacheEffect::Make(draw), xform);
+
+    auto surface = SkSurface::MakeRasterN32Premul(50, 50);
+
+    auto render = [&]() {
+        root->revalidate(nullptr, SkMatrix::I());
+        surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+        root->render(surface->getCanvas());
+    };
+    auto color_at = [&](int x, int y) {
+        SkBitmap bm;
+        bm.allocN32Pixels(1, 1);
+        surface->readPixels(bm, x, y);
+        return bm.getColor(0, 0);
+    };
+
+    // The first few renders are uncached, the rest should hit the cache.
+    for (int i = 0; i < 4; ++i) {
+        render();
+        REPORTER_ASSERT(reporter, color_at( 9,  9) == SK_ColorTRANSPARENT);
+        REPORTER_ASSERT(reporter, color_at(10, 10) == SK_ColorRED);
+        REPORTER_ASSERT(reporter, color_at(19, 19) == SK_ColorRED);
+        REPORTER_ASSERT(reporter, color_at(20, 20) == SK_ColorTRANSPARENT);
+    }
+
+    // Transform changes reuse the cached content.
+    xform->setMatrix(SkMatrix::Translate(20, 20));
+    render();
+    REPORTER_ASSERT(reporter, color_at(19, 19) == SK_ColorTRANSPARENT);
+    REPORTER_ASSERT(reporter, color_at(20, 20) == SK_ColorRED);
+    REPORTER_ASSERT(reporter, color_at(29, 29) == SK_ColorRED);
+
+    // Content changes are picked up.
+    color->setColor(SK_ColorGREEN);
+    for (int i = 0; i < 4; ++i) {
+        render();
+        REPORTER_ASSERT(reporter, color_at(20, 20) == SK_ColorGREEN);
+        REPORTER_ASSERT(reporter, color_at(29, 29) == SK_ColorGREEN);
+    }
+}
+
+DEF_TEST(SGLayerCache_MatchesUncached, reporter) {
+    auto color = sksg::Color::Make(SK_ColorRED);
+    color->setAntiAlias(true);
+    auto draw  = sksg::Draw::Make(sksg::Rect::Make(SkRect::MakeLTRB(0.3f, 0.6f, 9.7f, 9.2f)),
+                                  color);
+    auto xform = sksg::Matrix<SkMatrix>::Make(SkMatrix::I());
+    auto cached_root = sksg::TransformEffect::Make(sksg::LayerCacheEffect::Make(draw), xform),
+         plain_root  = sksg::TransformEffect::Make(draw, xform);
+
+    auto render = [&](const sk_sp<sksg::RenderNode>& root, const SkIRect& clip) {
+        auto surface = SkSurface::MakeRasterN32Premul(64, 64);
+        root->revalidate(nullptr, SkMatrix::I());
+        surface->getCanvas()->clipIRect(clip);
+        root->render(surface->getCanvas());
+
+        SkBitmap bm;
+        bm.allocN32Pixels(64, 64);
+        surface->readPixels(bm, 0, 0);
+        return bm;
+    };
+
+    struct {
+        SkMatrix matrix;
+        SkIRect  clip;
+    } frames[] = {
+        // Subpixel translations on the quarter pixel grid are drawn without resampling.
+        { SkMatrix::Translate(10.25f, 10.75f), SkIRect::MakeWH(64, 64) },
+        { SkMatrix::Translate(10.25f, 10.75f), SkIRect::MakeWH(64, 64) },
+        { SkMatrix::Translate(10.25f, 10.75f), SkIRect::MakeWH(64, 64) },
+        { SkMatrix::Translate(20.5f, 11.f),    SkIRect::MakeWH(64, 64) },
+        // Scale animation.
+        { SkMatrix::Scale(1.5f, 2),            SkIRect::MakeWH(64, 64) },
+        { SkMatrix::Scale(1.6f, 2),            SkIRect::MakeWH(64, 64) },
+        { SkMatrix::Scale(1.7f, 2),            SkIRect::MakeWH(64, 64) },
+        { SkMatrix::Scale(1.7f, 2),            SkIRect::MakeWH(64, 64) },
+        { SkMatrix::Scale(1.7f, 2),            SkIRect::MakeWH(64, 64) },
+        // Partially clipped layers, revealed as they move.
+        { SkMatrix::Translate(0, 0),           SkIRect::MakeWH(5, 5)   },
+        { SkMatrix::Translate(0, 0),           SkIRect::MakeWH(5, 5)   },
+        { SkMatrix::Translate(0, 0),           SkIRect::MakeWH(5, 5)   },
+        { SkMatrix::Translate(-4, -4),         SkIRect::MakeWH(5, 5)   },
+        { SkMatrix::Translate(0, 0),           SkIRect::MakeWH(64, 64) },
+    };
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(frames); ++i) {
+        xform->setMatrix(frames[i].matrix);
+        const auto got  = render(cached_root, frames[i].clip),
+                   want = render(plain_root , frames[i].clip);
+
+        bool equal = true;
+        for (int y = 0; y < 64; ++y) {
+            for (int x = 0; x < 64; ++x) {
+                equal &= *got.getAddr32(x, y) == *want.getAddr32(x, y);
+            }
+        }
+        REPORTER_ASSERT(reporter, equal, "frame %zu", i);
+    }
+}
+
 #endif // !defined(SK_BUILD_FOR_GOOGLE3)
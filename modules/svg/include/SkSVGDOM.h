@@ -15,9 +15,11 @@
 #include "modules/skresources/include/SkResources.h"
 #include "modules/svg/include/SkSVGIDMapper.h"
 
+#include <memory>
+
 class SkCanvas;
-class SkDOM;
 class SkStream;
+class SkSVGDeferredSubtrees;
 class SkSVGNode;
 class SkSVGSVG;
 
@@ -35,13 +37,29 @@ public:
          */
         Builder& setResourceProvider(sk_sp<skresources::ResourceProvider>);
 
+        /**
+         * When enabled, documents which fail to parse part-way through (e.g. truncated streams)
+         * yield a DOM containing all the elements parsed up to the error, instead of nullptr.
+         */
+        Builder& setAllowPartialDocuments(bool);
+
+        /**
+         * Builds the DOM in a single streaming pass over the XML input.
+         *
+         * The content of <defs>, <filter>, <mask> and <pattern> elements is only materialized
+         * when referenced, either from the rendered tree or via findNodeById().  Unreferenced
+         * definitions are not reachable when walking the tree from getRoot().
+         */
         sk_sp<SkSVGDOM> make(SkStream&) const;
 
     private:
         sk_sp<SkFontMgr>                     fFontMgr;
         sk_sp<skresources::ResourceProvider> fResourceProvider;
+        bool                                 fAllowPartialDocuments = false;
     };
 
+    ~SkSVGDOM() override;
+
     static sk_sp<SkSVGDOM> MakeFromStream(SkStream& str) {
         return Builder().make(str);
     }
@@ -83,12 +101,13 @@ public:
 
 private:
     SkSVGDOM(sk_sp<SkSVGSVG>, sk_sp<SkFontMgr>, sk_sp<skresources::ResourceProvider>,
-             SkSVGIDMapper&&);
+             SkSVGIDMapper&&, std::unique_ptr<SkSVGDeferredSubtrees>);
 
     const sk_sp<SkSVGSVG>                      fRoot;
     const sk_sp<SkFontMgr>                     fFontMgr;
     const sk_sp<skresources::ResourceProvider> fResourceProvider;
-    const SkSVGIDMapper                        fIDMapper;
+    SkSVGIDMapper                              fIDMapper;
+    std::unique_ptr<SkSVGDeferredSubtrees>     fDeferredSubtrees;
 
     SkSize                 fContainerSize;
 };
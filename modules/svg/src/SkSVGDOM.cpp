@@ -8,6 +8,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkString.h"
+#include "include/private/SkTArray.h"
 #include "include/private/SkTo.h"
 #include "modules/svg/include/SkSVGAttributeParser.h"
 #include "modules/svg/include/SkSVGCircle.h"
@@ -48,7 +49,9 @@
 #include "modules/svg/include/SkSVGValue.h"
 #include "src/core/SkTSearch.h"
 #include "src/core/SkTraceEvent.h"
-#include "src/xml/SkDOM.h"
+#include "src/xml/SkXMLParser.h"
+
+#include <vector>
 
 namespace {
 
@@ -275,15 +278,6 @@ SortedDictionaryEntry<sk_sp<SkSVGNode>(*)()> gTagFactories[] = {
     { "use"               , []() -> sk_sp<SkSVGNode> { return SkSVGUse::Make();                }},
 };
 
-struct ConstructionContext {
-    ConstructionContext(SkSVGIDMapper* mapper) : fParent(nullptr), fIDMapper(mapper) {}
-    ConstructionContext(const ConstructionContext& other, const sk_sp<SkSVGNode>& newParent)
-        : fParent(newParent.get()), fIDMapper(other.fIDMapper) {}
-
-    SkSVGNode*     fParent;
-    SkSVGIDMapper* fIDMapper;
-};
-
 bool set_string_attribute(const sk_sp<SkSVGNode>& node, const char* name, const char* value) {
     if (node->parseAndSetAttribute(name, value)) {
         // Handled by new code path
@@ -312,79 +306,382 @@ bool set_string_attribute(const sk_sp<SkSVGNode>& node, const char* name, const
     return true;
 }
 
-void parse_node_attributes(const SkDOM& xmlDom, const SkDOM::Node* xmlNode,
-                           const sk_sp<SkSVGNode>& svgNode, SkSVGIDMapper* mapper) {
-    const char* name, *value;
-    SkDOM::AttrIter attrIter(xmlDom, xmlNode);
-    while ((name = attrIter.next(&value))) {
-        // We're handling id attributes out of band for now.
-        if (!strcmp(name, "id")) {
-            mapper->set(SkString(value), svgNode);
-            continue;
+// These elements are never rendered in place, and are only reachable via IRI references.
+// Their subtrees are recorded as compact parser events during the streaming pass, and only
+// turned into SkSVGNodes when something actually references them.
+bool is_deferrable_element(const char* elem) {
+    return !strcmp(elem, "defs")   ||
+           !strcmp(elem, "filter") ||
+           !strcmp(elem, "mask")   ||
+           !strcmp(elem, "pattern");
+}
+
+// Collects the fragment IDs referenced by an attribute value: either plain IRIs ("#foo", as
+// used by xlink:href) or functional IRIs ("url(#foo)"), possibly embedded in style declarations.
+// Over-collecting is harmless -- it merely materializes a deferred subtree early.
+void collect_iri_references(const char* value, SkTArray<SkString>* refs) {
+    if (!strchr(value, '#')) {
+        return;
+    }
+
+    auto collect_fragment = [refs](const char* pos) {
+        SkASSERT(*pos == '#');
+        const char* start = ++pos;
+        while (*pos && *pos != ')' && *pos != '\'' && *pos != '"' && *pos > ' ') {
+            pos++;
+        }
+        if (pos > start) {
+            refs->push_back(SkString(start, SkTo<size_t>(pos - start)));
         }
-        set_string_attribute(svgNode, name, value);
+        return pos;
+    };
+
+    const char* pos = value;
+    while (*pos && *pos <= ' ') { pos++; }
+    if (*pos == '#') {
+        collect_fragment(pos);
+        return;
     }
-}
 
-sk_sp<SkSVGNode> construct_svg_node(const SkDOM& dom, const ConstructionContext& ctx,
-                                    const SkDOM::Node* xmlNode) {
-    const char* elem = dom.getName(xmlNode);
-    const SkDOM::Type elemType = dom.getType(xmlNode);
+    while ((pos = strstr(pos, "url("))) {
+        pos += 4;
+        while (*pos && (*pos <= ' ' || *pos == '\'' || *pos == '"')) { pos++; }
+        if (*pos == '#') {
+            pos = collect_fragment(pos);
+        }
+    }
+}
 
-    if (elemType == SkDOM::kText_Type) {
-        // Text literals require special handling.
-        SkASSERT(dom.countChildren(xmlNode) == 0);
-        auto txt = SkSVGTextLiteral::Make();
-        txt->setText(SkString(dom.getName(xmlNode)));
-        ctx.fParent->appendChild(std::move(txt));
+sk_sp<SkSVGNode> make_svg_node(const char* elem, bool isRoot) {
+    if (strcmp(elem, "svg") == 0) {
+        // Outermost SVG element must be tagged as such.
+        return SkSVGSVG::Make(isRoot ? SkSVGSVG::Type::kRoot
+                                     : SkSVGSVG::Type::kInner);
+    }
 
+    const int tagIndex = SkStrSearch(&gTagFactories[0].fKey,
+                                     SkTo<int>(SK_ARRAY_COUNT(gTagFactories)),
+                                     elem, sizeof(gTagFactories[0]));
+    if (tagIndex < 0) {
+#if defined(SK_VERBOSE_SVG_PARSING)
+        SkDebugf("unhandled element: <%s>\n", elem);
+#endif
         return nullptr;
     }
+    SkASSERT(SkTo<size_t>(tagIndex) < SK_ARRAY_COUNT(gTagFactories));
 
-    SkASSERT(elemType == SkDOM::kElement_Type);
+    return gTagFactories[tagIndex].fValue();
+}
+
+} // anonymous namespace
 
-    auto make_node = [](const ConstructionContext& ctx, const char* elem) -> sk_sp<SkSVGNode> {
-        if (strcmp(elem, "svg") == 0) {
-            // Outermost SVG element must be tagged as such.
-            return SkSVGSVG::Make(ctx.fParent ? SkSVGSVG::Type::kInner
-                                              : SkSVGSVG::Type::kRoot);
+// Storage for deferred element subtrees.
+//
+// Events are serialized back-to-back into a single buffer, as a tag byte followed by
+// zero-terminated strings:
+//
+//   kStart name\0 | kAttribute name\0 value\0 | kText text\0 | kEnd
+//
+// Each subtree remembers the node it was originally parented to, and gets attached there upon
+// materialization.  Since deferred elements are hidden containers, their position among the
+// parent's children does not affect rendering.
+class SkSVGDeferredSubtrees {
+public:
+    bool hasPending() const { return fPendingCount > 0; }
+
+    void beginSubtree(sk_sp<SkSVGNode> parent) {
+        SkASSERT(fRecordingIndex < 0);
+        fRecordingIndex = SkToInt(fSubtrees.size());
+        fSubtrees.push_back({std::move(parent), fEvents.size(), fEvents.size(), false});
+        fPendingCount++;
+    }
+
+    void endSubtree() {
+        SkASSERT(fRecordingIndex >= 0);
+        fSubtrees[fRecordingIndex].fEnd = fEvents.size();
+        fRecordingIndex = -1;
+    }
+
+    void endSubtreeIfRecording() {
+        if (fRecordingIndex >= 0) {
+            this->endSubtree();
         }
+    }
 
-        const int tagIndex = SkStrSearch(&gTagFactories[0].fKey,
-                                         SkTo<int>(SK_ARRAY_COUNT(gTagFactories)),
-                                         elem, sizeof(gTagFactories[0]));
-        if (tagIndex < 0) {
-#if defined(SK_VERBOSE_SVG_PARSING)
-            SkDebugf("unhandled element: <%s>\n", elem);
-#endif
-            return nullptr;
+    void recordStart(const char elem[]) {
+        fEvents.push_back(kStart);
+        this->appendString(elem, strlen(elem));
+    }
+
+    void recordAttribute(const char name[], const char value[]) {
+        fEvents.push_back(kAttribute);
+        this->appendString(name, strlen(name));
+        this->appendString(value, strlen(value));
+
+        if (!strcmp(name, "id")) {
+            SkASSERT(fRecordingIndex >= 0);
+            fIDs.set(SkString(value), fRecordingIndex);
         }
-        SkASSERT(SkTo<size_t>(tagIndex) < SK_ARRAY_COUNT(gTagFactories));
+    }
+
+    void recordText(const char text[], int len) {
+        fEvents.push_back(kText);
+        this->appendString(text, SkTo<size_t>(len));
+    }
+
+    void recordEnd() {
+        fEvents.push_back(kEnd);
+    }
 
-        return gTagFactories[tagIndex].fValue();
+    // Materializes the subtrees defining any of the given IDs, and (transitively) the subtrees
+    // they reference in turn.
+    void materialize(SkTArray<SkString>&& refs, SkSVGIDMapper* mapper);
+
+private:
+    enum : char {
+        kStart,
+        kAttribute,
+        kText,
+        kEnd,
     };
 
-    auto node = make_node(ctx, elem);
-    if (!node) {
-        return nullptr;
+    struct Subtree {
+        sk_sp<SkSVGNode> fParent;
+        size_t           fBegin,
+                         fEnd;
+        bool             fMaterialized;
+    };
+
+    void appendString(const char str[], size_t len) {
+        fEvents.insert(fEvents.end(), str, str + len);
+        fEvents.push_back('\0');
     }
 
-    parse_node_attributes(dom, xmlNode, node, ctx.fIDMapper);
+    void replay(const Subtree&, SkSVGIDMapper*, SkTArray<SkString>* refs) const;
+
+    std::vector<char>         fEvents;
+    std::vector<Subtree>      fSubtrees;
+    SkTHashMap<SkString, int> fIDs;
+    int                       fRecordingIndex = -1,
+                              fPendingCount   = 0;
+};
+
+namespace {
 
-    ConstructionContext localCtx(ctx, node);
-    for (auto* child = dom.getFirstChild(xmlNode, nullptr); child;
-         child = dom.getNextSibling(child)) {
-        sk_sp<SkSVGNode> childNode = construct_svg_node(dom, localCtx, child);
-        if (childNode) {
-            node->appendChild(std::move(childNode));
+// Builds SkSVGNodes directly from XML parser events.
+//
+// Nodes are attached to their parent as soon as they are created, so the tree is always in a
+// consistent (renderable) state, even when the event stream is cut short.
+class SVGNodeBuilder {
+public:
+    // When |deferred| is non-null, deferrable subtrees are recorded there instead of being
+    // constructed.  When |parent| is non-null, top level elements are attached to it.
+    SVGNodeBuilder(SkSVGIDMapper* mapper, SkSVGDeferredSubtrees* deferred,
+                   SkTArray<SkString>* refs, SkSVGNode* parent = nullptr)
+        : fIDMapper(mapper)
+        , fDeferred(deferred)
+        , fRefs(refs)
+        , fParent(parent) {}
+
+    const sk_sp<SkSVGNode>& root() const { return fRoot; }
+
+    void startElement(const char elem[]) {
+        if (fRecordingDepth > 0) {
+            fRecordingDepth++;
+            fDeferred->recordStart(elem);
+            return;
+        }
+
+        if (fSkipDepth > 0) {
+            // Children of unhandled elements are ignored.
+            fSkipDepth++;
+            return;
         }
+
+        SkSVGNode* parent = fStack.empty() ? fParent : fStack.back().get();
+
+        if (fDeferred && parent && is_deferrable_element(elem)) {
+            fDeferred->beginSubtree(sk_ref_sp(parent));
+            fDeferred->recordStart(elem);
+            fRecordingDepth = 1;
+            return;
+        }
+
+        auto node = make_svg_node(elem, !parent);
+        if (!node) {
+            fSkipDepth = 1;
+            return;
+        }
+
+        if (parent) {
+            parent->appendChild(node);
+        } else if (!fRoot) {
+            fRoot = node;
+        } else {
+            // Multiple roots are not a thing in well-formed XML.
+            fSkipDepth = 1;
+            return;
+        }
+
+        fStack.push_back(std::move(node));
     }
 
-    return node;
-}
+    void addAttribute(const char name[], const char value[]) {
+        if (fRecordingDepth > 0) {
+            fDeferred->recordAttribute(name, value);
+            return;
+        }
+
+        if (fSkipDepth > 0) {
+            return;
+        }
+
+        SkASSERT(!fStack.empty());
+        const auto& node = fStack.back();
+
+        // We're handling id attributes out of band for now.
+        if (!strcmp(name, "id")) {
+            fIDMapper->set(SkString(value), node);
+            return;
+        }
+
+        collect_iri_references(value, fRefs);
+        set_string_attribute(node, name, value);
+    }
+
+    void endElement() {
+        if (fRecordingDepth > 0) {
+            fDeferred->recordEnd();
+            if (--fRecordingDepth == 0) {
+                fDeferred->endSubtree();
+            }
+            return;
+        }
+
+        if (fSkipDepth > 0) {
+            fSkipDepth--;
+            return;
+        }
+
+        SkASSERT(!fStack.empty());
+        fStack.pop_back();
+    }
+
+    void text(const char text[], int len) {
+        if (fRecordingDepth > 0) {
+            fDeferred->recordText(text, len);
+            return;
+        }
+
+        if (fSkipDepth > 0 || fStack.empty()) {
+            return;
+        }
+
+        // Text literals require special handling.
+        auto txt = SkSVGTextLiteral::Make();
+        txt->setText(SkString(text, SkTo<size_t>(len)));
+        fStack.back()->appendChild(std::move(txt));
+    }
+
+private:
+    SkSVGIDMapper*                fIDMapper;
+    SkSVGDeferredSubtrees*        fDeferred;
+    SkTArray<SkString>*           fRefs;
+    SkSVGNode*                    fParent;
+
+    sk_sp<SkSVGNode>              fRoot;
+    std::vector<sk_sp<SkSVGNode>> fStack;
+    int                           fSkipDepth      = 0,
+                                  fRecordingDepth = 0;
+};
+
+class SVGStreamParser final : public SkXMLParser {
+public:
+    explicit SVGStreamParser(SVGNodeBuilder* builder) : fBuilder(builder) {}
+
+protected:
+    bool onStartElement(const char elem[]) override {
+        fBuilder->startElement(elem);
+        return false;
+    }
+
+    bool onAddAttribute(const char name[], const char value[]) override {
+        fBuilder->addAttribute(name, value);
+        return false;
+    }
+
+    bool onEndElement(const char[]) override {
+        fBuilder->endElement();
+        return false;
+    }
+
+    bool onText(const char text[], int len) override {
+        fBuilder->text(text, len);
+        return false;
+    }
+
+private:
+    SVGNodeBuilder* fBuilder;
+};
 
 } // anonymous namespace
 
+void SkSVGDeferredSubtrees::materialize(SkTArray<SkString>&& refs, SkSVGIDMapper* mapper) {
+    SkASSERT(fRecordingIndex < 0);
+
+    while (!refs.empty() && this->hasPending()) {
+        const SkString id = std::move(refs.back());
+        refs.pop_back();
+
+        const int* index = fIDs.find(id);
+        if (!index || fSubtrees[*index].fMaterialized) {
+            continue;
+        }
+
+        auto& subtree = fSubtrees[*index];
+        subtree.fMaterialized = true;
+        fPendingCount--;
+
+        this->replay(subtree, mapper, &refs);
+    }
+}
+
+void SkSVGDeferredSubtrees::replay(const Subtree& subtree, SkSVGIDMapper* mapper,
+                                   SkTArray<SkString>* refs) const {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+
+    SVGNodeBuilder builder(mapper, nullptr, refs, subtree.fParent.get());
+
+    const char* pos = fEvents.data() + subtree.fBegin;
+    const char* end = fEvents.data() + subtree.fEnd;
+    while (pos < end) {
+        const char tag = *pos++;
+        const char* str0 = pos;
+        switch (tag) {
+        case kStart:
+            pos += strlen(str0) + 1;
+            builder.startElement(str0);
+            break;
+        case kAttribute: {
+            pos += strlen(str0) + 1;
+            const char* str1 = pos;
+            pos += strlen(str1) + 1;
+            builder.addAttribute(str0, str1);
+        } break;
+        case kText: {
+            const size_t len = strlen(str0);
+            pos += len + 1;
+            builder.text(str0, SkToInt(len));
+        } break;
+        case kEnd:
+            builder.endElement();
+            break;
+        default:
+            SkUNREACHABLE;
+        }
+    }
+}
+
 SkSVGDOM::Builder& SkSVGDOM::Builder::setFontManager(sk_sp<SkFontMgr> fmgr) {
     fFontMgr = std::move(fmgr);
     return *this;
@@ -395,21 +692,38 @@ SkSVGDOM::Builder& SkSVGDOM::Builder::setResourceProvider(sk_sp<skresources::Res
     return *this;
 }
 
+SkSVGDOM::Builder& SkSVGDOM::Builder::setAllowPartialDocuments(bool allow) {
+    fAllowPartialDocuments = allow;
+    return *this;
+}
+
 sk_sp<SkSVGDOM> SkSVGDOM::Builder::make(SkStream& str) const {
     TRACE_EVENT0("skia", TRACE_FUNC);
-    SkDOM xmlDom;
-    if (!xmlDom.build(str)) {
+
+    SkSVGIDMapper      mapper;
+    SkTArray<SkString> refs;
+    auto               deferred = std::make_unique<SkSVGDeferredSubtrees>();
+
+    SVGNodeBuilder  builder(&mapper, deferred.get(), &refs);
+    SVGStreamParser parser(&builder);
+    if (!parser.parse(str) && !fAllowPartialDocuments) {
         return nullptr;
     }
 
-    SkSVGIDMapper mapper;
-    ConstructionContext ctx(&mapper);
-
-    auto root = construct_svg_node(xmlDom, ctx, xmlDom.getRootNode());
+    const auto& root = builder.root();
     if (!root || root->tag() != SkSVGTag::kSvg) {
         return nullptr;
     }
 
+    // A partial document may be cut short in the middle of a deferred subtree.
+    deferred->endSubtreeIfRecording();
+
+    // Resolve everything referenced from the eagerly constructed tree.
+    deferred->materialize(std::move(refs), &mapper);
+    if (!deferred->hasPending()) {
+        deferred.reset();
+    }
+
     class NullResourceProvider final : public skresources::ResourceProvider {
         sk_sp<SkData> load(const char[], const char[]) const override { return nullptr; }
     };
@@ -417,22 +731,26 @@ sk_sp<SkSVGDOM> SkSVGDOM::Builder::make(SkStream& str) const {
     auto resource_provider = fResourceProvider ? fResourceProvider
                                                : sk_make_sp<NullResourceProvider>();
 
-    return sk_sp<SkSVGDOM>(new SkSVGDOM(sk_sp<SkSVGSVG>(static_cast<SkSVGSVG*>(root.release())),
+    return sk_sp<SkSVGDOM>(new SkSVGDOM(sk_ref_sp(static_cast<SkSVGSVG*>(root.get())),
                                         std::move(fFontMgr), std::move(resource_provider),
-                                        std::move(mapper)));
+                                        std::move(mapper), std::move(deferred)));
 }
 
 SkSVGDOM::SkSVGDOM(sk_sp<SkSVGSVG> root, sk_sp<SkFontMgr> fmgr,
-                   sk_sp<skresources::ResourceProvider> rp, SkSVGIDMapper&& mapper)
+                   sk_sp<skresources::ResourceProvider> rp, SkSVGIDMapper&& mapper,
+                   std::unique_ptr<SkSVGDeferredSubtrees> deferred)
     : fRoot(std::move(root))
     , fFontMgr(std::move(fmgr))
     , fResourceProvider(std::move(rp))
     , fIDMapper(std::move(mapper))
+    , fDeferredSubtrees(std::move(deferred))
     , fContainerSize(fRoot->intrinsicSize(SkSVGLengthContext(SkSize::Make(0, 0))))
 {
     SkASSERT(fResourceProvider);
 }
 
+SkSVGDOM::~SkSVGDOM() = default;
+
 void SkSVGDOM::render(SkCanvas* canvas) const {
     TRACE_EVENT0("skia", TRACE_FUNC);
     if (fRoot) {
@@ -454,6 +772,14 @@ void SkSVGDOM::setContainerSize(const SkSize& containerSize) {
 
 sk_sp<SkSVGNode>* SkSVGDOM::findNodeById(const char* id) {
     SkString idStr(id);
+    if (fDeferredSubtrees) {
+        SkTArray<SkString> refs;
+        refs.push_back(idStr);
+        fDeferredSubtrees->materialize(std::move(refs), &fIDMapper);
+        if (!fDeferredSubtrees->hasPending()) {
+            fDeferredSubtrees.reset();
+        }
+    }
     return this->fIDMapper.find(idStr);
 }
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2022 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <string>
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkStream.h"
+#include "modules/svg/include/SkSVGDOM.h"
+#include "modules/svg/include/SkSVGNode.h"
+#include "tests/Test.h"
+
+namespace {
+
+sk_sp<SkSVGDOM> make_dom(const std::string& svgText, bool allowPartial = false) {
+    auto str = SkMemoryStream::MakeDirect(svgText.c_str(), svgText.size());
+    return SkSVGDOM::Builder().setAllowPartialDocuments(allowPartial).make(*str);
+}
+
+SkColor render_pixel(const sk_sp<SkSVGDOM>& dom, int x, int y) {
+    SkBitmap bm;
+    bm.allocN32Pixels(100, 100);
+    bm.eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(bm);
+    dom->render(&canvas);
+
+    return bm.getColor(x, y);
+}
+
+} // namespace
+
+DEF_TEST(Svg_DOM_DeferredDefinitions, r) {
+    const std::string svgText = R"EOF(
+    <svg width="100" height="100" xmlns="http://www.w3.org/2000/svg"
+         xmlns:xlink="http://www.w3.org/1999/xlink">
+        <defs>
+            <linearGradient id="base">
+                <stop offset="0" stop-color="#0f0"/>
+                <stop offset="1" stop-color="#0f0"/>
+            </linearGradient>
+            <linearGradient id="grad" xlink:href="#base"/>
+            <rect id="unused" width="100" height="100" fill="#f00"/>
+        </defs>
+        <defs>
+            <mask id="unused_mask">
+                <rect width="100" height="100" fill="white"/>
+            </mask>
+        </defs>
+        <rect width="100" height="100" style="fill: url(#grad)"/>
+    </svg>
+    )EOF";
+
+    auto dom = make_dom(svgText);
+    REPORTER_ASSERT(r, dom);
+
+    // Referenced definitions (and their own references) are resolved when the DOM is built.
+    REPORTER_ASSERT(r, render_pixel(dom, 50, 50) == SK_ColorGREEN);
+
+    // Unreferenced definitions are materialized on demand.
+    auto* unused = dom->findNodeById("unused");
+    REPORTER_ASSERT(r, unused && (*unused)->tag() == SkSVGTag::kRect);
+    auto* mask = dom->findNodeById("unused_mask");
+    REPORTER_ASSERT(r, mask && (*mask)->tag() == SkSVGTag::kMask);
+
+    REPORTER_ASSERT(r, !dom->findNodeById("missing"));
+
+    // Materializing definitions does not affect rendering.
+    REPORTER_ASSERT(r, render_pixel(dom, 50, 50) == SK_ColorGREEN);
+}
+
+DEF_TEST(Svg_DOM_PartialDocument, r) {
+    const std::string svgText = R"EOF(
+    <svg width="100" height="100" xmlns="http://www.w3.org/2000/svg">
+        <defs>
+            <linearGradient id="grad">
+                <stop offset="0" stop-color="#00f"/>
+                <stop offset="1" stop-color="#00f"/>
+            </linearGradient>
+        </defs>
+        <rect width="100" height="50" fill="#0f0"/>
+        <rect y="50" width="100" height="50" fill="url(#grad)"/>
+        <g>
+            <rect width="100" hei)EOF";
+
+    REPORTER_ASSERT(r, !make_dom(svgText));
+
+    auto dom = make_dom(svgText, true);
+    REPORTER_ASSERT(r, dom);
+    REPORTER_ASSERT(r, render_pixel(dom, 50, 25) == SK_ColorGREEN);
+    REPORTER_ASSERT(r, render_pixel(dom, 50, 75) == SK_ColorBLUE);
+
+    // Documents without a root element are rejected regardless.
+    REPORTER_ASSERT(r, !make_dom("<svg", true));
+    REPORTER_ASSERT(r, !make_dom("<g><rect/></g>", true));
+}
@@ -14,6 +14,7 @@
 #include "include/private/SkHalf.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkFrameHolder.h"
+#include "src/core/SkColorXformPlan.h"
 
 // We always include and compile in these BMP codecs
 #include "src/codec/SkBmpCodec.h"
@@ -718,6 +719,7 @@ bool sk_select_xform_format(SkColorType colorType, bool forColorTable,
 bool SkCodec::initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Alpha encodedAlpha,
                                    bool srcIsOpaque) {
     fXformTime = kNo_XformTime;
+    fColorXformPlan.reset();
     bool needsColorXform = false;
     if (this->usesColorXform()) {
         if (kRGBA_F16_SkColorType == dstInfo.colorType()) {
@@ -759,16 +761,22 @@ bool SkCodec::initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Al
         } else {
             fDstXformAlphaFormat = skcms_AlphaFormat_Unpremul;
         }
+        // It is okay for the src profile to be null. This will use sRGB.
+        fColorXformPlan = std::make_unique<SkColorXformPlan>(
+                fSrcXformFormat, skcms_AlphaFormat_Unpremul, fEncodedInfo.profile(),
+                fDstXformFormat, fDstXformAlphaFormat, &fDstProfile);
     }
     return true;
 }
 
 void SkCodec::applyColorXform(void* dst, const void* src, int count) const {
-    // It is okay for srcProfile to be null. This will use sRGB.
-    const auto* srcProfile = fEncodedInfo.profile();
-    SkAssertResult(skcms_Transform(src, fSrcXformFormat, skcms_AlphaFormat_Unpremul, srcProfile,
-                                   dst, fDstXformFormat, fDstXformAlphaFormat, &fDstProfile,
-                                   count));
+    SkAssertResult(fColorXformPlan->apply(dst, src, count));
+}
+
+void SkCodec::applyColorXform(void* dst, size_t dstRowBytes, const void* src, size_t srcRowBytes,
+                              int width, int height, SkExecutor* executor) const {
+    SkAssertResult(fColorXformPlan->apply(dst, dstRowBytes, src, srcRowBytes, width, height,
+                                          executor));
 }
 
 std::vector<SkCodec::FrameInfo> SkCodec::getFrameInfo() {
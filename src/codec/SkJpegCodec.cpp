@@ -17,6 +17,8 @@
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 
+#include <algorithm>
+
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "src/codec/SkJpegUtility.h"
@@ -443,6 +445,10 @@ bool SkJpegCodec::onDimensionsSupported(const SkISize& size) {
     return true;
 }
 
+// Without an executor, rows transformed in place are handed to the color xform in groups of
+// about this many pixels, which is enough to amortize each call's setup and still fits in cache.
+static constexpr int kXformBatchPixels = 16 * 1024;
+
 int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
                           const Options& opts) {
     // Set the jump location for libjpeg-turbo errors
@@ -481,26 +487,48 @@ int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
         dstWidth = fSwizzler->swizzleWidth();
     }
 
-    for (int y = 0; y < count; y++) {
+    // Without fColorXformSrcRow, rows are decoded (and swizzled) straight into dst, and we
+    // color xform them there in place, several rows per call.  Without an executor we do that
+    // every few rows, while they are still in cache.  With one, we wait until all the rows are
+    // decoded, so the xform can split them into bands that run in parallel.
+    const bool xformInPlace = this->colorXform() && !fColorXformSrcRow;
+    const int xformBatchRows = opts.fExecutor ? count
+                                              : std::max(1, kXformBatchPixels / dstWidth);
+    void* xformDst = dst;
+    int xformRows = 0;
+
+    int y = 0;
+    for (; y < count; y++) {
         uint32_t lines = jpeg_read_scanlines(fDecoderMgr->dinfo(), &decodeDst, 1);
         if (0 == lines) {
-            return y;
+            break;
         }
 
         if (fSwizzler) {
             fSwizzler->swizzle(swizzleDst, decodeDst);
         }
 
-        if (this->colorXform()) {
+        if (this->colorXform() && !xformInPlace) {
             this->applyColorXform(dst, swizzleDst, dstWidth);
             dst = SkTAddOffset<void>(dst, rowBytes);
         }
 
+        if (xformInPlace && ++xformRows == xformBatchRows) {
+            this->applyColorXform(xformDst, rowBytes, xformDst, rowBytes, dstWidth, xformRows,
+                                  opts.fExecutor);
+            xformDst = SkTAddOffset<void>(xformDst, xformRows * rowBytes);
+            xformRows = 0;
+        }
+
         decodeDst = SkTAddOffset<JSAMPLE>(decodeDst, decodeDstRowBytes);
         swizzleDst = SkTAddOffset<uint32_t>(swizzleDst, swizzleDstRowBytes);
     }
 
-    return count;
+    if (xformInPlace && xformRows > 0) {
+        this->applyColorXform(xformDst, rowBytes, xformDst, rowBytes, dstWidth, xformRows,
+                              opts.fExecutor);
+    }
+    return y;
 }
 
 /*
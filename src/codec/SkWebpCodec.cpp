@@ -522,16 +522,17 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
             xformDst = dst;
         }
 
-        for (int y = 0; y < rowsDecoded; y++) {
-            this->applyColorXform(xformDst, xformSrc, scaledWidth);
-            if (blendWithPrevFrame) {
+        if (blendWithPrevFrame) {
+            for (int y = 0; y < rowsDecoded; y++) {
+                this->applyColorXform(xformDst, xformSrc, scaledWidth);
                 blend_line(dstCT, dst, dstCT, xformDst,
                         dstInfo.alphaType(), frame.has_alpha, scaledWidth);
                 dst = SkTAddOffset<void>(dst, rowBytes);
-            } else {
-                xformDst = SkTAddOffset<void>(xformDst, rowBytes);
+                xformSrc = SkTAddOffset<uint32_t>(xformSrc, srcRowBytes);
             }
-            xformSrc = SkTAddOffset<uint32_t>(xformSrc, srcRowBytes);
+        } else {
+            this->applyColorXform(xformDst, rowBytes, xformSrc, srcRowBytes,
+                                  scaledWidth, rowsDecoded, options.fExecutor);
         }
     } else if (blendWithPrevFrame) {
         const uint8_t* src = config.output.u.RGBA.rgba;
@@ -248,12 +248,27 @@ class SkAAClip::Builder {
     int fWidth;
     int fMinY;
 
+    // When building the intersection of a path with an existing clip, each run is scaled by the
+    // clip's coverage as it is added, and these track our position in the clip's runs. Rows and
+    // runs are added in order, so the position only ever moves forward.
+    const SkAAClip* fClip;
+    Iter            fClipIter;
+    int             fClipY;
+    const uint8_t*  fClipRun;
+    int             fClipRunRight;
+
 public:
-    Builder(const SkIRect& bounds) : fBounds(bounds) {
+    Builder(const SkIRect& bounds, const SkAAClip* clip = nullptr) : fBounds(bounds) {
         fPrevY = -1;
         fWidth = bounds.width();
         fCurrRow = nullptr;
         fMinY = bounds.fTop;
+        fClip = clip;
+        fClipY = -SK_MaxS32;
+        if (clip) {
+            SkASSERT(clip->getBounds().contains(bounds));
+            fClipIter = RunHead::Iterate(*clip);
+        }
     }
 
     ~Builder() {
@@ -274,6 +289,66 @@ private:
     void operateY(const SkAAClip& A, const SkAAClip& B, SkClipOp op);
 
     void addRun(int x, int y, U8CPU alpha, int count) {
+        if (!fClip || !alpha) {
+            this->appendRun(x, y, alpha, count);
+            return;
+        }
+        // Split the run wherever the clip's coverage changes.
+        this->seekClip(x, y);
+        for (;;) {
+            int n = std::min(count, fClipRunRight - x);
+            this->appendRun(x, y, SkMulDiv255Round(alpha, fClipRun[1]), n);
+            count -= n;
+            if (!count) {
+                break;
+            }
+            x += n;
+            fClipRun += 2;
+            fClipRunRight += fClipRun[0];
+        }
+    }
+
+    // Moves our position in the clip to the run containing (x, y).
+    void seekClip(int x, int y) {
+        SkASSERT(fClip->getBounds().contains(x, y));
+        if (y != fClipY) {
+            SkASSERT(y > fClipY);
+            while (fClipIter.bottom() <= y) {
+                fClipIter.next();
+            }
+            fClipY = y;
+            fClipRun = fClipIter.data();
+            fClipRunRight = fClip->getBounds().fLeft + fClipRun[0];
+        }
+        while (fClipRunRight <= x) {
+            fClipRun += 2;
+            fClipRunRight += fClipRun[0];
+        }
+    }
+
+    // Adds the same runs to each row in [y, y + height), by calling addRow() once for each span of
+    // rows over which the clip (if any) doesn't change, and then stretching that row to the end of
+    // its span. addRow() must fill its row in up to our right edge.
+    template <typename AddRow>
+    void addRows(int y, int height, AddRow&& addRow) {
+        const int bottom = y + height;
+        while (y < bottom) {
+            int spanBottom = bottom;
+            if (fClip) {
+                this->seekClip(fClip->getBounds().fLeft, y);
+                spanBottom = std::min(bottom, fClipIter.bottom());
+            }
+            addRow(y);
+            // if we never called addRun, we might not have a fCurrRow yet
+            if (fCurrRow) {
+                SkASSERT(y - fBounds.fTop == fCurrRow->fY);
+                fCurrRow->fY = spanBottom - 1 - fBounds.fTop;
+            }
+            y = spanBottom;
+        }
+    }
+
+    void appendRun(int x, int y, U8CPU alpha, int count) {
         SkASSERT(count > 0);
         SkASSERT(fBounds.contains(x, y));
         SkASSERT(fBounds.contains(x + count - 1, y));
@@ -313,24 +388,21 @@ private:
     void addColumn(int x, int y, U8CPU alpha, int height) {
         SkASSERT(fBounds.contains(x, y + height - 1));
 
-        this->addRun(x, y, alpha, 1);
-        this->flushRowH(fCurrRow);
-        y -= fBounds.fTop;
-        SkASSERT(y == fCurrRow->fY);
-        fCurrRow->fY = y + height - 1;
+        this->addRows(y, height, [&](int rowY) {
+            this->addRun(x, rowY, alpha, 1);
+            this->flushRowH(fCurrRow);
+        });
     }
 
     void addRectRun(int x, int y, int width, int height) {
         SkASSERT(fBounds.contains(x + width - 1, y + height - 1));
-        this->addRun(x, y, 0xFF, width);
+        this->addRows(y, height, [&](int rowY) {
+            this->addRun(x, rowY, 0xFF, width);
 
-        // we assum the rect must be all we'll see for these scanlines
-        // so we ensure our row goes all the way to our right
-        this->flushRowH(fCurrRow);
-
-        y -= fBounds.fTop;
-        SkASSERT(y == fCurrRow->fY);
-        fCurrRow->fY = y + height - 1;
+            // we assum the rect must be all we'll see for these scanlines
+            // so we ensure our row goes all the way to our right
+            this->flushRowH(fCurrRow);
+        });
     }
 
     void addAntiRectRun(int x, int y, int width, int height,
@@ -344,34 +416,33 @@ private:
 
         // Conceptually we're always adding 3 runs, but we should
         // merge or omit them if possible.
-        if (leftAlpha == 0xFF) {
-            width++;
-        } else if (leftAlpha > 0) {
-          this->addRun(x++, y, leftAlpha, 1);
-        } else {
-          // leftAlpha is 0, ignore the left column
-          x++;
-        }
-        if (rightAlpha == 0xFF) {
-            width++;
-        }
-        if (width > 0) {
-            this->addRun(x, y, 0xFF, width);
-        }
-        if (rightAlpha > 0 && rightAlpha < 255) {
-            this->addRun(x + width, y, rightAlpha, 1);
-        }
-
-        // if we never called addRun, we might not have a fCurrRow yet
-        if (fCurrRow) {
-            // we assume the rect must be all we'll see for these scanlines
-            // so we ensure our row goes all the way to our right
-            this->flushRowH(fCurrRow);
+        this->addRows(y, height, [&](int rowY) {
+            int rowX = x;
+            int rowWidth = width;
+            if (leftAlpha == 0xFF) {
+                rowWidth++;
+            } else if (leftAlpha > 0) {
+              this->addRun(rowX++, rowY, leftAlpha, 1);
+            } else {
+              // leftAlpha is 0, ignore the left column
+              rowX++;
+            }
+            if (rightAlpha == 0xFF) {
+                rowWidth++;
+            }
+            if (rowWidth > 0) {
+                this->addRun(rowX, rowY, 0xFF, rowWidth);
+            }
+            if (rightAlpha > 0 && rightAlpha < 255) {
+                this->addRun(rowX + rowWidth, rowY, rightAlpha, 1);
+            }
 
-            y -= fBounds.fTop;
-            SkASSERT(y == fCurrRow->fY);
-            fCurrRow->fY = y + height - 1;
-        }
+            if (fCurrRow) {
+                // we assume the rect must be all we'll see for these scanlines
+                // so we ensure our row goes all the way to our right
+                this->flushRowH(fCurrRow);
+            }
+        });
     }
 
     bool finish(SkAAClip* target) {
@@ -1450,6 +1521,35 @@ bool SkAAClip::op(const SkAAClip& other, SkClipOp op) {
     return builder.applyClipOp(this, other, op);
 }
 
+bool SkAAClip::op(const SkPath& path, SkClipOp op, bool doAA) {
+    AUTO_AACLIP_VALIDATE(*this);
+
+    if (this->isEmpty()) {
+        // Once the clip is empty, it cannot become un-empty.
+        return false;
+    }
+
+    if (op == SkClipOp::kDifference) {
+        SkAAClip pathClip;
+        pathClip.setPath(path, fBounds, doAA);
+        return this->op(pathClip, op);
+    }
+
+    SkIRect bounds = fBounds;
+    if (!path.isInverseFillType()) {
+        SkIRect ibounds;
+        path.getBounds().roundOut(&ibounds);
+        if (ibounds.isEmpty() || !bounds.intersect(ibounds)) {
+            return this->setEmpty();
+        }
+    }
+
+    // Rather than building a clip for the path and then intersecting it with this one, scan
+    // convert the path once, scaling its coverage by ours as it's added to the builder.
+    Builder builder(bounds, this);
+    return builder.blitPath(this, path, doAA);
+}
+
 bool SkAAClip::op(const SkIRect& rect, SkClipOp op) {
     // It can be expensive to build a local aaclip before applying the op, so
     // we first see if we can restrict the bounds of new rect to our current
@@ -1504,11 +1604,7 @@ bool SkAAClip::op(const SkRect& rect, SkClipOp op, bool doAA) {
             // for AA edges).
             return this->setPath(SkPath::Rect(rect), pixelBounds, /*doAA=*/true);
         } else {
-            SkAAClip rectClip;
-            rectClip.setPath(SkPath::Rect(rect),
-                             op == SkClipOp::kDifference ? fBounds : pixelBounds,
-                             /*doAA=*/true);
-            return this->op(rectClip, op);
+            return this->op(SkPath::Rect(rect), op, /*doAA=*/true);
         }
     }
 }
@@ -39,6 +39,7 @@ public:
     bool op(const SkIRect&, SkClipOp);
     bool op(const SkRect&, SkClipOp, bool doAA);
     bool op(const SkAAClip&, SkClipOp);
+    bool op(const SkPath&, SkClipOp, bool doAA);
 
     bool translate(int dx, int dy, SkAAClip* dst) const;
 
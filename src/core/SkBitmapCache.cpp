@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkImage.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkPixelRef.h"
 #include "include/core/SkRect.h"
 #include "src/core/SkBitmapCache.h"
@@ -40,12 +41,13 @@ SkBitmapCacheDesc SkBitmapCacheDesc::Make(const SkImage* image) {
 
 namespace {
 static unsigned gBitmapKeyNamespaceLabel;
+static unsigned gScaledBitmapKeyNamespaceLabel;
 
 struct BitmapKey : public SkResourceCache::Key {
 public:
-    BitmapKey(const SkBitmapCacheDesc& desc) : fDesc(desc) {
-        this->init(&gBitmapKeyNamespaceLabel, SkMakeResourceCacheSharedIDForBitmap(fDesc.fImageID),
-                   sizeof(fDesc));
+    BitmapKey(const SkBitmapCacheDesc& desc, bool scaled = false) : fDesc(desc) {
+        this->init(scaled ? &gScaledBitmapKeyNamespaceLabel : &gBitmapKeyNamespaceLabel,
+                   SkMakeResourceCacheSharedIDForBitmap(fDesc.fImageID), sizeof(fDesc));
     }
 
     const SkBitmapCacheDesc fDesc;
@@ -62,9 +64,9 @@ void SkBitmapCache_setImmutableWithID(SkPixelRef* pr, uint32_t id) {
 
 class SkBitmapCache::Rec : public SkResourceCache::Rec {
 public:
-    Rec(const SkBitmapCacheDesc& desc, const SkImageInfo& info, size_t rowBytes,
+    Rec(const BitmapKey& key, const SkImageInfo& info, size_t rowBytes,
         std::unique_ptr<SkDiscardableMemory> dm, void* block)
-        : fKey(desc)
+        : fKey(key)
         , fDM(std::move(dm))
         , fMalloc(block)
         , fInfo(info)
@@ -173,12 +175,8 @@ private:
 
 void SkBitmapCache::PrivateDeleteRec(Rec* rec) { delete rec; }
 
-SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const SkImageInfo& info,
-                                           SkPixmap* pmap) {
-    // Ensure that the info matches the subset (i.e. the subset is the entire image)
-    SkASSERT(info.width() == desc.fSubset.width());
-    SkASSERT(info.height() == desc.fSubset.height());
-
+static SkBitmapCache::RecPtr alloc_rec(const BitmapKey& key, const SkImageInfo& info,
+                                      SkPixmap* pmap) {
     const size_t rb = info.minRowBytes();
     size_t size = info.computeByteSize(rb);
     if (SkImageInfo::ByteSizeOverflowed(size)) {
@@ -198,7 +196,22 @@ SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const
         return nullptr;
     }
     *pmap = SkPixmap(info, dm ? dm->data() : block, rb);
-    return RecPtr(new Rec(desc, info, rb, std::move(dm), block));
+    return SkBitmapCache::RecPtr(new SkBitmapCache::Rec(key, info, rb, std::move(dm), block));
+}
+
+SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const SkImageInfo& info,
+                                           SkPixmap* pmap) {
+    // Ensure that the info matches the subset (i.e. the subset is the entire image)
+    SkASSERT(info.width() == desc.fSubset.width());
+    SkASSERT(info.height() == desc.fSubset.height());
+    return alloc_rec(BitmapKey(desc), info, pmap);
+}
+
+SkBitmapCache::RecPtr SkBitmapCache::AllocScaled(const SkBitmapCacheDesc& desc,
+                                                 const SkImageInfo& info, SkPixmap* pmap) {
+    SkASSERT(info.width() <= desc.fSubset.width());
+    SkASSERT(info.height() <= desc.fSubset.height());
+    return alloc_rec(BitmapKey(desc, /*scaled=*/true), info, pmap);
 }
 
 void SkBitmapCache::Add(RecPtr rec, SkBitmap* bitmap) {
@@ -210,6 +223,47 @@ bool SkBitmapCache::Find(const SkBitmapCacheDesc& desc, SkBitmap* result) {
     return SkResourceCache::Find(BitmapKey(desc), SkBitmapCache::Rec::Finder, result);
 }
 
+bool SkBitmapCache::FindScaled(const SkBitmapCacheDesc& desc, SkBitmap* result) {
+    desc.validate();
+    return SkResourceCache::Find(BitmapKey(desc, /*scaled=*/true), SkBitmapCache::Rec::Finder,
+                                 result);
+}
+
+bool SkFindPrescaledBitmap(const SkImage_Base* image, const SkMatrix& deviceToImage,
+                           SkBitmap* result) {
+    if (!image->isLazyGenerated()) {
+        return false;
+    }
+    SkSize scale;   // image pixels per device pixel
+    if (!deviceToImage.decomposeScale(&scale, nullptr)) {
+        return false;
+    }
+
+    auto desc = SkBitmapCacheDesc::Make(image);
+    SkBitmap bitmap;
+    if (!SkBitmapCache::FindScaled(desc, &bitmap)) {
+        return false;
+    }
+
+    // Prescaled pixels per device pixel. Below 1 the draw would lose detail; at 2 or more it would
+    // need mipmaps that the prescaled pixels don't have, so the full decode serves it better.
+    // The slop covers codecs rounding their reduced sizes.
+    const float rx = bitmap.width()  * scale.width()  / image->width(),
+                ry = bitmap.height() * scale.height() / image->height();
+    constexpr float kSlop = 1.0f / 64;
+    if (rx < 1 - kSlop || ry < 1 - kSlop || rx >= 2 || ry >= 2) {
+        return false;
+    }
+
+    // Prefer the full resolution pixels when something has already decoded them.
+    SkBitmap full;
+    if (SkBitmapCache::Find(desc, &full)) {
+        return false;
+    }
+    *result = std::move(bitmap);
+    return true;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////
 
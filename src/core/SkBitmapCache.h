@@ -15,6 +15,7 @@ class SkBitmap;
 class SkImage;
 class SkImage_Base;
 struct SkImageInfo;
+class SkMatrix;
 class SkMipmap;
 class SkPixmap;
 class SkResourceCache;
@@ -52,10 +53,24 @@ public:
     static RecPtr Alloc(const SkBitmapCacheDesc&, const SkImageInfo&, SkPixmap*);
     static void Add(RecPtr, SkBitmap*);
 
+    /**
+     *  Scaled entries hold the desc's pixels decoded at reduced dimensions, ahead of a downscaled
+     *  draw (see SkImageDecodeScheduler). They live beside the full size entries, one per desc.
+     */
+    static bool FindScaled(const SkBitmapCacheDesc&, SkBitmap* result);
+    static RecPtr AllocScaled(const SkBitmapCacheDesc&, const SkImageInfo&, SkPixmap*);
+
 private:
     static void PrivateDeleteRec(Rec*);
 };
 
+/**
+ *  Finds a scaled entry for the lazy image that can stand in for its full decode when drawing with
+ *  'deviceToImage': it has enough resolution for the draw without needing mipmaps, and the full
+ *  size pixels aren't cached already.
+ */
+bool SkFindPrescaledBitmap(const SkImage_Base*, const SkMatrix& deviceToImage, SkBitmap* result);
+
 class SkMipmapCache {
 public:
     static const SkMipmap* FindAndRef(const SkBitmapCacheDesc&,
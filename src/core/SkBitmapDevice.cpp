@@ -17,6 +17,7 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkVertices.h"
+#include "src/core/SkBitmapCache.h"
 #include "src/core/SkDraw.h"
 #include "src/core/SkGlyphRun.h"
 #include "src/core/SkImageFilterCache.h"
@@ -69,6 +70,7 @@ public:
 
     SkDrawTiler(SkBitmapDevice* dev, const SkRect* bounds) : fDevice(dev) {
         fDone = false;
+        fDraw.fPathExecutor = dev->fPathExecutor;
 
         // we need fDst to be set, and if we're actually drawing, to dirty the genID
         if (!dev->accessPixels(&fRootPixmap)) {
@@ -194,6 +196,7 @@ public:
         }
         fMatrixProvider = dev;
         fRC = &dev->fRCStack.rc();
+        fPathExecutor = dev->fPathExecutor;
     }
 };
 
@@ -296,7 +299,14 @@ SkBaseDevice* SkBitmapDevice::onCreateDevice(const CreateInfo& cinfo, const SkPa
         info = info.makeColorType(kN32_SkColorType);
     }
 
-    return SkBitmapDevice::Create(info, surfaceProps, cinfo.fAllocator);
+    SkBitmapDevice* device = SkBitmapDevice::Create(info, surfaceProps, cinfo.fAllocator);
+    if (device) {
+        // Paths drawn into layers are also split into bands, and nested layers' filters also
+        // run on the executor.
+        device->setPathExecutor(fPathExecutor);
+        device->setImageFilterExecutor(fImageFilterExecutor);
+    }
+    return device;
 }
 
 bool SkBitmapDevice::onAccessPixels(SkPixmap* pmap) {
@@ -412,10 +422,26 @@ void SkBitmapDevice::drawImageRect(const SkImage* image, const SkRect* src, cons
     SkASSERT(dst.isSorted());
 
     SkBitmap bitmap;
-    // TODO: Elevate direct context requirement to public API and remove cheat.
-    auto dContext = as_IB(image)->directContext();
-    if (!as_IB(image)->getROPixels(dContext, &bitmap)) {
-        return;
+    SkRect scaledSrc;
+    SkMatrix deviceToImage;
+    if (image->isLazyGenerated() &&
+        SkMatrix::Concat(this->localToDevice(),
+                         SkMatrix::RectToRect(src ? *src : SkRect::Make(image->bounds()), dst))
+                .invert(&deviceToImage) &&
+        SkFindPrescaledBitmap(as_IB(image), deviceToImage, &bitmap)) {
+        // The prescaled pixels hold the whole image at a smaller size, so scale src to match.
+        if (src) {
+            scaledSrc = SkMatrix::Scale(SkIntToScalar(bitmap.width())  / image->width(),
+                                        SkIntToScalar(bitmap.height()) / image->height())
+                                .mapRect(*src);
+            src = &scaledSrc;
+        }
+    } else {
+        // TODO: Elevate direct context requirement to public API and remove cheat.
+        auto dContext = as_IB(image)->directContext();
+        if (!as_IB(image)->getROPixels(dContext, &bitmap)) {
+            return;
+        }
     }
 
     SkRect      bitmapBounds, tmpSrc, tmpDst;
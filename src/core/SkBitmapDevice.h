@@ -20,6 +20,7 @@
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRasterClipStack.h"
 
+class SkExecutor;
 class SkImageFilterCache;
 class SkMatrix;
 class SkPaint;
@@ -60,6 +61,19 @@ public:
     static SkBitmapDevice* Create(const SkImageInfo&, const SkSurfaceProps&,
                                   SkRasterHandleAllocator* = nullptr);
 
+    /**
+     *  If set, very large anti-aliased path fills are scan converted in horizontal bands, which
+     *  run concurrently on the executor. The executor must outlive the device.
+     */
+    void setPathExecutor(SkExecutor* executor) { fPathExecutor = executor; }
+
+    /**
+     *  If set, image filters applied to layers drawn into this device evaluate independent inputs,
+     *  and bands of their raster passes, concurrently on the executor. The executor must outlive
+     *  the device.
+     */
+    void setImageFilterExecutor(SkExecutor* executor) { fImageFilterExecutor = executor; }
+
 protected:
     void* getRasterHandle() const override { return fRasterHandle; }
 
@@ -149,9 +163,12 @@ private:
     sk_sp<SkSurface> makeSurface(const SkImageInfo&, const SkSurfaceProps&) override;
 
     SkImageFilterCache* getImageFilterCache() override;
+    SkExecutor* getImageFilterExecutor() override { return fImageFilterExecutor; }
 
     SkBitmap    fBitmap;
     void*       fRasterHandle = nullptr;
+    SkExecutor* fPathExecutor = nullptr;
+    SkExecutor* fImageFilterExecutor = nullptr;
     SkRasterClipStack  fRCStack;
     SkGlyphRunListPainter fGlyphPainter;
 
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkColorXformPlan.h"
+
+#include "include/core/SkExecutor.h"
+#include "include/private/SkTemplates.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+
+// Bands smaller than this aren't worth handing to another thread.
+static constexpr int kMinPixelsPerBand = 64 * 1024;
+
+static size_t bytes_per_pixel(skcms_PixelFormat format) {
+    // Each format is followed by its BGR-ordered twin, which is the same size.
+    switch (format >> 1) {
+        case skcms_PixelFormat_A_8             >> 1:
+        case skcms_PixelFormat_G_8             >> 1:
+        case skcms_PixelFormat_RGBA_8888_Palette8 >> 1: return 1;
+        case skcms_PixelFormat_RGB_565         >> 1:
+        case skcms_PixelFormat_ABGR_4444       >> 1: return 2;
+        case skcms_PixelFormat_RGB_888         >> 1: return 3;
+        case skcms_PixelFormat_RGBA_8888       >> 1:
+        case skcms_PixelFormat_RGBA_8888_sRGB  >> 1:
+        case skcms_PixelFormat_RGBA_1010102    >> 1: return 4;
+        case skcms_PixelFormat_RGB_161616LE    >> 1:
+        case skcms_PixelFormat_RGB_161616BE    >> 1:
+        case skcms_PixelFormat_RGB_hhh_Norm    >> 1:
+        case skcms_PixelFormat_RGB_hhh         >> 1: return 6;
+        case skcms_PixelFormat_RGBA_16161616LE >> 1:
+        case skcms_PixelFormat_RGBA_16161616BE >> 1:
+        case skcms_PixelFormat_RGBA_hhhh_Norm  >> 1:
+        case skcms_PixelFormat_RGBA_hhhh       >> 1: return 8;
+        case skcms_PixelFormat_RGB_fff         >> 1: return 12;
+        case skcms_PixelFormat_RGBA_ffff       >> 1: return 16;
+    }
+    SkUNREACHABLE;
+}
+
+SkColorXformPlan::SkColorXformPlan(skcms_PixelFormat srcFormat, skcms_AlphaFormat srcAlpha,
+                                   const skcms_ICCProfile* srcProfile,
+                                   skcms_PixelFormat dstFormat, skcms_AlphaFormat dstAlpha,
+                                   const skcms_ICCProfile* dstProfile)
+        : fSrcFormat(srcFormat)
+        , fSrcAlpha(srcAlpha)
+        , fSrcProfile(srcProfile ? srcProfile : skcms_sRGB_profile())
+        , fDstFormat(dstFormat)
+        , fDstAlpha(dstAlpha)
+        , fDstProfile(dstProfile ? dstProfile : skcms_sRGB_profile())
+        , fSrcBytesPerPixel(bytes_per_pixel(srcFormat))
+        , fDstBytesPerPixel(bytes_per_pixel(dstFormat)) {
+    SkASSERT((srcFormat >> 1) != (skcms_PixelFormat_RGBA_8888_Palette8 >> 1));
+}
+
+bool SkColorXformPlan::apply(void* dst, const void* src, int count) const {
+    return skcms_Transform(src, fSrcFormat, fSrcAlpha, fSrcProfile,
+                           dst, fDstFormat, fDstAlpha, fDstProfile, count);
+}
+
+bool SkColorXformPlan::apply(void* dst, size_t dstRowBytes, const void* src, size_t srcRowBytes,
+                             int width, int height, SkExecutor* executor) const {
+    if (width <= 0 || height <= 0) {
+        return true;
+    }
+
+    const int bands = (int)std::min<int64_t>(height, (int64_t)width * height / kMinPixelsPerBand);
+    if (!executor || bands <= 1) {
+        return this->applyRows(dst, dstRowBytes, src, srcRowBytes, width, height);
+    }
+
+    const int rowsPerBand = (height + bands - 1) / bands;
+    std::atomic<bool> ok{true};
+    SkTaskGroup tasks(*executor);
+    tasks.batch(bands, [&](int band) {
+        const int top  = band * rowsPerBand,
+                  rows = std::min(rowsPerBand, height - top);
+        if (rows > 0 &&
+            !this->applyRows(SkTAddOffset<void>(dst, top * dstRowBytes), dstRowBytes,
+                             SkTAddOffset<const void>(src, top * srcRowBytes), srcRowBytes,
+                             width, rows)) {
+            ok = false;
+        }
+    });
+    tasks.wait();
+    return ok;
+}
+
+bool SkColorXformPlan::applyRows(void* dst, size_t dstRowBytes,
+                                 const void* src, size_t srcRowBytes,
+                                 int width, int height) const {
+    // Rows with nothing between them can go to skcms as one run, as long as it's not too big.
+    if (srcRowBytes == width * fSrcBytesPerPixel &&
+        dstRowBytes == width * fDstBytesPerPixel &&
+        height * std::max(srcRowBytes, dstRowBytes) <= INT_MAX) {
+        return this->apply(dst, src, width * height);
+    }
+
+    for (int y = 0; y < height; y++) {
+        if (!this->apply(dst, src, width)) {
+            return false;
+        }
+        dst = SkTAddOffset<void>(dst, dstRowBytes);
+        src = SkTAddOffset<const void>(src, srcRowBytes);
+    }
+    return true;
+}
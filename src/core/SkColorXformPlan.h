@@ -0,0 +1,67 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkColorXformPlan_DEFINED
+#define SkColorXformPlan_DEFINED
+
+#include "include/core/SkTypes.h"
+#include "include/third_party/skcms/skcms.h"
+
+class SkExecutor;
+
+/**
+ *  An skcms transform between one pixel format and profile and another, set up once and then
+ *  applied to as many pixels as needed.
+ *
+ *  skcms_Transform() works out the steps of a transform from scratch on each call, so transforming
+ *  many short runs of pixels (e.g. a row at a time) repeats that work for each run.  The plan
+ *  transforms as many rows per skcms call as it can, and splits large blocks of rows into bands
+ *  that transform in parallel.
+ */
+class SkColorXformPlan {
+public:
+    /**
+     *  Null profiles mean sRGB.  Non-null profiles must outlive the plan.  Palette formats are
+     *  not supported.
+     */
+    SkColorXformPlan(skcms_PixelFormat srcFormat, skcms_AlphaFormat srcAlpha,
+                     const skcms_ICCProfile* srcProfile,
+                     skcms_PixelFormat dstFormat, skcms_AlphaFormat dstAlpha,
+                     const skcms_ICCProfile* dstProfile);
+
+    /**
+     *  Transforms 'count' pixels from src to dst.  dst may equal src if both formats are the
+     *  same size.  Returns false if skcms can't do this transform.
+     */
+    bool apply(void* dst, const void* src, int count) const;
+
+    /**
+     *  Transforms 'height' rows of 'width' pixels.  If 'executor' is not null, blocks large
+     *  enough to be worth it are split into bands of rows that run on it, and this waits for all
+     *  of them to finish.  Otherwise the whole block is transformed on this thread.  As above,
+     *  dst may equal src (with dstRowBytes equal to srcRowBytes) if both formats are the same
+     *  size.
+     */
+    bool apply(void* dst, size_t dstRowBytes, const void* src, size_t srcRowBytes,
+               int width, int height, SkExecutor* executor = nullptr) const;
+
+private:
+    // Transforms the rows in a single band, on this thread.
+    bool applyRows(void* dst, size_t dstRowBytes, const void* src, size_t srcRowBytes,
+                   int width, int height) const;
+
+    skcms_PixelFormat       fSrcFormat;
+    skcms_AlphaFormat       fSrcAlpha;
+    const skcms_ICCProfile* fSrcProfile;
+    skcms_PixelFormat       fDstFormat;
+    skcms_AlphaFormat       fDstAlpha;
+    const skcms_ICCProfile* fDstProfile;
+    size_t                  fSrcBytesPerPixel;
+    size_t                  fDstBytesPerPixel;
+};
+
+#endif
@@ -24,6 +24,7 @@
 
 class SkBitmap;
 struct SkDrawShadowRec;
+class SkExecutor;
 class SkGlyphRun;
 class SkGlyphRunList;
 class SkImageFilter;
@@ -446,6 +447,9 @@ private:
 
     virtual SkImageFilterCache* getImageFilterCache() { return nullptr; }
 
+    // The executor that image filters drawn by drawFilteredImage() run on, if any.
+    virtual SkExecutor* getImageFilterExecutor() { return nullptr; }
+
     friend class SkNoPixelsDevice;
     friend class SkBitmapDevice;
     void privateResize(int w, int h) {
@@ -30,6 +30,7 @@
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMatrixUtils.h"
 #include "src/core/SkPathEffectBase.h"
+#include "src/core/SkPathMaskCache.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRectPriv.h"
@@ -817,6 +818,18 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
     if (SkPathPriv::TooBigForMath(devPath)) {
         return;
     }
+
+    if (fPathExecutor && doFill && paint.isAntiAlias() && !customBlitter &&
+        !paint.getMaskFilter()) {
+        auto makeBlitter = [&](SkArenaAlloc* alloc) {
+            return SkBlitter::Choose(fDst, *fMatrixProvider, paint, alloc, drawCoverage,
+                                     fRC->clipShader());
+        };
+        if (SkScan::AntiFillPathBands(devPath, *fRC, fPathExecutor, makeBlitter)) {
+            return;
+        }
+    }
+
     SkBlitter* blitter = nullptr;
     SkAutoBlitterChoose blitterStorage;
     if (nullptr == customBlitter) {
@@ -872,6 +885,66 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
     proc(devPath, *fRC, blitter);
 }
 
+static void blit_coverage_mask(const SkDraw& draw, const SkMask& mask, const SkPaint& paint) {
+    SkAutoBlitterChoose blitterChooser(draw, nullptr, paint);
+    SkAAClipBlitterWrapper wrapper(*draw.fRC, blitterChooser.get());
+    SkBlitter* blitter = wrapper.getBlitter();
+
+    SkRegion::Cliperator clipper(wrapper.getRgn(), mask.fBounds);
+    while (!clipper.done()) {
+        blitter->blitMask(mask, clipper.rect());
+        clipper.next();
+    }
+}
+
+// Renders the coverage of fillPath, the result of stroking the path described by desc, at the
+// subpixel phase SkPathMaskCache uses. On success, returns the data holding the mask's pixels, and
+// sets mask, whose bounds are in device space. The data comes from cache if the mask is going to
+// be added to it, and from the heap otherwise, so that uncached draws don't lock the cache.
+static SkCachedData* render_path_mask(const SkPath& fillPath, const SkPathMaskCache::Desc& desc,
+                                      bool antiAlias, bool forCache, SkResourceCache* cache,
+                                      SkMask* mask) {
+    SkPath devPath;
+    fillPath.transform(desc.maskMatrix(), &devPath);
+    devPath.setIsVolatile(true);
+
+    SkIRect bounds = devPath.getBounds().roundOut();
+    if (bounds.isEmpty() ||
+        (int64_t)bounds.width() * bounds.height() > SkPathMaskCache::kMaxMaskArea) {
+        return nullptr;
+    }
+
+    mask->fBounds = bounds;
+    mask->fFormat = SkMask::kA8_Format;
+    mask->fRowBytes = bounds.width();
+    const size_t size = mask->computeImageSize();
+    SkCachedData* data = !forCache ? new SkCachedData(sk_malloc_throw(size), size)
+                       : cache     ? cache->newCachedData(size)
+                                   : SkResourceCache::NewCachedData(size);
+    if (!data) {
+        return nullptr;
+    }
+    mask->fImage = (uint8_t*)data->writable_data();
+    sk_bzero(mask->fImage, data->size());
+
+    SkDraw draw;
+    if (!draw.fDst.reset(*mask)) {
+        data->unref();
+        return nullptr;
+    }
+    SkRasterClip clip(SkIRect::MakeWH(bounds.width(), bounds.height()));
+    SkMatrixProvider matrixProvider(SkMatrix::Translate(-SkIntToScalar(bounds.fLeft),
+                                                    -SkIntToScalar(bounds.fTop)));
+    draw.fRC             = &clip;
+    draw.fMatrixProvider = &matrixProvider;
+    SkPaint paint;
+    paint.setAntiAlias(antiAlias);
+    draw.drawPath(devPath, paint);
+
+    mask->fBounds.offset(desc.fOffset);
+    return data;
+}
+
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable,
                       bool drawCoverage, SkBlitter* customBlitter) const {
@@ -932,6 +1005,27 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         }
     }
 
+    // Paths which are drawn repeatedly are blitted from a cached coverage mask. Every draw that
+    // could use the cache goes through a mask, so that it looks the same whether or not it hits.
+    SkPathMaskCache::Desc maskDesc;
+    bool renderMask = false,
+         cacheMask  = false;
+    if (!drawCoverage && !customBlitter && pathPtr == &origSrcPath &&
+        maskDesc.init(origSrcPath, *paint, matrixProvider->localToDevice())) {
+        renderMask = true;
+        // A path drawn for the first time skips the cache; it's most likely only drawn once.
+        if (SkPathMaskCache::MarkDrawn(maskDesc, fPathMaskDrawnSet)) {
+            SkMask mask;
+            if (SkCachedData* data = SkPathMaskCache::FindAndRef(maskDesc, &mask,
+                                                                 fPathMaskCache)) {
+                blit_coverage_mask(*this, mask, *paint);
+                data->unref();
+                return;
+            }
+            cacheMask = true;
+        }
+    }
+
     if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
         SkRect cullRect;
         const SkRect* cullRectPtr = nullptr;
@@ -943,6 +1037,19 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         pathPtr = tmpPath;
     }
 
+    if (renderMask && doFill) {
+        SkMask mask;
+        if (SkCachedData* data = render_path_mask(*pathPtr, maskDesc, paint->isAntiAlias(),
+                                                  cacheMask, fPathMaskCache, &mask)) {
+            if (cacheMask) {
+                SkPathMaskCache::Add(maskDesc, origSrcPath, mask, data, fPathMaskCache);
+            }
+            blit_coverage_mask(*this, mask, *paint);
+            data->unref();
+            return;
+        }
+    }
+
     // avoid possibly allocating a new path in transform if we can
     SkPath* devPathPtr = pathIsMutable ? pathPtr : tmpPath;
 
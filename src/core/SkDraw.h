@@ -20,12 +20,15 @@
 class SkBitmap;
 class SkClipStack;
 class SkBaseDevice;
+class SkExecutor;
 class SkBlitter;
 class SkMatrix;
 class SkMatrixProvider;
 class SkPath;
+class SkPathMaskDrawnSet;
 class SkRegion;
 class SkRasterClip;
+class SkResourceCache;
 struct SkRect;
 class SkRRect;
 class SkVertices;
@@ -160,6 +163,11 @@ public:
     SkPixmap                fDst;
     const SkMatrixProvider* fMatrixProvider{nullptr};  // required
     const SkRasterClip*     fRC{nullptr};              // required
+    // If set, large anti-aliased path fills are scan converted in bands on this executor.
+    SkExecutor*             fPathExecutor{nullptr};
+    // If set, path masks are cached and draws remembered here, rather than globally (for tests).
+    SkResourceCache*        fPathMaskCache{nullptr};
+    SkPathMaskDrawnSet*     fPathMaskDrawnSet{nullptr};
 
 #ifdef SK_DEBUG
     void validate() const;
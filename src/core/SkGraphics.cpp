@@ -22,6 +22,7 @@
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkRuntimeEffectPriv.h"
 #include "src/core/SkScalerContext.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkTSearch.h"
@@ -120,6 +121,22 @@ int SkGraphics::GetFontCacheCountUsed() {
     return SkStrikeCache::GlobalStrikeCache()->getCacheCountUsed();
 }
 
+int SkGraphics::GetRuntimeEffectCacheCountLimit() {
+#ifdef SK_ENABLE_SKSL
+    return SkRuntimeEffectPriv::GetCacheCountLimit();
+#else
+    return 0;
+#endif
+}
+
+int SkGraphics::SetRuntimeEffectCacheCountLimit(int count) {
+#ifdef SK_ENABLE_SKSL
+    return SkRuntimeEffectPriv::SetCacheCountLimit(count);
+#else
+    return 0;
+#endif
+}
+
 void SkGraphics::PurgeFontCache() {
     SkStrikeCache::GlobalStrikeCache()->purgeAll();
     SkTypefaceCache::PurgeAll();
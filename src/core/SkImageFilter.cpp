@@ -120,6 +120,19 @@ bool SkImageFilter_Base::affectsTransparentBlack() const {
     return false;
 }
 
+bool SkImageFilter_Base::canFilterTiles() const {
+    if (!this->onCanFilterTiles()) {
+        return false;
+    }
+    for (int i = 0; i < this->countInputs(); i++) {
+        const SkImageFilter* input = this->getInput(i);
+        if (input && !as_IFB(input)->canFilterTiles()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool SkImageFilter::asAColorFilter(SkColorFilter** filterPtr) const {
     SkASSERT(nullptr != filterPtr);
     if (!this->isColorFilterNode(filterPtr)) {
@@ -231,12 +244,7 @@ skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context)
         return result;
     }
 
-    uint32_t srcGenID = fUsesSrcInput ? context.sourceImage()->uniqueID() : 0;
-    const SkIRect srcSubset = fUsesSrcInput ? context.sourceImage()->subset()
-                                            : SkIRect::MakeWH(0, 0);
-
-    SkImageFilterCacheKey key(fUniqueID, context.mapping().layerMatrix(), context.clipBounds(),
-                              srcGenID, srcSubset);
+    SkImageFilterCacheKey key = this->cacheKey(context, context.clipBounds());
     if (context.cache() && context.cache()->get(key, &result)) {
         return result;
     }
@@ -254,6 +262,186 @@ skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context)
     return result;
 }
 
+// Tiles are big enough that the outset a blur or morphology needs around the tiles filtered in one
+// piece stays small compared to them, and small enough that scrolling exposes few new ones.
+static constexpr int kFilterTileSize = 256;
+// Desired outputs which span fewer or more tiles than this are filtered in one piece.
+static constexpr int kMinFilterTiles = 4;
+static constexpr int kMaxFilterTiles = 1024;
+// Translations beyond this can't be split into an integer origin and a fraction, and tiles are only
+// made within this distance of the layer's origin, so their bounds don't overflow.
+static constexpr int kMaxFilterCoord = 1 << 24;
+
+static int floor_div(int value, int divisor) {
+    return value >= 0 ? value / divisor : -((divisor - 1 - value) / divisor);
+}
+
+skif::FilterResult SkImageFilter_Base::filterImageTiled(const skif::Context& context) const {
+    if (!context.isValid() || !context.cache() || context.gpuBacked() || !this->canFilterTiles()) {
+        return this->filterImage(context);
+    }
+
+    // The source image is in the same layer space as the output, so tiles of filters that read it
+    // stay aligned with its content as long as the layer matrix doesn't change. Other filters only
+    // depend on the layer matrix, so they can be evaluated relative to its integer translation.
+    skif::Context ctx = context;
+    skif::LayerSpace<SkIPoint> origin({0, 0});
+    const SkMatrix& layerMatrix = context.mapping().layerMatrix();
+    if (!fUsesSrcInput && !layerMatrix.hasPerspective() &&
+        SkScalarAbs(layerMatrix.getTranslateX()) < kMaxFilterCoord &&
+        SkScalarAbs(layerMatrix.getTranslateY()) < kMaxFilterCoord) {
+        origin = skif::LayerSpace<SkIPoint>({SkScalarFloorToInt(layerMatrix.getTranslateX()),
+                                             SkScalarFloorToInt(layerMatrix.getTranslateY())});
+        skif::Mapping mapping = context.mapping();
+        mapping.applyOrigin(origin);
+        ctx = ctx.withNewMapping(mapping).withNewDesiredOutput(skif::LayerSpace<SkIRect>(
+                SkIRect(context.desiredOutput()).makeOffset(-origin.x(), -origin.y())));
+    }
+
+    const SkIRect desired = SkIRect(ctx.desiredOutput());
+    if (!SkIRect::MakeLTRB(-kMaxFilterCoord, -kMaxFilterCoord,
+                           kMaxFilterCoord, kMaxFilterCoord).contains(desired)) {
+        return this->filterImage(context);
+    }
+    const SkIRect tiles = SkIRect::MakeLTRB(floor_div(desired.fLeft, kFilterTileSize),
+                                            floor_div(desired.fTop, kFilterTileSize),
+                                            floor_div(desired.fRight - 1, kFilterTileSize) + 1,
+                                            floor_div(desired.fBottom - 1, kFilterTileSize) + 1);
+    const int64_t tileCount64 = (int64_t)tiles.width() * tiles.height();
+    if (desired.isEmpty() || tileCount64 < kMinFilterTiles || tileCount64 > kMaxFilterTiles) {
+        return this->filterImage(context);
+    }
+
+    // Tiles overhang the desired output, so they only pay off once the output moves. Until the
+    // same graph has been filtered with the same matrix and source for another desired output,
+    // it is filtered in one piece and just leaves a marker in the cache.
+    SkImageFilterCache* cache = ctx.cache();
+    skif::FilterResult unused;
+    if (!cache->get(this->cacheKey(ctx, SkIRect::MakeEmpty()), &unused)) {
+        cache->set(this->cacheKey(ctx, SkIRect::MakeEmpty()), this, skif::FilterResult());
+        return this->filterImage(context);
+    }
+
+    // Every tile is filtered in full, rather than clipped to the desired output, so that its
+    // cache key doesn't change when the desired output moves.
+    const int tileCount = SkToInt(tileCount64);
+    auto tileBounds = [&](int i) {
+        return SkIRect::MakeXYWH((tiles.fLeft + i % tiles.width()) * kFilterTileSize,
+                                 (tiles.fTop + i / tiles.width()) * kFilterTileSize,
+                                 kFilterTileSize, kFilterTileSize);
+    };
+    SkAutoTArray<skif::FilterResult> results(tileCount);
+    SkAutoTArray<bool> cached(tileCount);
+    for (int i = 0; i < tileCount; ++i) {
+        cached[i] = cache->get(this->cacheKey(ctx, tileBounds(i)), &results[i]);
+    }
+
+    // Runs of adjacent tiles in a row that aren't cached are filtered in one piece, so that they
+    // share the outset the filters need around them (e.g. a row that scrolled into view), and then
+    // cut back into tiles.
+    SkTArray<SkIPoint> runs;  // first tile, tile count
+    for (int i = 0; i < tileCount; ++i) {
+        if (!cached[i]) {
+            if (!runs.empty() && i % tiles.width() && runs.back().fX + runs.back().fY == i) {
+                runs.back().fY++;
+            } else {
+                runs.push_back({i, 1});
+            }
+        }
+    }
+    auto filterRun = [&](int r) {
+        const SkIPoint& run = runs[r];
+        SkIRect runBounds = tileBounds(run.fX);
+        runBounds.fRight += (run.fY - 1) * kFilterTileSize;
+        skif::FilterResult result = this->onFilterImage(
+                ctx.withNewDesiredOutput(skif::LayerSpace<SkIRect>(runBounds)));
+        for (int i = run.fX; i < run.fX + run.fY; ++i) {
+            if (const SkSpecialImage* image = result.image()) {
+                SkIRect subset = tileBounds(i);
+                if (subset.intersect(SkIRect::MakeXYWH(result.layerOrigin().x(),
+                                                       result.layerOrigin().y(),
+                                                       image->width(), image->height()))) {
+                    // Each tile is copied out, rather than cached as a subset, so that it doesn't
+                    // keep the rest of the run's pixels alive, nor get charged for them by the
+                    // cache (a subset reports the size of its whole backing image).
+                    sk_sp<SkSpecialImage> tile;
+                    if (sk_sp<SkSpecialSurface> surf = ctx.makeSurface(subset.size())) {
+                        SkPaint paint;
+                        paint.setBlendMode(SkBlendMode::kSrc);
+                        image->draw(surf->getCanvas(),
+                                    SkIntToScalar(result.layerOrigin().x() - subset.fLeft),
+                                    SkIntToScalar(result.layerOrigin().y() - subset.fTop),
+                                    SkSamplingOptions(), &paint);
+                        tile = surf->makeImageSnapshot();
+                    } else {
+                        tile = image->makeSubset(subset.makeOffset(-result.layerOrigin().x(),
+                                                                   -result.layerOrigin().y()));
+                    }
+                    results[i] = skif::FilterResult(std::move(tile),
+                                                    skif::LayerSpace<SkIPoint>(subset.topLeft()));
+                }
+            }
+            cache->set(this->cacheKey(ctx, tileBounds(i)), this, results[i]);
+        }
+    };
+    ctx.forEach(runs.count(), filterRun);
+
+    // Each tile's result is clipped to the desired output, and the pieces are stitched back
+    // together.
+    SkIRect resultBounds = SkIRect::MakeEmpty();
+    SkAutoTArray<SkIRect> clips(tileCount);
+    for (int i = 0; i < tileCount; ++i) {
+        clips[i] = SkIRect::MakeEmpty();
+        if (const SkSpecialImage* image = results[i].image()) {
+            SkIRect bounds = SkIRect::MakeXYWH(results[i].layerOrigin().x(),
+                                               results[i].layerOrigin().y(),
+                                               image->width(), image->height());
+            if (bounds.intersect(tileBounds(i)) && bounds.intersect(desired)) {
+                clips[i] = bounds;
+                resultBounds.join(bounds);
+            }
+        }
+    }
+    if (resultBounds.isEmpty()) {
+        return {};
+    }
+
+    sk_sp<SkSpecialSurface> surf(ctx.makeSurface(resultBounds.size()));
+    if (!surf) {
+        return {};
+    }
+    SkCanvas* canvas = surf->getCanvas();
+    SkASSERT(canvas);
+    canvas->clear(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    for (int i = 0; i < tileCount; ++i) {
+        if (clips[i].isEmpty()) {
+            continue;
+        }
+        canvas->save();
+        canvas->clipIRect(clips[i].makeOffset(-resultBounds.fLeft, -resultBounds.fTop));
+        results[i].image()->draw(canvas,
+                                 SkIntToScalar(results[i].layerOrigin().x() - resultBounds.fLeft),
+                                 SkIntToScalar(results[i].layerOrigin().y() - resultBounds.fTop),
+                                 SkSamplingOptions(), &paint);
+        canvas->restore();
+    }
+
+    return skif::FilterResult(surf->makeImageSnapshot(),
+                              skif::LayerSpace<SkIPoint>({resultBounds.fLeft + origin.x(),
+                                                          resultBounds.fTop + origin.y()}));
+}
+
+SkImageFilterCacheKey SkImageFilter_Base::cacheKey(const skif::Context& context,
+                                                   const SkIRect& clipBounds) const {
+    uint32_t srcGenID = fUsesSrcInput ? context.sourceImage()->uniqueID() : 0;
+    const SkIRect srcSubset = fUsesSrcInput ? context.sourceImage()->subset()
+                                            : SkIRect::MakeWH(0, 0);
+    return SkImageFilterCacheKey(fUniqueID, context.mapping().layerMatrix(), clipBounds,
+                                 srcGenID, srcSubset);
+}
+
 skif::LayerSpace<SkIRect> SkImageFilter_Base::getInputBounds(
         const skif::Mapping& mapping, const skif::DeviceSpace<SkIRect>& desiredOutput,
         const skif::ParameterSpace<SkRect>* knownContentBounds) const {
@@ -573,6 +761,39 @@ skif::FilterResult SkImageFilter_Base::filterInput(int index, const skif::Contex
     return result;
 }
 
+void SkImageFilter_Base::filterInputs(const skif::Context* const contexts[],
+                                      skif::FilterResult results[]) const {
+    int inputCount = this->countInputs();
+    // Null inputs are just the source image, so only filters are worth running concurrently.
+    const skif::Context* concurrentCtx = nullptr;
+    int filterCount = 0;
+    for (int i = 0; i < inputCount; ++i) {
+        if (this->getInput(i)) {
+            filterCount++;
+            if (!concurrentCtx && contexts[i]->executor()) {
+                concurrentCtx = contexts[i];
+            }
+        }
+    }
+    auto filter = [&](int i) { results[i] = this->filterInput(i, *contexts[i]); };
+    if (!concurrentCtx || filterCount < 2) {
+        for (int i = 0; i < inputCount; ++i) {
+            filter(i);
+        }
+        return;
+    }
+    concurrentCtx->forEach(inputCount, filter);
+}
+
+void SkImageFilter_Base::filterInputs(const skif::Context& ctx,
+                                      skif::FilterResult results[]) const {
+    SkAutoSTArray<4, const skif::Context*> contexts(this->countInputs());
+    for (int i = 0; i < contexts.count(); ++i) {
+        contexts[i] = &ctx;
+    }
+    this->filterInputs(contexts.get(), results);
+}
+
 SkImageFilter_Base::Context SkImageFilter_Base::mapContext(const Context& ctx) const {
     // We don't recurse through the child input filters because that happens automatically
     // as part of the filterImage() evaluation. In this case, we want the bounds for the
@@ -5,11 +5,16 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMatrix.h"
+#include "include/private/SkSemaphore.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkMatrixPriv.h"
 
+#include <atomic>
+#include <memory>
+
 // Both [I]Vectors and Sk[I]Sizes are transformed as non-positioned values, i.e. go through
 // mapVectors() not mapPoints().
 static SkIVector map_as_vector(int32_t x, int32_t y, const SkMatrix& matrix) {
@@ -140,6 +145,68 @@ SkSize Mapping::map<SkSize>(const SkSize& geom, const SkMatrix& matrix) {
     return SkSize::Make(v.fX, v.fY);
 }
 
+void Context::forEach(int count, const std::function<void(int)>& fn) const {
+    SkExecutor* executor = this->executor();
+    if (!executor || count < 2) {
+        for (int i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    // Indices are claimed by this thread and by helpers on the executor alike, and this thread
+    // only waits once they have all been claimed. A nested call therefore never waits on work
+    // that is still queued behind it (which SkTaskGroup::wait() relies on SkExecutor::borrow() to
+    // avoid), and when the executor has no idle threads, this thread simply does all the work.
+    // The helpers can run after this returns, so they share the state.
+    struct State {
+        const std::function<void(int)>* fFn;
+        int                             fCount;
+        std::atomic<int>                fNext{0};
+        std::atomic<int>                fRemaining;
+        SkSemaphore                     fDone;
+    };
+    auto state = std::make_shared<State>();
+    state->fFn = &fn;
+    state->fCount = count;
+    state->fRemaining = count;
+
+    auto run = [](State* s) {
+        for (int i; (i = s->fNext.fetch_add(1, std::memory_order_relaxed)) < s->fCount;) {
+            (*s->fFn)(i);
+            if (s->fRemaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                s->fDone.signal();
+            }
+        }
+    };
+    for (int i = 1; i < count; ++i) {
+        executor->add([state, run] { run(state.get()); });
+    }
+    run(state.get());
+    state->fDone.wait();
+}
+
+void Context::forEachBand(int count, int itemPixels,
+                          const std::function<void(int start, int end)>& fn) const {
+    // Bands smaller than this aren't worth handing to another thread.
+    static constexpr int kMinBandPixels = 64 * 1024;
+    static constexpr int kMaxBands = 32;
+
+    SkExecutor* executor = this->executor();
+    int64_t pixels = (int64_t)count * std::max(itemPixels, 1);
+    int bandCount = (int)std::min<int64_t>({count, pixels / kMinBandPixels, kMaxBands});
+    if (!executor || bandCount < 2) {
+        if (count > 0) {
+            fn(0, count);
+        }
+        return;
+    }
+
+    this->forEach(bandCount, [&](int band) {
+        fn((int64_t)count * band / bandCount, (int64_t)count * (band + 1) / bandCount);
+    });
+}
+
 FilterResult FilterResult::resolveToBounds(const LayerSpace<SkIRect>& newBounds) const {
     // NOTE(michaelludwig) - This implementation is based on the assumption that an image resolved
     // to 'newBounds' will be decal tiled and that the current image is decal tiled. Because of this
@@ -12,7 +12,10 @@
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkSpecialSurface.h"
 
+#include <functional>
+
 class GrRecordingContext;
+class SkExecutor;
 class SkImageFilter;
 class SkImageFilterCache;
 class SkSpecialSurface;
@@ -643,6 +646,22 @@ public:
     // DEPRECATED: Use source() instead to get both the image and its origin.
     const SkSpecialImage* sourceImage() const { return fSource.image(); }
 
+    // The executor that raster filtering can run concurrently on. When it's not null, independent
+    // inputs of a filter are evaluated at the same time, and filters that process their pixels row
+    // by row (or column by column) split them into bands. It's always null when GPU-backed.
+    SkExecutor* executor() const { return this->gpuBacked() ? nullptr : fExecutor; }
+
+    // Calls 'fn' for each index in [0, count), concurrently on the executor when there is one.
+    // The calling thread runs indices too, and only blocks on indices that are already running on
+    // other threads, so calls can nest on any executor, whether or not it lends out its threads.
+    void forEach(int count, const std::function<void(int)>& fn) const;
+
+    // Calls 'fn' with consecutive ranges [start, end) that together cover [0, count), where each
+    // of the 'count' items (typically rows or columns) touches about 'itemPixels' pixels. Ranges
+    // run concurrently on the executor when there is one and there is enough work to split up.
+    void forEachBand(int count, int itemPixels,
+                     const std::function<void(int start, int end)>& fn) const;
+
     // True if image filtering should occur on the GPU if possible.
     bool gpuBacked() const { return fSource.image()->isTextureBacked(); }
     // The recording context to use when computing the filter with the GPU.
@@ -672,11 +691,19 @@ public:
 
     // Create a new context that matches this context, but with an overridden layer space.
     Context withNewMapping(const Mapping& mapping) const {
-        return Context(mapping, fDesiredOutput, fCache, fColorType, fColorSpace, fSource);
+        return Context(mapping, fDesiredOutput, fCache, fColorType, fColorSpace, fSource)
+                .withNewExecutor(fExecutor);
     }
     // Create a new context that matches this context, but with an overridden desired output rect.
     Context withNewDesiredOutput(const LayerSpace<SkIRect>& desiredOutput) const {
-        return Context(fMapping, desiredOutput, fCache, fColorType, fColorSpace, fSource);
+        return Context(fMapping, desiredOutput, fCache, fColorType, fColorSpace, fSource)
+                .withNewExecutor(fExecutor);
+    }
+    // Create a new context that matches this context, but filters concurrently on 'executor'.
+    Context withNewExecutor(SkExecutor* executor) const {
+        Context ctx = *this;
+        ctx.fExecutor = executor;
+        return ctx;
     }
 
 private:
@@ -688,6 +715,8 @@ private:
     // is bounded by the device, so this can be a bare pointer.
     SkColorSpace*       fColorSpace;
     FilterResult        fSource;
+    // Like the color space, the executor is owned by the device.
+    SkExecutor*         fExecutor = nullptr;
 };
 
 } // end namespace skif
@@ -18,6 +18,7 @@
 
 class GrFragmentProcessor;
 class GrRecordingContext;
+struct SkImageFilterCacheKey;
 
 // True base class that all SkImageFilter implementations need to extend from. This provides the
 // actual API surface that Skia will use to compute the filtered images.
@@ -39,6 +40,19 @@ public:
      */
     skif::FilterResult filterImage(const skif::Context& context) const;
 
+    /**
+     *  Like filterImage(), but on the raster backend, large desired outputs are split into tiles
+     *  that are aligned in layer space, and each tile is filtered (and cached) separately. When
+     *  the desired output moves, e.g. because the content scrolled, the tiles that are still
+     *  visible are found in the cache and only the newly exposed ones are filtered. Filters that
+     *  don't read the source image have the integer part of the layer matrix's translation
+     *  factored out, so their tiles stay aligned with the content as it moves.
+     *
+     *  This is meant for the root of a DAG; the tiles can overhang the desired output. Graphs that
+     *  can't be evaluated in pieces (see canFilterTiles()) are filtered in one piece.
+     */
+    skif::FilterResult filterImageTiled(const skif::Context& context) const;
+
     /**
      *  Calculate the smallest-possible required layer bounds that would provide sufficient
      *  information to correctly compute the image filter for every pixel in the desired output
@@ -103,6 +117,10 @@ public:
     // color other than transparent black.
     bool affectsTransparentBlack() const;
 
+    // Returns true if every filter in this graph produces the same pixels when it is evaluated in
+    // pieces as when it is evaluated all at once, so it can be used with filterImageTiled().
+    bool canFilterTiles() const;
+
     /**
      *  Most ImageFilters can natively handle scaling and translate components in the CTM. Only
      *  some of them can handle affine (or more complex) matrices. Some may only handle translation.
@@ -243,6 +261,14 @@ protected:
     // exit early since the null image would remain transparent.
     skif::FilterResult filterInput(int index, const skif::Context& ctx) const;
 
+    // Evaluates every input like filterInput(), with input 'i' using 'contexts[i]', and stores the
+    // results in 'results'. Both must have countInputs() entries. If the contexts have an executor,
+    // the input filters are evaluated concurrently on it. Branches of the DAG that share a filter
+    // reuse its result through the context's cache once it has been computed.
+    void filterInputs(const skif::Context* const contexts[], skif::FilterResult results[]) const;
+    // As above, but evaluating all inputs with the same context.
+    void filterInputs(const skif::Context& ctx, skif::FilterResult results[]) const;
+
     /**
      *  Returns whether any edges of the crop rect have been set. The crop
      *  rect is set at construction time, and determines which pixels from the
@@ -369,6 +395,13 @@ private:
      */
     virtual bool onAffectsTransparentBlack() const { return false; }
 
+    /**
+     *  Return false if this filter's output depends on the desired output it's evaluated for,
+     *  beyond being clipped to it (e.g. because it treats the edges of that area specially). Such
+     *  filters are never evaluated in tiles.
+     */
+    virtual bool onCanFilterTiles() const { return true; }
+
     /**
      *  This is the virtual which should be overridden by the derived class to perform image
      *  filtering. Subclasses are responsible for recursing to their input filters, although the
@@ -428,6 +461,9 @@ private:
     virtual skif::LayerSpace<SkIRect> onGetOutputLayerBounds(
             const skif::Mapping& mapping, const skif::LayerSpace<SkIRect>& contentBounds) const;
 
+    // The key of this filter's result for 'context', when it is filtered for 'clipBounds'.
+    SkImageFilterCacheKey cacheKey(const skif::Context& context, const SkIRect& clipBounds) const;
+
     SkAutoSTArray<2, sk_sp<SkImageFilter>> fInputs;
 
     bool fUsesSrcInput;
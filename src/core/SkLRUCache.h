@@ -80,6 +80,18 @@ public:
         return fMap.count();
     }
 
+    int maxCount() const {
+        return fMaxCount;
+    }
+
+    // Changes the capacity of the cache, evicting the least recently used entries as needed.
+    void setMaxCount(int maxCount) {
+        fMaxCount = maxCount;
+        while (fMap.count() > fMaxCount) {
+            this->remove(fLRU.tail()->fKey);
+        }
+    }
+
     template <typename Fn>  // f(K*, V*)
     void foreach(Fn&& fn) {
         typename SkTInternalLList<Entry>::Iter iter;
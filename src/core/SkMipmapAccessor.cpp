@@ -31,6 +31,18 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
     SkMipmapMode resolvedMode = requestedMode;
     fLowerWeight = 0;
 
+    auto post_scale = [image, inv](const SkPixmap& pm) {
+        return SkMatrix::Scale(SkIntToScalar(pm.width())  / image->width(),
+                               SkIntToScalar(pm.height()) / image->height()) * inv;
+    };
+
+    // A lazy image decoded ahead of time at a reduced size can stand in for its full decode.
+    if (SkFindPrescaledBitmap(image, inv, &fBaseStorage)) {
+        fUpper.reset(fBaseStorage.info(), fBaseStorage.getPixels(), fBaseStorage.rowBytes());
+        fUpperInv = post_scale(fUpper);
+        return;
+    }
+
     auto load_upper_from_base = [&]() {
         // only do this once
         if (fBaseStorage.getPixels() == nullptr) {
@@ -54,11 +66,6 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
         }
     }
 
-    auto post_scale = [image, inv](const SkPixmap& pm) {
-        return SkMatrix::Scale(SkIntToScalar(pm.width())  / image->width(),
-                               SkIntToScalar(pm.height()) / image->height()) * inv;
-    };
-
     int levelNum = sk_float_floor2int(level);
     float lowerWeight = level - levelNum;   // fract(level)
     SkASSERT(levelNum >= 0);
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkPathMaskCache.h"
+
+#include "include/core/SkMatrix.h"
+#include "include/private/SkIDChangeListener.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkPathPriv.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+// Filled paths with fewer points than this (e.g. rects) scan convert about as fast as their masks
+// blit, so they're not worth a cache entry.
+static constexpr int kMinFillPoints = 8;
+
+// Translations beyond this can't be split exactly into an integer offset and a subpixel phase.
+static constexpr SkScalar kMaxTranslate = 1 << 22;
+
+bool SkPathMaskCache::Desc::init(const SkPath& path, const SkPaint& paint, const SkMatrix& matrix) {
+    if (path.isVolatile() || path.isInverseFillType() || path.isEmpty() ||
+        paint.getPathEffect() || paint.getMaskFilter() || matrix.hasPerspective()) {
+        return false;
+    }
+    bool isFill = paint.getStyle() == SkPaint::kFill_Style;
+    if (isFill ? path.countPoints() < kMinFillPoints : paint.getStrokeWidth() <= 0) {
+        return false;
+    }
+
+    // Paths whose masks would be too big are rejected up front, before they are stroked.
+    SkRect storage;
+    SkRect devBounds = matrix.mapRect(paint.computeFastBounds(path.getBounds(), &storage));
+    if (!(devBounds.width() * devBounds.height() <= kMaxMaskArea)) {
+        return false;
+    }
+
+    SkScalar tx = matrix.getTranslateX(),
+             ty = matrix.getTranslateY();
+    if (!(SkScalarAbs(tx) < kMaxTranslate && SkScalarAbs(ty) < kMaxTranslate)) {
+        return false;
+    }
+    tx = SkScalarRoundToScalar(tx * kSubpixelSteps) / kSubpixelSteps;
+    ty = SkScalarRoundToScalar(ty * kSubpixelSteps) / kSubpixelSteps;
+    fOffset = {SkScalarFloorToInt(tx), SkScalarFloorToInt(ty)};
+
+    fGenID = path.getGenerationID();
+    fKey.fFillType    = static_cast<int32_t>(path.getFillType());
+    fKey.fStyle       = paint.getStyle();
+    fKey.fStrokeWidth = isFill ? 0 : paint.getStrokeWidth();
+    fKey.fMiterLimit  = isFill ? 0 : paint.getStrokeMiter();
+    fKey.fCapAndJoin  = isFill ? 0 : (paint.getStrokeCap() << 8) | paint.getStrokeJoin();
+    fKey.fAntiAlias   = paint.isAntiAlias();
+    fKey.fMatrix[0]   = matrix.getScaleX();
+    fKey.fMatrix[1]   = matrix.getSkewX();
+    fKey.fMatrix[2]   = matrix.getSkewY();
+    fKey.fMatrix[3]   = matrix.getScaleY();
+    fKey.fMatrix[4]   = tx - fOffset.fX;
+    fKey.fMatrix[5]   = ty - fOffset.fY;
+    return SkScalarsAreFinite(fKey.fMatrix, SK_ARRAY_COUNT(fKey.fMatrix));
+}
+
+SkMatrix SkPathMaskCache::Desc::maskMatrix() const {
+    return SkMatrix::MakeAll(fKey.fMatrix[0], fKey.fMatrix[1], fKey.fMatrix[4],
+                             fKey.fMatrix[2], fKey.fMatrix[3], fKey.fMatrix[5],
+                             0, 0, 1);
+}
+
+struct MaskValue {
+    SkMask          fMask;
+    SkCachedData*   fData;
+};
+
+namespace {
+static unsigned gPathMaskKeyNamespaceLabel;
+
+uint64_t make_shared_id(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('p', 'm', 's', 'k');
+    return (sharedID << 32) | pathGenID;
+}
+
+// Purges a path's entries once it changes, or is deleted.
+class PathMaskListener : public SkIDChangeListener {
+public:
+    explicit PathMaskListener(uint32_t pathGenID) : fSharedID(make_shared_id(pathGenID)) {}
+
+    void changed() override { SkResourceCache::PostPurgeSharedID(fSharedID); }
+
+private:
+    uint64_t fSharedID;
+};
+
+struct PathMaskKey : public SkResourceCache::Key {
+public:
+    PathMaskKey(unsigned* nameSpace, const SkPathMaskCache::Desc& desc) : fDesc(desc.fKey) {
+        this->init(nameSpace, make_shared_id(desc.fGenID), sizeof(fDesc));
+    }
+
+    SkPathMaskCache::Desc::Key fDesc;
+};
+
+struct PathMaskRec : public SkResourceCache::Rec {
+    PathMaskRec(const PathMaskKey& key, const SkMask& mask, SkCachedData* data,
+                sk_sp<SkIDChangeListener> listener)
+        : fKey(key)
+        , fListener(std::move(listener))
+    {
+        fValue.fMask = mask;
+        fValue.fData = data;
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~PathMaskRec() override {
+        fValue.fData->detachFromCacheAndUnref();
+        fListener->markShouldDeregister();
+    }
+
+    PathMaskKey               fKey;
+    MaskValue                 fValue;
+    sk_sp<SkIDChangeListener> fListener;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "path-mask"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathMaskRec& rec = static_cast<const PathMaskRec&>(baseRec);
+        MaskValue* result = (MaskValue*)contextData;
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+
+sk_sp<SkIDChangeListener> add_listener(const SkPath& path) {
+    sk_sp<SkIDChangeListener> listener = sk_make_sp<PathMaskListener>(path.getGenerationID());
+    SkPathPriv::AddGenIDChangeListener(path, listener);
+    return listener;
+}
+}  // namespace
+
+SkCachedData* SkPathMaskCache::FindAndRef(const Desc& desc, SkMask* mask,
+                                          SkResourceCache* localCache) {
+    MaskValue result;
+    PathMaskKey key(&gPathMaskKeyNamespaceLabel, desc);
+    if (!CHECK_LOCAL(localCache, find, Find, key, PathMaskRec::Visitor, &result)) {
+        return nullptr;
+    }
+
+    *mask = result.fMask;
+    mask->fBounds.offset(desc.fOffset.fX, desc.fOffset.fY);
+    mask->fImage = (uint8_t*)(result.fData->data());
+    return result.fData;
+}
+
+bool SkPathMaskCache::MarkDrawn(const Desc& desc, SkPathMaskDrawnSet* localSet) {
+    static SkPathMaskDrawnSet* gDrawn = new SkPathMaskDrawnSet;
+    return (localSet ? localSet : gDrawn)->mark(desc);
+}
+
+bool SkPathMaskDrawnSet::mark(const SkPathMaskCache::Desc& desc) {
+    uint32_t hash = SkOpts::hash(&desc.fKey, sizeof(desc.fKey), desc.fGenID) | 1;
+    std::atomic<uint32_t>& slot = fSlots[hash % SkPathMaskCache::kDrawnSlots];
+    if (slot.load(std::memory_order_relaxed) == hash) {
+        return true;
+    }
+    slot.store(hash, std::memory_order_relaxed);
+    return false;
+}
+
+void SkPathMaskCache::Add(const Desc& desc, const SkPath& path, const SkMask& mask,
+                          SkCachedData* data, SkResourceCache* localCache) {
+    SkASSERT(path.getGenerationID() == desc.fGenID);
+    PathMaskKey key(&gPathMaskKeyNamespaceLabel, desc);
+    SkMask cachedMask = mask;
+    cachedMask.fBounds.offset(-desc.fOffset.fX, -desc.fOffset.fY);
+    cachedMask.fImage = nullptr;
+    return CHECK_LOCAL(localCache, add, Add, new PathMaskRec(key, cachedMask, data,
+                                                             add_listener(path)));
+}
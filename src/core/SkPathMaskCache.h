@@ -0,0 +1,117 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathMaskCache_DEFINED
+#define SkPathMaskCache_DEFINED
+
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "src/core/SkCachedData.h"
+#include "src/core/SkMask.h"
+#include "src/core/SkResourceCache.h"
+
+#include <atomic>
+
+class SkMatrix;
+class SkPathMaskDrawnSet;
+
+/**
+ *  Caches the coverage masks of paths which are drawn repeatedly (e.g. icons and map symbols), so
+ *  that the raster backend can blit them instead of stroking and scan converting them again.
+ *
+ *  Entries are keyed on the path's generation ID, and are purged when the path is edited or
+ *  deleted. A mask is only cached once the same path has been drawn the same way twice, and
+ *  MarkDrawn() tracks that without locking or allocating, so paths which are drawn once never
+ *  touch the SkResourceCache.
+ */
+class SkPathMaskCache {
+public:
+    /**
+     *  Everything that determines a path's coverage: the path, its fill type, the stroke, the AA
+     *  setting, and the device matrix. The matrix's translation is rounded to a quarter pixel, and
+     *  its integer part is split off, so that the same mask is used wherever the path is drawn at
+     *  the same subpixel phase.
+     *
+     *  Every draw that can use the cache is drawn through a mask at this rounded phase, whether
+     *  or not the mask is cached, so a draw looks the same however many times it has been made.
+     */
+    struct Desc {
+        /**
+         *  Returns false if drawing the path with the paint and matrix can't use the cache, i.e.
+         *  the path is volatile, too simple to be worth caching, or inverse filled; the paint has
+         *  a path effect, a mask filter, or draws a hairline; or the matrix has perspective.
+         */
+        bool init(const SkPath&, const SkPaint&, const SkMatrix&);
+
+        /** The device matrix, with its translation rounded and without its integer part. */
+        SkMatrix maskMatrix() const;
+
+        // Everything that determines the mask, besides the path's generation ID. All of the fields
+        // are four bytes, so there is no padding in the key.
+        struct Key {
+            int32_t  fFillType;
+            int32_t  fStyle;
+            SkScalar fStrokeWidth;
+            SkScalar fMiterLimit;
+            int32_t  fCapAndJoin;
+            int32_t  fAntiAlias;
+            SkScalar fMatrix[6];  // scaleX, skewX, skewY, scaleY, and the subpixel phase
+        };
+
+        uint32_t fGenID;
+        Key      fKey;
+        SkIPoint fOffset;  // The integer part of the translation, which isn't part of the key.
+    };
+
+    /** Masks larger than this many pixels are never cached. */
+    static constexpr int kMaxMaskArea = 256 * 256;
+
+    /** Translations are rounded to 1/kSubpixelSteps of a pixel. */
+    static constexpr int kSubpixelSteps = 4;
+
+    /**
+     *  On success, return a ref to the SkCachedData that holds the pixels, and have mask already
+     *  point to that memory. The mask's bounds are in device space.
+     *
+     *  On failure, return nullptr.
+     */
+    static SkCachedData* FindAndRef(const Desc&, SkMask* mask,
+                                    SkResourceCache* localCache = nullptr);
+
+    /** The number of draws an SkPathMaskDrawnSet remembers. */
+    static constexpr int kDrawnSlots = 4096;
+
+    /**
+     *  Records that the path was drawn. Returns true if it had already been drawn the same way,
+     *  in which case its mask may be in the cache, or should be rendered and added to it.
+     *
+     *  By default this uses a set shared by all threads.
+     */
+    static bool MarkDrawn(const Desc&, SkPathMaskDrawnSet* localSet = nullptr);
+
+    /**
+     *  Add a mask and its pixel-data to the cache. The mask's bounds are in device space.
+     */
+    static void Add(const Desc&, const SkPath&, const SkMask& mask, SkCachedData* data,
+                    SkResourceCache* localCache = nullptr);
+};
+
+/**
+ *  The recent draws MarkDrawn() remembers: a fixed-size table of hashes, so it never locks or
+ *  allocates. Draws whose hashes collide displace each other, which only costs a cache lookup or
+ *  a rendered mask being skipped.
+ */
+class SkPathMaskDrawnSet {
+public:
+    bool mark(const SkPathMaskCache::Desc&);
+
+private:
+    // The hashes of recently drawn Descs, or zero.
+    std::atomic<uint32_t> fSlots[SkPathMaskCache::kDrawnSlots] = {};
+};
+
+#endif
@@ -195,8 +195,15 @@ bool SkRasterClip::op(const SkPath& path, const SkMatrix& matrix, SkClipOp op, b
             fAA.setPath(devPath, this->getBounds(), doAA);
         }
         return this->updateCacheAndReturnNonEmpty();
-    } else {
+    } else if (fIsBW && !doAA) {
         return this->op(SkRasterClip(devPath, this->getBounds(), doAA), op);
+    } else {
+        // The aaclip can apply the path directly, without building a separate clip for it.
+        if (fIsBW) {
+            this->convertToAA();
+        }
+        (void)fAA.op(devPath, op, doAA);
+        return this->updateCacheAndReturnNonEmpty();
     }
 }
 
@@ -363,17 +363,47 @@ void SkRasterPipeline::append_gamut_clamp_if_normalized(const SkImageInfo& info)
     }
 }
 
-SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip) const {
-    if (!gForceHighPrecisionRasterPipeline) {
+void SkRasterPipeline::fuse(const StageList** st, StockStage* stage, void** ctx) {
+    // Stages are stored backwards, so we match each sequence from its last stage.
+    const StageList* last = *st;
+    const StageList* prev = last->prev;
+    auto is = [](const StageList* s, StockStage want) { return s && s->stage == want; };
+
+    if (last->stage == store_8888 && is(prev, srcover) && is(prev->prev, load_8888_dst)
+            && prev->prev->ctx == last->ctx) {
+        *st    = prev->prev;
+        *stage = srcover_rgba_8888;
+        *ctx   = last->ctx;
+    } else if (last->stage == premul && is(prev, load_8888)) {
+        *st    = prev;
+        *stage = load_8888_premul;
+        *ctx   = prev->ctx;
+    } else if (last->stage == matrix_scale_translate && is(prev, seed_shader)) {
+        *st    = prev;
+        *stage = seed_shader_matrix_scale_translate;
+    } else if (last->stage == matrix_2x3 && is(prev, seed_shader)) {
+        *st    = prev;
+        *stage = seed_shader_matrix_2x3;
+    }
+}
+
+// Fills in the program back to front, starting from ip, and points *program at its first slot.
+// That may leave a few of the fSlotsNeeded slots before ip unused when stages are fused.
+SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip, void*** program,
+                                                                   bool forceHighp) const {
+    if (!forceHighp) {
         // We'll try to build a lowp pipeline, but if that fails fallback to a highp float pipeline.
         void** reset_point = ip;
 
         // Stages are stored backwards in fStages, so we reverse here, back to front.
         *--ip = (void*)SkOpts::just_return_lowp;
         for (const StageList* st = fStages; st; st = st->prev) {
-            if (auto fn = SkOpts::stages_lowp[st->stage]) {
-                if (st->ctx) {
-                    *--ip = st->ctx;
+            StockStage stage = st->stage;
+            void*      ctx   = st->ctx;
+            fuse(&st, &stage, &ctx);
+            if (auto fn = SkOpts::stages_lowp[stage]) {
+                if (ctx) {
+                    *--ip = ctx;
                 }
                 *--ip = (void*)fn;
             } else {
@@ -382,30 +412,46 @@ SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip) co
             }
         }
         if (ip != reset_point) {
+            *program = ip;
             return SkOpts::start_pipeline_lowp;
         }
     }
 
     *--ip = (void*)SkOpts::just_return_highp;
     for (const StageList* st = fStages; st; st = st->prev) {
-        if (st->ctx) {
-            *--ip = st->ctx;
+        StockStage stage = st->stage;
+        void*      ctx   = st->ctx;
+        fuse(&st, &stage, &ctx);
+        if (ctx) {
+            *--ip = ctx;
         }
-        *--ip = (void*)SkOpts::stages_highp[st->stage];
+        *--ip = (void*)SkOpts::stages_highp[stage];
     }
+    *program = ip;
     return SkOpts::start_pipeline_highp;
 }
 
 void SkRasterPipeline::run(size_t x, size_t y, size_t w, size_t h) const {
+    this->run(x,y,w,h, gForceHighPrecisionRasterPipeline);
+}
+
+void SkRasterPipeline::runForTesting(size_t x, size_t y, size_t w, size_t h,
+                                     bool forceHighp) const {
+    this->run(x,y,w,h, forceHighp);
+}
+
+void SkRasterPipeline::run(size_t x, size_t y, size_t w, size_t h, bool forceHighp) const {
     if (this->empty()) {
         return;
     }
 
     // Best to not use fAlloc here... we can't bound how often run() will be called.
-    SkAutoSTMalloc<64, void*> program(fSlotsNeeded);
+    SkAutoSTMalloc<64, void*> storage(fSlotsNeeded);
 
-    auto start_pipeline = this->build_pipeline(program.get() + fSlotsNeeded);
-    start_pipeline(x,y,x+w,y+h, program.get());
+    void** program;
+    auto start_pipeline = this->build_pipeline(storage.get() + fSlotsNeeded, &program,
+                                               forceHighp);
+    start_pipeline(x,y,x+w,y+h, program);
 }
 
 std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile() const {
@@ -413,9 +459,11 @@ std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile()
         return [](size_t, size_t, size_t, size_t) {};
     }
 
-    void** program = fAlloc->makeArray<void*>(fSlotsNeeded);
+    void** storage = fAlloc->makeArray<void*>(fSlotsNeeded);
 
-    auto start_pipeline = this->build_pipeline(program + fSlotsNeeded);
+    void** program;
+    auto start_pipeline = this->build_pipeline(storage + fSlotsNeeded, &program,
+                                               gForceHighPrecisionRasterPipeline);
     return [=](size_t x, size_t y, size_t w, size_t h) {
         start_pipeline(x,y,x+w,y+h, program);
     };
@@ -75,7 +75,8 @@ class SkData;
     M(colorburn) M(colordodge) M(darken) M(difference)             \
     M(exclusion) M(hardlight) M(lighten) M(overlay) M(softlight)   \
     M(hue) M(saturation) M(color) M(luminosity)                    \
-    M(srcover_rgba_8888)                                           \
+    M(srcover_rgba_8888) M(load_8888_premul)                       \
+    M(seed_shader_matrix_scale_translate) M(seed_shader_matrix_2x3) \
     M(matrix_translate) M(matrix_scale_translate)                  \
     M(matrix_2x3) M(matrix_3x3) M(matrix_3x4) M(matrix_4x5) M(matrix_4x3) \
     M(matrix_perspective)                                          \
@@ -169,6 +170,12 @@ struct SkRasterPipeline_GradientCtx {
     float* fs[4];
     float* bs[4];
     float* ts;
+    // Optional for the gradient stage. bucketCount buckets divide [0,1] evenly, plus one for t=1.
+    // buckets[b] holds the index of t's stop for t at the start of bucket b, and t passes at most
+    // maxStopsInBucket more stops within it. Needs ts[stopCount] to be NaN.
+    const uint32_t* buckets;
+    int bucketCount;
+    int maxStopsInBucket;
     bool interpolatedInPremul;
 };
 
@@ -221,6 +228,10 @@ public:
     // Runs the pipeline in 2d from (x,y) inclusive to (x+w,y+h) exclusive.
     void run(size_t x, size_t y, size_t w, size_t h) const;
 
+    // Like run(), but the choice of highp is made by 'forceHighp' rather than by
+    // gForceHighPrecisionRasterPipeline, so tests can compare lowp and highp without racing on it.
+    void runForTesting(size_t x, size_t y, size_t w, size_t h, bool forceHighp) const;
+
     // Allocates a thunk which amortizes run() setup cost in alloc.
     std::function<void(size_t, size_t, size_t, size_t)> compile() const;
 
@@ -262,8 +273,14 @@ private:
         void*      ctx;
     };
 
+    void run(size_t x, size_t y, size_t w, size_t h, bool forceHighp) const;
+
     using StartPipelineFn = void(*)(size_t,size_t,size_t,size_t, void** program);
-    StartPipelineFn build_pipeline(void**) const;
+    StartPipelineFn build_pipeline(void** ip, void*** program, bool forceHighp) const;
+
+    // If the stages ending at *st can run as a single fused stage, sets *stage and *ctx to it,
+    // and moves *st back to the first of the stages it replaces.
+    static void fuse(const StageList** st, StockStage* stage, void** ctx);
 
     void unchecked_append(StockStage, void*);
 
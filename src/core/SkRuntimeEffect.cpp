@@ -9,6 +9,7 @@
 
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkData.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
 #include "include/private/SkMutex.h"
 #include "include/sksl/DSLCore.h"
@@ -23,12 +24,16 @@
 #include "src/core/SkRasterPipeline.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRuntimeEffectPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkUtils.h"
 #include "src/core/SkVM.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/sksl/SkSLAnalysis.h"
 #include "src/sksl/SkSLCompiler.h"
+#include "src/sksl/SkSLDehydrator.h"
+#include "src/sksl/SkSLRehydrator.h"
 #include "src/sksl/SkSLSharedCompiler.h"
+#include "src/sksl/SkSLStringStream.h"
 #include "src/sksl/SkSLUtil.h"
 #include "src/sksl/codegen/SkSLVMCodeGenerator.h"
 #include "src/sksl/ir/SkSLFunctionDefinition.h"
@@ -48,6 +53,7 @@
 #endif
 
 #include <algorithm>
+#include <limits>
 
 using ChildType = SkRuntimeEffect::ChildType;
 
@@ -180,10 +186,106 @@ SkSL::ProgramSettings SkRuntimeEffect::MakeSettings(const Options& options, bool
 // in the IR generator would provide better errors messages (with locations).
 #define RETURN_FAILURE(...) return Result{nullptr, SkStringPrintf(__VA_ARGS__)}
 
+sk_sp<SkData> SkRuntimeEffect::MakePersistentCacheKey(const SkString& sksl,
+                                                      const Options& options,
+                                                      SkSL::ProgramKind kind) {
+    // The serialized format version is part of the key, so stale entries are simply never found.
+    // Only the options which affect the compiled program matter here; allowFragCoord is checked
+    // by MakeInternal either way.
+    SkDynamicMemoryWStream stream;
+    stream.write16(SkSL::Rehydrator::kVersion);
+    stream.write8(static_cast<uint8_t>(kind));
+    stream.write8(options.forceNoInline);
+    stream.write8(options.enforceES2Restrictions);
+    stream.write(sksl.c_str(), sksl.size());
+    return stream.detachAsData();
+}
+
+// Persistent data is the dehydrated program, preceded by its size and hash. The rehydrator trusts
+// its input, so truncated or corrupted data must be caught before it gets there.
+struct PersistentDataHeader {
+    uint32_t size;
+    uint32_t hash;
+};
+
+static sk_sp<SkData> make_persistent_data(const std::string& dehydrated) {
+    const PersistentDataHeader header = {
+        SkToU32(dehydrated.size()),
+        SkOpts::hash_fn(dehydrated.data(), dehydrated.size(), 0),
+    };
+    sk_sp<SkData> data = SkData::MakeUninitialized(sizeof(header) + dehydrated.size());
+    memcpy(data->writable_data(), &header, sizeof(header));
+    memcpy(SkTAddOffset<void>(data->writable_data(), sizeof(header)),
+           dehydrated.data(), dehydrated.size());
+    return data;
+}
+
+SkRuntimeEffect::Result SkRuntimeEffect::MakeFromPersistentData(sk_sp<SkData> data,
+                                                                const SkString& sksl,
+                                                                const Options& options,
+                                                                SkSL::ProgramKind kind) {
+    PersistentDataHeader header;
+    if (data->size() < sizeof(header)) {
+        RETURN_FAILURE("mismatched persistent data");
+    }
+    memcpy(&header, data->data(), sizeof(header));
+    const uint8_t* dehydrated = data->bytes() + sizeof(header);
+    if (header.size != data->size() - sizeof(header) ||
+        header.hash != SkOpts::hash_fn(dehydrated, header.size, 0)) {
+        RETURN_FAILURE("mismatched persistent data");
+    }
+
+    uint16_t version;
+    if (header.size < sizeof(version)) {
+        RETURN_FAILURE("mismatched persistent data");
+    }
+    memcpy(&version, dehydrated, sizeof(version));
+    if (version != SkSL::Rehydrator::kVersion) {
+        RETURN_FAILURE("unsupported persistent data version %d", version);
+    }
+
+    std::unique_ptr<SkSL::Program> program;
+    {
+        // As in MakeFromSource, the SharedCompiler must be released before calling MakeInternal.
+        SkSL::SharedCompiler compiler;
+        // Builtins (intrinsics, types, etc.) resolve against the same module that MakeFromSource
+        // compiles against.
+        SkSL::Rehydrator rehydrator(*compiler.operator->(), dehydrated, header.size,
+                                    compiler->moduleForProgramKind(kind).fSymbols);
+        program = rehydrator.program();
+        if (!program || program->fConfig->fKind != kind) {
+            RETURN_FAILURE("mismatched persistent data");
+        }
+    }
+    program->fConfig->fSettings = MakeSettings(options, /*optimize=*/true);
+    program->fSource = std::make_unique<std::string>(sksl.c_str(), sksl.size());
+
+    Result result = MakeInternal(std::move(program), options, kind);
+    if (result.effect) {
+        // The rehydrated program refers to strings stored in the data.
+        result.effect->fPersistentData = std::move(data);
+    }
+    return result;
+}
+
 SkRuntimeEffect::Result SkRuntimeEffect::MakeFromSource(SkString sksl,
                                                         const Options& options,
                                                         SkSL::ProgramKind kind) {
+    PersistentCache* persistentCache = options.persistentCache;
+    sk_sp<SkData> persistentKey;
+    if (persistentCache) {
+        persistentKey = MakePersistentCacheKey(sksl, options, kind);
+        if (sk_sp<SkData> data = persistentCache->load(*persistentKey)) {
+            Result result = MakeFromPersistentData(std::move(data), sksl, options, kind);
+            if (result.effect) {
+                return result;
+            }
+            // If the cached data is unusable, we just compile from scratch (and replace it).
+        }
+    }
+
     std::unique_ptr<SkSL::Program> program;
+    sk_sp<SkData> persistentData;
     {
         // We keep this SharedCompiler in a separate scope to make sure it's destroyed before
         // calling the Make overload at the end, which creates its own (non-reentrant)
@@ -195,8 +297,24 @@ SkRuntimeEffect::Result SkRuntimeEffect::MakeFromSource(SkString sksl,
         if (!program) {
             RETURN_FAILURE("%s", compiler->errorText().c_str());
         }
+
+        if (persistentCache) {
+            SkSL::Dehydrator dehydrator;
+            dehydrator.write(*program);
+            SkSL::StringStream stream;
+            dehydrator.finish(stream);
+            // The dehydrated format addresses its string table with 16-bit offsets.
+            if (stream.str().size() <= std::numeric_limits<uint16_t>::max()) {
+                persistentData = make_persistent_data(stream.str());
+            }
+        }
     }
-    return MakeInternal(std::move(program), options, kind);
+
+    Result result = MakeInternal(std::move(program), options, kind);
+    if (result.effect && persistentData) {
+        persistentCache->store(*persistentKey, *persistentData);
+    }
+    return result;
 }
 
 SkRuntimeEffect::Result SkRuntimeEffect::MakeFromDSL(std::unique_ptr<SkSL::Program> program,
@@ -222,7 +340,8 @@ sk_sp<SkRuntimeEffect> SkRuntimeEffect::MakeFromDSL(std::unique_ptr<SkSL::Progra
 SkRuntimeEffect::Result SkRuntimeEffect::MakeInternal(std::unique_ptr<SkSL::Program> program,
                                                       const Options& options,
                                                       SkSL::ProgramKind kind) {
-    SkSL::SharedCompiler compiler;
+    // Lock the compiler that built this program; its types and modules are used below.
+    SkSL::SharedCompiler compiler(program->fContext.get());
 
     // Find 'main', then locate the sample coords parameter. (It might not be present.)
     const SkSL::FunctionDefinition* main = SkSL::Program_GetFunction(*program, "main");
@@ -283,7 +402,7 @@ SkRuntimeEffect::Result SkRuntimeEffect::MakeInternal(std::unique_ptr<SkSL::Prog
     std::vector<Child> children;
     std::vector<SkSL::SampleUsage> sampleUsages;
     int elidedSampleCoords = 0;
-    const SkSL::Context& ctx(compiler->context());
+    const SkSL::Context& ctx(*program->fContext);
 
     // Go through program elements, pulling out information that we need
     for (const SkSL::ProgramElement* elem : program->elements()) {
@@ -424,6 +543,24 @@ SkRuntimeEffect::Result SkRuntimeEffect::MakeForBlender(SkString sksl, const Opt
     return result;
 }
 
+void SkRuntimeEffect::MakeBatch(SkSpan<const BatchRequest> requests,
+                                const std::function<void(int index, Result)>& callback,
+                                SkExecutor* executor) {
+    // Each task compiles on whichever SharedCompiler is idle, so up to the size of the compiler
+    // pool can run at once. Callbacks are serialized, so clients don't need their own locking.
+    SkMutex callbackMutex;
+    SkTaskGroup tasks(executor ? *executor : SkExecutor::GetDefault());
+    tasks.batch(SkToInt(requests.size()), [&](int i) {
+        const BatchRequest& request = requests[i];
+        SkASSERT(request.make);
+        Result result = request.make(request.sksl, request.options);
+
+        SkAutoMutexExclusive lock(callbackMutex);
+        callback(i, std::move(result));
+    });
+    tasks.wait();
+}
+
 SkRuntimeEffect::Result SkRuntimeEffect::MakeForColorFilter(std::unique_ptr<SkSL::Program> program,
                                                             const Options& options) {
     auto result = MakeFromDSL(std::move(program), options, SkSL::ProgramKind::kRuntimeColorFilter);
@@ -467,31 +604,58 @@ SkRuntimeEffect::Result SkRuntimeEffect::MakeForBlender(std::unique_ptr<SkSL::Pr
     return MakeForBlender(std::move(program), Options{});
 }
 
-sk_sp<SkRuntimeEffect> SkMakeCachedRuntimeEffect(SkRuntimeEffect::Result (*make)(SkString sksl),
-                                                 SkString sksl) {
-    SK_BEGIN_REQUIRE_DENSE
-    struct Key {
-        uint32_t skslHashA;
-        uint32_t skslHashB;
-
-        bool operator==(const Key& that) const {
-            return this->skslHashA == that.skslHashA
-                && this->skslHashB == that.skslHashB;
-        }
+SK_BEGIN_REQUIRE_DENSE
+struct CachedRuntimeEffectKey {
+    uint32_t skslHashA;
+    uint32_t skslHashB;
 
-        explicit Key(const SkString& sksl)
-            : skslHashA(SkOpts::hash(sksl.c_str(), sksl.size(), 0))
-            , skslHashB(SkOpts::hash(sksl.c_str(), sksl.size(), 1)) {}
-    };
-    SK_END_REQUIRE_DENSE
+    bool operator==(const CachedRuntimeEffectKey& that) const {
+        return this->skslHashA == that.skslHashA
+            && this->skslHashB == that.skslHashB;
+    }
+
+    explicit CachedRuntimeEffectKey(const SkString& sksl)
+        : skslHashA(SkOpts::hash(sksl.c_str(), sksl.size(), 0))
+        , skslHashB(SkOpts::hash(sksl.c_str(), sksl.size(), 1)) {}
+};
+SK_END_REQUIRE_DENSE
+
+class SkRuntimeEffectCache::Effects
+        : public SkLRUCache<CachedRuntimeEffectKey, sk_sp<SkRuntimeEffect>> {
+public:
+    using SkLRUCache::SkLRUCache;
+};
+
+static constexpr int kDefaultCachedRuntimeEffectCountLimit = 11;
 
-    static auto* mutex = new SkMutex;
-    static auto* cache = new SkLRUCache<Key, sk_sp<SkRuntimeEffect>>(11/*totally arbitrary*/);
+SkRuntimeEffectCache::SkRuntimeEffectCache(int countLimit)
+        : fEffects(std::make_unique<Effects>(std::max(countLimit, 0))) {}
 
-    Key key(sksl);
+SkRuntimeEffectCache::~SkRuntimeEffectCache() = default;
+
+SkRuntimeEffectCache* SkRuntimeEffectCache::Global() {
+    static auto* cache = new SkRuntimeEffectCache(kDefaultCachedRuntimeEffectCountLimit);
+    return cache;
+}
+
+int SkRuntimeEffectCache::countLimit() const {
+    SkAutoMutexExclusive _(fMutex);
+    return fEffects->maxCount();
+}
+
+int SkRuntimeEffectCache::setCountLimit(int count) {
+    SkAutoMutexExclusive _(fMutex);
+    int prevLimit = fEffects->maxCount();
+    fEffects->setMaxCount(std::max(count, 0));
+    return prevLimit;
+}
+
+sk_sp<SkRuntimeEffect> SkRuntimeEffectCache::findOrMake(
+        SkRuntimeEffect::Result (*make)(SkString sksl), SkString sksl) {
+    CachedRuntimeEffectKey key(sksl);
     {
-        SkAutoMutexExclusive _(*mutex);
-        if (sk_sp<SkRuntimeEffect>* found = cache->find(key)) {
+        SkAutoMutexExclusive _(fMutex);
+        if (sk_sp<SkRuntimeEffect>* found = fEffects->find(key)) {
             return *found;
         }
     }
@@ -503,12 +667,25 @@ sk_sp<SkRuntimeEffect> SkMakeCachedRuntimeEffect(SkRuntimeEffect::Result (*make)
     SkASSERT(err.isEmpty());
 
     {
-        SkAutoMutexExclusive _(*mutex);
-        cache->insert_or_update(key, effect);
+        SkAutoMutexExclusive _(fMutex);
+        fEffects->insert_or_update(key, effect);
     }
     return effect;
 }
 
+int SkRuntimeEffectPriv::GetCacheCountLimit() {
+    return SkRuntimeEffectCache::Global()->countLimit();
+}
+
+int SkRuntimeEffectPriv::SetCacheCountLimit(int count) {
+    return SkRuntimeEffectCache::Global()->setCountLimit(count);
+}
+
+sk_sp<SkRuntimeEffect> SkMakeCachedRuntimeEffect(SkRuntimeEffect::Result (*make)(SkString sksl),
+                                                 SkString sksl) {
+    return SkRuntimeEffectCache::Global()->findOrMake(make, std::move(sksl));
+}
+
 static size_t uniform_element_size(SkRuntimeEffect::Uniform::Type type) {
     switch (type) {
         case SkRuntimeEffect::Uniform::Type::kFloat:  return sizeof(float);
@@ -554,7 +731,12 @@ SkRuntimeEffect::SkRuntimeEffect(std::unique_ptr<SkSL::Program> baseProgram,
     // be accounted for in `fHash`. If you've added a new field to Options and caused the static-
     // assert below to trigger, please incorporate your field into `fHash` and update KnownOptions
     // to match the layout of Options.
-    struct KnownOptions { bool forceNoInline, enforceES2Restrictions, allowFragCoord; };
+    // (persistentCache only affects how the program is compiled, not the result.)
+    struct KnownOptions {
+        bool forceNoInline;
+        void* persistentCache;
+        bool enforceES2Restrictions, allowFragCoord;
+    };
     static_assert(sizeof(Options) == sizeof(KnownOptions));
     fHash = SkOpts::hash_fn(&options.forceNoInline,
                       sizeof(options.forceNoInline), fHash);
@@ -10,9 +10,11 @@
 
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkMutex.h"
 #include "src/core/SkVM.h"
 
 #include <functional>
+#include <memory>
 
 #ifdef SK_ENABLE_SKSL
 
@@ -33,6 +35,36 @@ public:
     static void EnableFragCoord(SkRuntimeEffect::Options* options) {
         options->allowFragCoord = true;
     }
+
+    // Accessors for the capacity of the SkMakeCachedRuntimeEffect() cache (see SkGraphics).
+    static int GetCacheCountLimit();
+    static int SetCacheCountLimit(int count);
+};
+
+// Runtime effects keyed on their SkSL, holding at most a limited count of them and evicting the
+// least recently used.  SkMakeCachedRuntimeEffect() uses the Global() one; tests can make their
+// own to check eviction without disturbing it.
+class SkRuntimeEffectCache {
+public:
+    explicit SkRuntimeEffectCache(int countLimit);
+    ~SkRuntimeEffectCache();
+
+    static SkRuntimeEffectCache* Global();
+
+    int countLimit() const;
+    // Returns the previous limit.  Lowering it evicts effects right away.
+    int setCountLimit(int count);
+
+    // Returns the cached effect for this SkSL, or calls make() and caches its effect.  Returns
+    // null (and caches nothing) if make() fails.
+    sk_sp<SkRuntimeEffect> findOrMake(SkRuntimeEffect::Result (*make)(SkString sksl),
+                                      SkString sksl);
+
+private:
+    class Effects;
+
+    mutable SkMutex          fMutex;
+    std::unique_ptr<Effects> fEffects;
 };
 
 // These internal APIs for creating runtime effects vary from the public API in two ways:
@@ -12,7 +12,10 @@
 #include "include/core/SkRect.h"
 #include "include/private/SkFixed.h"
 #include <atomic>
+#include <functional>
 
+class SkArenaAlloc;
+class SkExecutor;
 class SkRasterClip;
 class SkRegion;
 class SkBlitter;
@@ -25,6 +28,8 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
+extern std::atomic<bool> gSkUseDeltaAA;
+extern std::atomic<bool> gSkForceDeltaAA;
 
 class AdditiveBlitter;
 
@@ -72,6 +77,29 @@ public:
     static void HairRoundPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiHairRoundPath(const SkPath&, const SkRasterClip&, SkBlitter*);
 
+    /**
+     *  Anti-aliased fill of a very large path, scan converted in horizontal bands which run
+     *  concurrently on the executor. Blitters aren't thread-safe, so each band gets its own from
+     *  makeBlitter, which is called on the band's thread. Returns false, without drawing anything,
+     *  if the path is an inverse fill or too small to be worth splitting up.
+     */
+    using BandBlitterProc = std::function<SkBlitter*(SkArenaAlloc*)>;
+    static bool AntiFillPathBands(const SkPath&, const SkRasterClip&, SkExecutor*,
+                                  const BandBlitterProc& makeBlitter);
+
+    /**
+     *  AntiFillPath picks a scan converter for each path, based on its complexity and the
+     *  gSk*AA flags. Tests and benches can ask for a specific one instead. Inverse fills never
+     *  use kDelta, and kAnalytic falls back to kSupersampled if AAA is disabled.
+     */
+    enum class AAConverter {
+        kDefault,
+        kAnalytic,
+        kSupersampled,
+        kDelta,
+    };
+    static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*, AAConverter);
+
     // Needed by do_fill_path in SkScanPriv.h
     static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
 
@@ -84,7 +112,8 @@ private:
     static void FillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
-    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE);
+    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE,
+                             AAConverter = AAConverter::kDefault);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -95,6 +124,8 @@ private:
                             const SkIRect& clipBounds, bool forceRLE);
     static void SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
+    static void DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
+                            const SkIRect& clipBounds, bool forceRLE);
 };
 
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
@@ -598,9 +598,7 @@ static SkIRect safeRoundOut(const SkRect& src) {
 }
 
 constexpr int kSampleSize = 8;
-#if !defined(SK_DISABLE_AAA)
-    constexpr SkScalar kComplexityThreshold = 0.25;
-#endif
+constexpr SkScalar kComplexityThreshold = 0.25;
 
 static void compute_complexity(const SkPath& path, SkScalar& avgLength, SkScalar& complexity) {
     int n = path.countPoints();
@@ -671,6 +669,22 @@ static bool ShouldUseAAA(const SkPath& path, SkScalar avgLength, SkScalar comple
 #endif
 }
 
+static bool ShouldUseDAA(const SkPath& path, SkScalar complexity, bool forceRLE) {
+    // DAA only blits where the path has coverage, so it can't fill the inside of an inverse
+    // path. Callers which force RLE (i.e. SkAAClip) stay on the scan converters they rely on.
+    if (path.isInverseFillType() || forceRLE) {
+        return false;
+    }
+    if (gSkForceDeltaAA) {
+        return true;
+    }
+    if (!gSkUseDeltaAA) {
+        return false;
+    }
+    // AAA is faster for simple paths, and DAA pays off when many edges share the same scanlines.
+    return complexity >= kComplexityThreshold;
+}
+
 void SkScan::SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
                   const SkIRect& clipBounds, bool forceRLE) {
     bool containedInClip = clipBounds.contains(ir);
@@ -712,7 +726,7 @@ static int rect_overflows_short_shift(SkIRect rect, int shift) {
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
-                          SkBlitter* blitter, bool forceRLE) {
+                          SkBlitter* blitter, bool forceRLE, AAConverter converter) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -782,15 +796,40 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         sk_blit_above(blitter, ir, *clipRgn);
     }
 
-    SkScalar avgLength, complexity;
-    compute_complexity(path, avgLength, complexity);
+    if (converter == AAConverter::kDefault) {
+        SkScalar avgLength, complexity;
+        compute_complexity(path, avgLength, complexity);
 
-    if (ShouldUseAAA(path, avgLength, complexity)) {
-        // Do not use AAA if path is too complicated:
-        // there won't be any speedup or significant visual improvement.
-        SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
-    } else {
-        SkScan::SAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+        if (ShouldUseDAA(path, complexity, forceRLE)) {
+            converter = AAConverter::kDelta;
+        } else if (ShouldUseAAA(path, avgLength, complexity)) {
+            // Do not use AAA if path is too complicated:
+            // there won't be any speedup or significant visual improvement.
+            converter = AAConverter::kAnalytic;
+        } else {
+            converter = AAConverter::kSupersampled;
+        }
+    } else if (converter == AAConverter::kDelta && isInverse) {
+        // DAA only blits where the path has coverage.
+        converter = AAConverter::kAnalytic;
+    }
+#if defined(SK_DISABLE_AAA)
+    if (converter == AAConverter::kAnalytic) {
+        converter = AAConverter::kSupersampled;
+    }
+#endif
+
+    switch (converter) {
+        case AAConverter::kDelta:
+            SkScan::DAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+            break;
+        case AAConverter::kAnalytic:
+            SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+            break;
+        case AAConverter::kDefault:
+        case AAConverter::kSupersampled:
+            SkScan::SAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+            break;
     }
 
     if (isInverse) {
@@ -820,18 +859,24 @@ void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* b
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
+    AntiFillPath(path, clip, blitter, AAConverter::kDefault);
+}
+
+void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter,
+                          AAConverter converter) {
     if (clip.isEmpty() || !path.isFinite()) {
         return;
     }
 
     if (clip.isBW()) {
-        AntiFillPath(path, clip.bwRgn(), blitter, false);
+        AntiFillPath(path, clip.bwRgn(), blitter, false, converter);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        AntiFillPath(path, tmp, &aaBlitter, true); // SkAAClipBlitter can blitMask, why forceRLE?
+        // SkAAClipBlitter can blitMask, why forceRLE?
+        AntiFillPath(path, tmp, &aaBlitter, true, converter);
     }
 }
@@ -0,0 +1,477 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPath.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkAAClip.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkImagePriv.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkRasterClip.h"
+#include "src/core/SkScan.h"
+#include "src/core/SkScanPriv.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/*
+
+Delta-based analytic anti-aliasing (DAA) takes a different route from AAA: rather than
+walking a sorted list of edges and computing trapezoids between them, every line segment
+independently adds its contribution to a buffer of per-pixel coverage deltas. For each row that
+a line crosses, the pixels it passes through receive the signed area to their right of the line
+(split between the pixels it touches), and the pixel after that receives the rest, so that the
+deltas of each row sum to the signed height of the line in that row. A prefix sum across a row
+then turns the deltas into the winding number of each pixel, with fractional values where edges
+pass through.
+
+Accumulation doesn't need edges to be sorted or intersections to be found, and the per-row work
+of a line is a handful of additions. The prefix sum, which resolves deltas into alphas, runs four
+pixels at a time. That makes DAA a good fit for complex paths with many edges per scanline (maps,
+icons, text as paths), where AAA spends most of its time branching on edge order and crossings.
+
+The deltas of kStripHeight rows are accumulated and resolved at a time, to bound the size of the
+buffer. Curves are flattened to lines first, and lines are clipped horizontally to the columns
+being drawn: the parts to the left of them become vertical lines on the left edge (they cover
+everything to their right), and the parts to the right are dropped onto the padding after the
+last column.
+
+For winding fills, coverage is the absolute winding clamped to 1; for even-odd fills, it folds
+the winding into [0, 1]. Both are exact where edges don't overlap within a pixel.
+
+Since rows only depend on the lines that cross them, very large paths can also be split into
+horizontal bands which are scan converted concurrently (AntiFillPathBands): the lines are built
+once, sorted into the bands they cross, and each band draws its own rows with its own blitter.
+
+*/
+
+namespace {
+
+constexpr int kStripHeight = 16;
+
+// Paths are split into at most kMaxBands bands of at least kMinBandHeight rows, and only if they
+// cover at least kMinBandedArea pixels; smaller paths aren't worth the cost of the tasks.
+constexpr int kMinBandHeight = 4 * kStripHeight;
+constexpr int kMaxBands = 64;
+constexpr int64_t kMinBandedArea = 512 * 512;
+
+// Curves are flattened into lines that stay within this distance (in pixels) of the curve.
+constexpr float kFlattenTolerance = 0.125f;
+constexpr int kMaxCurveLines = 64;
+
+struct DeltaLine {
+    float fX0, fY0, fX1, fY1;  // fY0 < fY1
+    float fDir;                // +1 if the original line went down, -1 if it went up
+};
+
+// Flattens a path into DeltaLines, with x relative to the left of the drawn columns and clamped
+// to [0, width].
+class LineBuilder {
+public:
+    LineBuilder(float left, float width) : fLeft(left), fWidth(width) {}
+
+    void addPath(const SkPath& path) {
+        SkPoint start = {0, 0};
+        bool open = false;
+        for (auto [verb, pts, weight] : SkPathPriv::Iterate(path)) {
+            switch (verb) {
+                case SkPathVerb::kMove:
+                    if (open) {
+                        this->addLine(fLast, start);
+                    }
+                    start = fLast = pts[0];
+                    open = true;
+                    break;
+                case SkPathVerb::kLine:
+                    this->lineTo(pts[1]);
+                    break;
+                case SkPathVerb::kQuad:
+                    this->quadTo(pts);
+                    break;
+                case SkPathVerb::kConic: {
+                    SkAutoConicToQuads quadder;
+                    const SkPoint* quadPts = quadder.computeQuads(pts, *weight,
+                                                                  kFlattenTolerance);
+                    for (int i = 0; i < quadder.countQuads(); ++i) {
+                        this->quadTo(quadPts + 2 * i);
+                    }
+                    break;
+                }
+                case SkPathVerb::kCubic:
+                    this->cubicTo(pts);
+                    break;
+                case SkPathVerb::kClose:
+                    this->addLine(fLast, start);
+                    fLast = start;
+                    open = false;
+                    break;
+            }
+        }
+        if (open) {
+            this->addLine(fLast, start);
+        }
+    }
+
+    std::vector<DeltaLine>& lines() { return fLines; }
+
+private:
+    static int CurveLineCount(float deviation) {
+        int count = SkScalarCeilToInt(SkScalarSqrt(deviation / kFlattenTolerance));
+        return SkTPin(count, 1, kMaxCurveLines);
+    }
+
+    void lineTo(SkPoint pt) {
+        this->addLine(fLast, pt);
+        fLast = pt;
+    }
+
+    void quadTo(const SkPoint pts[3]) {
+        // The distance from a quad to its chord is at most |p0 - 2p1 + p2| / 4, and it shrinks
+        // with the square of the number of lines.
+        float deviation = (pts[0] - pts[1] - pts[1] + pts[2]).length() * 0.25f;
+        int count = CurveLineCount(deviation);
+        SkQuadCoeff quad(pts);
+        for (int i = 1; i < count; ++i) {
+            this->lineTo(to_point(quad.eval(1.0f * i / count)));
+        }
+        this->lineTo(pts[2]);
+    }
+
+    void cubicTo(const SkPoint pts[4]) {
+        float deviation = std::max((pts[0] - pts[1] - pts[1] + pts[2]).length(),
+                                   (pts[1] - pts[2] - pts[2] + pts[3]).length()) * 0.75f;
+        int count = CurveLineCount(deviation);
+        SkCubicCoeff cubic(pts);
+        for (int i = 1; i < count; ++i) {
+            this->lineTo(to_point(cubic.eval(1.0f * i / count)));
+        }
+        this->lineTo(pts[3]);
+    }
+
+    void addLine(SkPoint p0, SkPoint p1) {
+        if (p0.fY == p1.fY) {
+            return;  // Horizontal lines don't change coverage.
+        }
+        float x0 = p0.fX - fLeft, x1 = p1.fX - fLeft;
+        // Split the line where it crosses the left and right of the drawn columns, so that each
+        // part can be clamped on its own.
+        float splits[4] = {0, 0, 0, 1};
+        int splitCount = 1;
+        for (float edge : {0.0f, fWidth}) {
+            if ((x0 < edge) != (x1 < edge) && x0 != edge && x1 != edge) {
+                splits[splitCount++] = (edge - x0) / (x1 - x0);
+            }
+        }
+        splits[splitCount++] = 1;
+        std::sort(splits + 1, splits + splitCount - 1);
+        for (int i = 0; i + 1 < splitCount; ++i) {
+            float t0 = splits[i], t1 = splits[i + 1];
+            float ya = p0.fY + (p1.fY - p0.fY) * t0,
+                  yb = i + 2 == splitCount ? p1.fY : p0.fY + (p1.fY - p0.fY) * t1;
+            float xa = SkTPin(x0 + (x1 - x0) * t0, 0.0f, fWidth),
+                  xb = SkTPin(i + 2 == splitCount ? x1 : x0 + (x1 - x0) * t1, 0.0f, fWidth);
+            if (ya < yb) {
+                fLines.push_back({xa, ya, xb, yb, 1});
+            } else if (yb < ya) {
+                fLines.push_back({xb, yb, xa, ya, -1});
+            }
+        }
+    }
+
+    const float fLeft;
+    const float fWidth;
+    SkPoint fLast = {0, 0};
+    std::vector<DeltaLine> fLines;
+};
+
+// Accumulates the coverage deltas of a line into the rows [stripTop, stripBottom) of deltas, and
+// widens the range of touched columns of each row.
+void accumulate_line(const DeltaLine& line, float* deltas, int stride, int stripTop,
+                     int stripBottom, int* minX, int* maxX) {
+    const float dxdy = (line.fX1 - line.fX0) / (line.fY1 - line.fY0);
+    const int yStart = std::max(SkScalarFloorToInt(line.fY0), stripTop),
+              yEnd   = std::min(SkScalarCeilToInt(line.fY1), stripBottom);
+    for (int y = yStart; y < yEnd; ++y) {
+        const float top    = std::max((float)y, line.fY0),
+                    bottom = std::min((float)(y + 1), line.fY1);
+        if (top >= bottom) {
+            continue;
+        }
+        const float xTop    = line.fX0 + (top - line.fY0) * dxdy,
+                    xBottom = line.fX0 + (bottom - line.fY0) * dxdy;
+        const float d = (bottom - top) * line.fDir;
+        // Lines are clamped to [0, width], but interpolating along them can round a hair below 0.
+        const float x0 = std::max(std::min(xTop, xBottom), 0.0f),
+                    x1 = std::max(xTop, xBottom);
+        const float x0Floor = sk_float_floor(x0);
+        const int x0i = (int)x0Floor,
+                  x1i = (int)sk_float_ceil(x1);
+        const int row = y - stripTop;
+        float* rowDeltas = deltas + row * stride;
+
+        if (x1i <= x0i + 1) {
+            // The line stays within one column: split by the average x within the row.
+            const float xmf = 0.5f * (xTop + xBottom) - x0Floor;
+            rowDeltas[x0i]     += d - d * xmf;
+            rowDeltas[x0i + 1] += d * xmf;
+            minX[row] = std::min(minX[row], x0i);
+            maxX[row] = std::max(maxX[row], x0i + 1);
+        } else {
+            // The line crosses several columns: the first and last get a triangle's area, the
+            // columns in between a constant share of the row's height.
+            const float s = 1 / (x1 - x0);
+            const float x0f = x0 - x0Floor;
+            const float a0 = 0.5f * s * (1 - x0f) * (1 - x0f);
+            const float x1f = x1 - x1i + 1;
+            const float am = 0.5f * s * x1f * x1f;
+            rowDeltas[x0i] += d * a0;
+            if (x1i == x0i + 2) {
+                rowDeltas[x0i + 1] += d * (1 - a0 - am);
+            } else {
+                const float a1 = s * (1.5f - x0f);
+                rowDeltas[x0i + 1] += d * (a1 - a0);
+                for (int x = x0i + 2; x < x1i - 1; ++x) {
+                    rowDeltas[x] += d * s;
+                }
+                const float a2 = a1 + (x1i - x0i - 3) * s;
+                rowDeltas[x1i - 1] += d * (1 - a2 - am);
+            }
+            rowDeltas[x1i] += d * am;
+            minX[row] = std::min(minX[row], x0i);
+            maxX[row] = std::max(maxX[row], x1i);
+        }
+    }
+}
+
+// Turns accumulated winding into coverage, according to the fill type.
+template <typename T> T winding_to_coverage(T winding, bool evenOdd) {
+    T w = abs(winding);
+    if (evenOdd) {
+        w = w - 2 * floor(w * 0.5f);
+        return min(w, 2 - w);
+    }
+    return min(w, 1);
+}
+
+// Resolves the deltas of [lo, hi] into alphas (stored at alphas[0...]) and zeroes them. Returns
+// true if any alpha is non-zero.
+bool resolve_row(float* rowDeltas, int lo, int hi, bool evenOdd, SkAlpha* alphas) {
+    using F4 = skvx::Vec<4, float>;
+    float accumulated = 0;
+    F4 anyCoverage = 0;
+    int x = lo;
+    for (; x + 4 <= hi + 1; x += 4) {
+        F4 sum = F4::Load(rowDeltas + x);
+        F4(0).store(rowDeltas + x);
+        // Prefix sum within the four lanes, then carry in the sum of the previous pixels.
+        sum += skvx::shuffle<0, 0, 1, 2>(sum) * F4{0, 1, 1, 1};
+        sum += skvx::shuffle<0, 0, 0, 1>(sum) * F4{0, 0, 1, 1};
+        sum += accumulated;
+        accumulated = sum[3];
+        F4 coverage = winding_to_coverage(sum, evenOdd);
+        anyCoverage = max(anyCoverage, coverage);
+        skvx::cast<uint8_t>(coverage * 255 + 0.5f).store(alphas + x - lo);
+    }
+    float anyTail = 0;
+    for (; x <= hi; ++x) {
+        accumulated += rowDeltas[x];
+        rowDeltas[x] = 0;
+        float coverage = winding_to_coverage(skvx::Vec<1, float>(accumulated), evenOdd)[0];
+        anyTail = std::max(anyTail, coverage);
+        alphas[x - lo] = (SkAlpha)(coverage * 255 + 0.5f);
+    }
+    return any(anyCoverage * 255 >= 0.5f) || anyTail * 255 >= 0.5f;
+}
+
+// Blits alphas[0, count) starting at (x, y), merging runs of equal alphas.
+void blit_alphas(SkBlitter* blitter, int x, int y, SkAlpha* alphas, int16_t* runs, int count) {
+    int start = 0;
+    while (start < count) {
+        int end = start + 1;
+        while (end < count && alphas[end] == alphas[start] && end - start < SK_MaxS16) {
+            ++end;
+        }
+        runs[start] = SkToS16(end - start);
+        start = end;
+    }
+    runs[count] = 0;
+    blitter->blitAntiH(x, y, alphas, runs);
+}
+
+// Scan converts the rows [top, bottom) of the columns of bounds. lines must include every line
+// which crosses those rows, sorted by fY0.
+void fill_rows(const std::vector<const DeltaLine*>& lines, const SkIRect& bounds, int top,
+               int bottom, bool evenOdd, SkBlitter* blitter) {
+    const int width = bounds.width();
+    // One column of padding for lines clamped to the right edge, and one for the delta after it.
+    const int stride = width + 2;
+
+    SkAutoTMalloc<float> deltas(stride * kStripHeight);
+    sk_bzero(deltas.get(), stride * kStripHeight * sizeof(float));
+    SkAutoTMalloc<SkAlpha> alphas(width);
+    SkAutoTMalloc<int16_t> runs(width + 1);
+    int minX[kStripHeight], maxX[kStripHeight];
+
+    std::vector<const DeltaLine*> active;
+    size_t nextLine = 0;
+    for (int stripTop = top; stripTop < bottom; stripTop += kStripHeight) {
+        const int stripBottom = std::min(stripTop + kStripHeight, bottom);
+        active.erase(std::remove_if(active.begin(), active.end(), [&](const DeltaLine* line) {
+                         return line->fY1 <= stripTop;
+                     }),
+                     active.end());
+        while (nextLine < lines.size() && lines[nextLine]->fY0 < stripBottom) {
+            active.push_back(lines[nextLine++]);
+        }
+        if (active.empty()) {
+            if (nextLine == lines.size()) {
+                break;
+            }
+            continue;
+        }
+
+        std::fill(minX, minX + kStripHeight, stride);
+        std::fill(maxX, maxX + kStripHeight, -1);
+        for (const DeltaLine* line : active) {
+            accumulate_line(*line, deltas.get(), stride, stripTop, stripBottom, minX, maxX);
+        }
+
+        for (int y = stripTop; y < stripBottom; ++y) {
+            const int row = y - stripTop;
+            if (minX[row] > maxX[row]) {
+                continue;
+            }
+            float* rowDeltas = deltas.get() + row * stride;
+            const int lo = minX[row],
+                      hi = std::min(maxX[row], width - 1);
+            if (lo <= hi && resolve_row(rowDeltas, lo, hi, evenOdd, alphas.get())) {
+                blit_alphas(blitter, bounds.fLeft + lo, y, alphas.get(), runs.get(), hi - lo + 1);
+            }
+            // Deltas past the last column are never resolved, but must not leak into the next
+            // strip.
+            std::fill(rowDeltas + std::max(lo, hi + 1), rowDeltas + maxX[row] + 1, 0.0f);
+        }
+    }
+}
+
+// Flattens the path into the lines which cross the rows of bounds, sorted by fY0.
+std::vector<DeltaLine> build_sorted_lines(const SkPath& path, const SkIRect& bounds) {
+    LineBuilder builder(bounds.fLeft, bounds.width());
+    builder.addPath(path);
+    std::vector<DeltaLine> lines = std::move(builder.lines());
+    lines.erase(std::remove_if(lines.begin(), lines.end(), [&](const DeltaLine& line) {
+                    return line.fY1 <= bounds.fTop || line.fY0 >= bounds.fBottom;
+                }),
+                lines.end());
+    std::sort(lines.begin(), lines.end(), [](const DeltaLine& a, const DeltaLine& b) {
+        return a.fY0 < b.fY0;
+    });
+    return lines;
+}
+
+}  // namespace
+
+void SkScan::DAAFillPath(const SkPath&  path,
+                         SkBlitter*     blitter,
+                         const SkIRect& ir,
+                         const SkIRect& clipBounds,
+                         bool           forceRLE) {
+    // The caller handles the area outside of ir for inverse fills, but not the area inside it.
+    SkASSERT(!path.isInverseFillType());
+
+    SkIRect bounds;
+    if (!bounds.intersect(ir, clipBounds)) {
+        return;
+    }
+
+    std::vector<DeltaLine> lines = build_sorted_lines(path, bounds);
+    std::vector<const DeltaLine*> sorted(lines.size());
+    for (size_t index = 0; index < lines.size(); ++index) {
+        sorted[index] = &lines[index];
+    }
+    fill_rows(sorted, bounds, bounds.fTop, bounds.fBottom,
+              path.getFillType() == SkPathFillType::kEvenOdd, blitter);
+}
+
+bool SkScan::AntiFillPathBands(const SkPath& path, const SkRasterClip& clip, SkExecutor* executor,
+                               const BandBlitterProc& makeBlitter) {
+    if (path.isInverseFillType() || !path.isFinite()) {
+        return false;
+    }
+    if (clip.isEmpty()) {
+        return true;
+    }
+
+    SkIRect bounds = path.getBounds().roundOut();
+    if (!bounds.intersect(clip.getBounds())) {
+        return true;
+    }
+    // Like the other scan converters, blits are limited to coordinates which fit in an int16_t.
+    static constexpr int32_t kMaxCoord = 32767;
+    if (bounds.fLeft < -kMaxCoord || bounds.fTop < -kMaxCoord ||
+        bounds.fRight > kMaxCoord || bounds.fBottom > kMaxCoord ||
+        bounds.height() < 2 * kMinBandHeight ||
+        (int64_t)bounds.width() * bounds.height() < kMinBandedArea) {
+        return false;
+    }
+
+    const bool evenOdd = path.getFillType() == SkPathFillType::kEvenOdd;
+    std::vector<DeltaLine> lines = build_sorted_lines(path, bounds);
+
+    int bandHeight = std::max(kMinBandHeight, (bounds.height() + kMaxBands - 1) / kMaxBands);
+    bandHeight = (bandHeight + kStripHeight - 1) / kStripHeight * kStripHeight;
+    const int bandCount = (bounds.height() + bandHeight - 1) / bandHeight;
+
+    // Each band gets the lines which cross its rows, still sorted by fY0.
+    std::vector<std::vector<const DeltaLine*>> bands(bandCount);
+    for (const DeltaLine& line : lines) {
+        int first = (std::max(SkScalarFloorToInt(line.fY0), bounds.fTop) - bounds.fTop) /
+                    bandHeight,
+            last  = (std::min(SkScalarCeilToInt(line.fY1), bounds.fBottom) - 1 - bounds.fTop) /
+                    bandHeight;
+        for (int band = first; band <= last; ++band) {
+            bands[band].push_back(&line);
+        }
+    }
+
+    SkTaskGroup taskGroup(*executor);
+    taskGroup.batch(bandCount, [&](int band) {
+        if (bands[band].empty()) {
+            return;
+        }
+        SkIRect bandBounds = bounds;
+        bandBounds.fTop = bounds.fTop + band * bandHeight;
+        bandBounds.fBottom = std::min(bandBounds.fTop + bandHeight, bounds.fBottom);
+
+        SkSTArenaAlloc<kSkBlitterContextSize> alloc;
+        SkBlitter* blitter = makeBlitter(&alloc);
+
+        SkRegion clipBoundsRgn;
+        SkAAClipBlitter aaBlitter;
+        const SkRegion* clipRgn = &clipBoundsRgn;
+        if (clip.isBW()) {
+            clipRgn = &clip.bwRgn();
+        } else {
+            clipBoundsRgn.setRect(clip.getBounds());
+            aaBlitter.init(blitter, &clip.aaRgn());
+            blitter = &aaBlitter;
+        }
+        SkScanClipper clipper(blitter, clipRgn, bandBounds);
+        if (clipper.getBlitter()) {
+            fill_rows(bands[band], bounds, bandBounds.fTop, bandBounds.fBottom, evenOdd,
+                      clipper.getBlitter());
+        }
+    });
+    taskGroup.wait();
+    return true;
+}
@@ -187,11 +187,14 @@ static bool intersect(SkPixmap* dst, SkPixmap* src, int srcDx, int srcDy) {
 
 sk_sp<SkSpecialImage> SkArithmeticImageFilter::onFilterImage(const Context& ctx,
                                                              SkIPoint* offset) const {
+    skif::FilterResult inputs[2];
+    this->filterInputs(ctx, inputs);
+
     SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, ctx, &backgroundOffset));
+    sk_sp<SkSpecialImage> background = inputs[0].imageAndOffset(&backgroundOffset);
 
     SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, ctx, &foregroundOffset));
+    sk_sp<SkSpecialImage> foreground = inputs[1].imageAndOffset(&foregroundOffset);
 
     SkIRect foregroundBounds = SkIRect::MakeEmpty();
     if (foreground) {
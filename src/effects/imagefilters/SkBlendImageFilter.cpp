@@ -128,11 +128,14 @@ void SkBlendImageFilter::flatten(SkWriteBuffer& buffer) const {
 
 sk_sp<SkSpecialImage> SkBlendImageFilter::onFilterImage(const Context& ctx,
                                                         SkIPoint* offset) const {
+    skif::FilterResult inputs[2];
+    this->filterInputs(ctx, inputs);
+
     SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, ctx, &backgroundOffset));
+    sk_sp<SkSpecialImage> background = inputs[0].imageAndOffset(&backgroundOffset);
 
     SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, ctx, &foregroundOffset));
+    sk_sp<SkSpecialImage> foreground = inputs[1].imageAndOffset(&foregroundOffset);
 
     SkIRect foregroundBounds = SkIRect::MakeEmpty();
     if (foreground) {
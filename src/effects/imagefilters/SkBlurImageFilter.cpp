@@ -842,8 +842,17 @@ sk_sp<SkSpecialImage> cpu_blur(
         return nullptr;
     }
 
-    size_t bufferSizeBytes = std::max(makerX->bufferSizeBytes(), makerY->bufferSizeBytes());
-    auto buffer = alloc.makeBytesAlignedTo(bufferSizeBytes, alignof(skvx::Vec<4, uint32_t>));
+    // Rows and columns are blurred independently, so each pass is split into bands that can run
+    // concurrently. Each band needs a pass of its own, since passes keep their sums in a buffer.
+    auto runPass = [&ctx](const PassMaker* maker, int count, int itemPixels,
+                          const std::function<void(Pass*, int start, int end)>& fn) {
+        ctx.forEachBand(count, itemPixels, [&](int start, int end) {
+            SkSTArenaAlloc<1024> bandAlloc;
+            auto buffer = bandAlloc.makeBytesAlignedTo(maker->bufferSizeBytes(),
+                                                       alignof(skvx::Vec<4, uint32_t>));
+            fn(maker->makePass(buffer, &bandAlloc), start, end);
+        });
+    };
 
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
@@ -873,7 +882,6 @@ sk_sp<SkSpecialImage> cpu_blur(
     }
 
     if (makerX->window() > 1) {
-        Pass* pass = makerX->makePass(buffer, &alloc);
         // Make int64 to avoid overflow in multiplication below.
         int64_t shift = srcBounds.top() - dstBounds.top();
 
@@ -886,27 +894,30 @@ sk_sp<SkSpecialImage> cpu_blur(
         intermediateWidth = dstW;
         intermediateDst = static_cast<uint32_t *>(dst.getPixels());
 
-        const uint32_t* srcCursor = static_cast<uint32_t*>(src.getPixels());
-        uint32_t* dstCursor = intermediateSrc;
-        for (auto y = 0; y < srcH; y++) {
-            pass->blur(srcBounds.left(), srcBounds.right(), dstBounds.right(),
-                      srcCursor, 1, dstCursor, 1);
-            srcCursor += src.rowBytesAsPixels();
-            dstCursor += intermediateRowBytesAsPixels;
-        }
+        runPass(makerX, srcH, dstW, [&](Pass* pass, int start, int end) {
+            const uint32_t* srcCursor = src.getAddr32(0, start);
+            uint32_t* dstCursor = intermediateSrc + (int64_t)start * intermediateRowBytesAsPixels;
+            for (auto y = start; y < end; y++) {
+                pass->blur(srcBounds.left(), srcBounds.right(), dstBounds.right(),
+                           srcCursor, 1, dstCursor, 1);
+                srcCursor += src.rowBytesAsPixels();
+                dstCursor += intermediateRowBytesAsPixels;
+            }
+        });
     }
 
     if (makerY->window() > 1) {
-        Pass* pass = makerY->makePass(buffer, &alloc);
-        const uint32_t* srcCursor = intermediateSrc;
-        uint32_t* dstCursor = intermediateDst;
-        for (auto x = 0; x < intermediateWidth; x++) {
-            pass->blur(srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
-                       srcCursor, intermediateRowBytesAsPixels,
-                       dstCursor, dst.rowBytesAsPixels());
-            srcCursor += 1;
-            dstCursor += 1;
-        }
+        runPass(makerY, intermediateWidth, dstH, [&](Pass* pass, int start, int end) {
+            const uint32_t* srcCursor = intermediateSrc + start;
+            uint32_t* dstCursor = intermediateDst + start;
+            for (auto x = start; x < end; x++) {
+                pass->blur(srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
+                           srcCursor, intermediateRowBytesAsPixels,
+                           dstCursor, dst.rowBytesAsPixels());
+                srcCursor += 1;
+                dstCursor += 1;
+            }
+        });
     }
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(),
@@ -97,8 +97,9 @@ sk_sp<SkSpecialImage> SkComposeImageFilter::onFilterImage(const Context& ctx,
     // were already created, there's no alternative way for the leaf nodes of the outer DAG to
     // get the results of the inner DAG. Overriding the source image of the context has the correct
     // effect, but means that the source image is not fixed for the entire filter process.
-    Context outerContext(outerMatrix, clipBounds, ctx.cache(), ctx.colorType(), ctx.colorSpace(),
-                         inner.get());
+    Context outerContext = Context(outerMatrix, clipBounds, ctx.cache(), ctx.colorType(),
+                                   ctx.colorSpace(), inner.get())
+                                   .withNewExecutor(ctx.executor());
 
     SkIPoint outerOffset = SkIPoint::Make(0, 0);
     sk_sp<SkSpecialImage> outer(this->filterInput(0, outerContext, &outerOffset));
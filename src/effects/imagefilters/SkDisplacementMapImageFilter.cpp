@@ -227,13 +227,6 @@ static void compute_displacement(Extractor ex, const SkVector& scale, SkBitmap*
 
 sk_sp<SkSpecialImage> SkDisplacementMapImageFilter::onFilterImage(const Context& ctx,
                                                                   SkIPoint* offset) const {
-    SkIPoint colorOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> color(this->filterInput(1, ctx, &colorOffset));
-    if (!color) {
-        return nullptr;
-    }
-
-    SkIPoint displOffset = SkIPoint::Make(0, 0);
     // Creation of the displacement map should happen in a non-colorspace aware context. This
     // texture is a purely mathematical construct, so we want to just operate on the stored
     // values. Consider:
@@ -244,9 +237,21 @@ sk_sp<SkSpecialImage> SkDisplacementMapImageFilter::onFilterImage(const Context&
     // With a more complex DAG attached to this input, it's not clear that working in ANY specific
     // color space makes sense, so we ignore color spaces (and gamma) entirely. This may not be
     // ideal, but it's at least consistent and predictable.
-    Context displContext(ctx.mapping(), ctx.desiredOutput(), ctx.cache(),
-                         kN32_SkColorType, nullptr, ctx.source());
-    sk_sp<SkSpecialImage> displ(this->filterInput(0, displContext, &displOffset));
+    Context displContext = Context(ctx.mapping(), ctx.desiredOutput(), ctx.cache(),
+                                   kN32_SkColorType, nullptr, ctx.source())
+                                   .withNewExecutor(ctx.executor());
+    const Context* contexts[2] = { &displContext, &ctx };
+    skif::FilterResult inputs[2];
+    this->filterInputs(contexts, inputs);
+
+    SkIPoint colorOffset = SkIPoint::Make(0, 0);
+    sk_sp<SkSpecialImage> color = inputs[1].imageAndOffset(&colorOffset);
+    if (!color) {
+        return nullptr;
+    }
+
+    SkIPoint displOffset = SkIPoint::Make(0, 0);
+    sk_sp<SkSpecialImage> displ = inputs[0].imageAndOffset(&displOffset);
     if (!displ) {
         return nullptr;
     }
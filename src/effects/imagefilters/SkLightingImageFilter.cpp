@@ -288,14 +288,16 @@ static void lightBitmap(const BaseLightingType& lightingType,
                  const SkBitmap& src,
                  SkBitmap* dst,
                  SkScalar surfaceScale,
-                 const SkIRect& bounds) {
+                 const SkIRect& bounds,
+                 int startY, int endY) {
     SkASSERT(dst->width() == bounds.width() && dst->height() == bounds.height());
+    SkASSERT(bounds.top() <= startY && startY < endY && endY <= bounds.bottom());
     int left = bounds.left(), right = bounds.right();
     int bottom = bounds.bottom();
-    int y = bounds.top();
+    int y = startY;
     SkIRect srcBounds = src.bounds();
-    SkPMColor* dptr = dst->getAddr32(0, 0);
-    {
+    SkPMColor* dptr = dst->getAddr32(0, startY - bounds.top());
+    if (y == bounds.top()) {
         int x = left;
         int m[9];
         m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
@@ -318,9 +320,10 @@ static void lightBitmap(const BaseLightingType& lightingType,
         surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
         *dptr++ = lightingType.light(topRightNormal(m, surfaceScale), surfaceToLight,
                                      l->lightColor(surfaceToLight));
+        ++y;
     }
 
-    for (++y; y < bottom - 1; ++y) {
+    for (; y < std::min(endY, bottom - 1); ++y) {
         int x = left;
         int m[9];
         m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
@@ -347,7 +350,8 @@ static void lightBitmap(const BaseLightingType& lightingType,
                                      l->lightColor(surfaceToLight));
     }
 
-    {
+    if (endY == bottom) {
+        SkASSERT(y == bottom - 1);
         int x = left;
         int m[9];
         m[1] = PixelFetcher::Fetch(src, x,     bottom - 2, srcBounds);
@@ -373,19 +377,26 @@ static void lightBitmap(const BaseLightingType& lightingType,
     }
 }
 
-static void lightBitmap(const BaseLightingType& lightingType,
+// Every row only depends on the input, so bands of rows can be lit concurrently.
+static void lightBitmap(const SkImageFilter_Base::Context& ctx,
+                 const BaseLightingType& lightingType,
                  const SkImageFilterLight* light,
                  const SkBitmap& src,
                  SkBitmap* dst,
                  SkScalar surfaceScale,
                  const SkIRect& bounds) {
-    if (src.bounds().contains(bounds)) {
-        lightBitmap<UncheckedPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
-    } else {
-        lightBitmap<DecalPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
-    }
+    bool unchecked = src.bounds().contains(bounds);
+    ctx.forEachBand(bounds.height(), bounds.width(), [&](int start, int end) {
+        int startY = bounds.top() + start,
+            endY   = bounds.top() + end;
+        if (unchecked) {
+            lightBitmap<UncheckedPixelFetcher>(
+                lightingType, light, src, dst, surfaceScale, bounds, startY, endY);
+        } else {
+            lightBitmap<DecalPixelFetcher>(
+                lightingType, light, src, dst, surfaceScale, bounds, startY, endY);
+        }
+    });
 }
 
 namespace {
@@ -420,6 +431,8 @@ protected:
     }
 
     bool onAffectsTransparentBlack() const override { return true; }
+    // The edges of the filtered area are lit as the edges of the surface.
+    bool onCanFilterTiles() const override { return false; }
 
     const SkImageFilterLight* light() const { return fLight.get(); }
     inline sk_sp<const SkImageFilterLight> refLight() const { return fLight; }
@@ -1314,7 +1327,7 @@ sk_sp<SkSpecialImage> SkDiffuseLightingImageFilter::onFilterImage(const Context&
     sk_sp<SkImageFilterLight> transformedLight(light()->transform(matrix));
 
     DiffuseLightingType lightingType(fKD);
-    lightBitmap(lightingType,
+    lightBitmap(ctx, lightingType,
                                                              transformedLight.get(),
                                                              inputBM,
                                                              &dst,
@@ -1456,7 +1469,7 @@ sk_sp<SkSpecialImage> SkSpecularLightingImageFilter::onFilterImage(const Context
 
     sk_sp<SkImageFilterLight> transformedLight(light()->transform(matrix));
 
-    lightBitmap(lightingType,
+    lightBitmap(ctx, lightingType,
                                                               transformedLight.get(),
                                                               inputBM,
                                                               &dst,
@@ -39,6 +39,8 @@ protected:
     void flatten(SkWriteBuffer&) const override;
 
     sk_sp<SkSpecialImage> onFilterImage(const Context&, SkIPoint* offset) const override;
+    // The zoom is relative to the filtered area.
+    bool onCanFilterTiles() const override { return false; }
 
 private:
     friend void ::SkRegisterMagnifierImageFilterFlattenable();
@@ -12,6 +12,8 @@
 #include "include/effects/SkImageFilters.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
@@ -26,6 +28,43 @@
 
 namespace {
 
+using float4 = skvx::Vec<4, float>;
+
+// Writes 'row' and 'column' such that kernel[y][x] == column[y] * row[x], if the kernel is (to
+// within float precision) the outer product of two vectors. Blurs and box filters usually are.
+bool separate_kernel(const SkISize& size, const SkScalar* kernel,
+                     SkScalar* row, SkScalar* column) {
+    // Factor around the largest entry so the division below is as well conditioned as possible.
+    int pivot = 0;
+    for (int i = 1; i < size.area(); ++i) {
+        if (SkScalarAbs(kernel[i]) > SkScalarAbs(kernel[pivot])) {
+            pivot = i;
+        }
+    }
+    const SkScalar pivotValue = kernel[pivot];
+    if (pivotValue == 0 || !SkScalarIsFinite(pivotValue)) {
+        return false;
+    }
+    const int px = pivot % size.width(),
+              py = pivot / size.width();
+    for (int x = 0; x < size.width(); ++x) {
+        row[x] = kernel[py * size.width() + x];
+    }
+    for (int y = 0; y < size.height(); ++y) {
+        column[y] = kernel[y * size.width() + px] / pivotValue;
+    }
+
+    const SkScalar tolerance = SkScalarAbs(pivotValue) * 1e-6f;
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            if (!(SkScalarAbs(kernel[y * size.width() + x] - column[y] * row[x]) <= tolerance)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 class SkMatrixConvolutionImageFilter final : public SkImageFilter_Base {
 public:
     SkMatrixConvolutionImageFilter(const SkISize& kernelSize, const SkScalar* kernel,
@@ -45,6 +84,16 @@ public:
         SkASSERT(kernelSize.fWidth >= 1 && kernelSize.fHeight >= 1);
         SkASSERT(kernelOffset.fX >= 0 && kernelOffset.fX < kernelSize.fWidth);
         SkASSERT(kernelOffset.fY >= 0 && kernelOffset.fY < kernelSize.fHeight);
+
+        // Two 1D passes only win once they're cheaper than the 2D kernel.
+        int w = kernelSize.width(), h = kernelSize.height();
+        if (w > 1 && h > 1 && (int64_t)w * h > 2 * ((int64_t)w + h)) {
+            fSeparableKernel.reset(w + h);
+            if (!separate_kernel(kernelSize, fKernel, fSeparableKernel.get(),
+                                 fSeparableKernel.get() + w)) {
+                fSeparableKernel.reset(0);
+            }
+        }
     }
 
     ~SkMatrixConvolutionImageFilter() override {
@@ -71,6 +120,8 @@ private:
     SkIPoint    fKernelOffset;
     SkTileMode  fTileMode;
     bool        fConvolveAlpha;
+    // The row kernel followed by the column kernel, or null if the kernel isn't separable.
+    SkAutoTMalloc<SkScalar> fSeparableKernel;
 
     template <class PixelFetcher, bool convolveAlpha>
     void filterPixels(const SkBitmap& src,
@@ -84,6 +135,12 @@ private:
                       SkIVector& offset,
                       const SkIRect& rect,
                       const SkIRect& bounds) const;
+    template <bool convolveAlpha>
+    void filterSeparablePixels(const SkBitmap& src,
+                               SkBitmap* result,
+                               SkIVector& offset,
+                               SkIRect rect,
+                               const SkIRect& bounds) const;
     void filterInteriorPixels(const SkBitmap& src,
                               SkBitmap* result,
                               SkIVector& offset,
@@ -140,6 +197,31 @@ public:
     }
 };
 
+// Pixels are convolved with all four channels in a float vector, in SkPMColor byte order.
+static constexpr int kA = SK_A32_SHIFT / 8,
+                     kR = SK_R32_SHIFT / 8,
+                     kG = SK_G32_SHIFT / 8,
+                     kB = SK_B32_SHIFT / 8;
+
+float4 load_pixel(SkPMColor c) {
+    return skvx::cast<float>(skvx::Vec<4, uint8_t>::Load(&c));
+}
+
+// Applies gain and bias to a convolved pixel, and packs it. When alpha isn't convolved, 'srcPixel'
+// is the (unpremul) source pixel at the same location, which provides the output's alpha.
+template <bool convolveAlpha>
+SkPMColor finish_pixel(const float4& sum, float gain, float bias, SkPMColor srcPixel) {
+    float4 color = skvx::floor(sum * gain + bias);
+    float a = convolveAlpha ? SkTPin(color[kA], 0.f, 255.f) : 255.f;
+    skvx::Vec<4, int> c = skvx::cast<int>(skvx::pin(color, float4(0), float4(a)));
+    if (!convolveAlpha) {
+        return SkPreMultiplyARGB(SkGetPackedA32(srcPixel), c[kR], c[kG], c[kB]);
+    }
+    SkPMColor result;
+    skvx::cast<uint8_t>(c).store(&result);
+    return result;
+}
+
 } // end namespace
 
 sk_sp<SkImageFilter> SkImageFilters::MatrixConvolution(const SkISize& kernelSize,
@@ -243,33 +325,70 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
     for (int y = rect.fTop; y < rect.fBottom; ++y) {
         SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
         for (int x = rect.fLeft; x < rect.fRight; ++x) {
-            SkScalar sumA = 0, sumR = 0, sumG = 0, sumB = 0;
+            float4 sum = 0;
             for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
                 for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
                     SkPMColor s = PixelFetcher::fetch(src,
                                                       x + cx - fKernelOffset.fX,
                                                       y + cy - fKernelOffset.fY,
                                                       bounds);
-                    SkScalar k = fKernel[cy * fKernelSize.fWidth + cx];
-                    if (convolveAlpha) {
-                        sumA += SkGetPackedA32(s) * k;
-                    }
-                    sumR += SkGetPackedR32(s) * k;
-                    sumG += SkGetPackedG32(s) * k;
-                    sumB += SkGetPackedB32(s) * k;
+                    sum += load_pixel(s) * fKernel[cy * fKernelSize.fWidth + cx];
                 }
             }
-            int a = convolveAlpha
-                  ? SkTPin(SkScalarFloorToInt(sumA * fGain + fBias), 0, 255)
-                  : 255;
-            int r = SkTPin(SkScalarFloorToInt(sumR * fGain + fBias), 0, a);
-            int g = SkTPin(SkScalarFloorToInt(sumG * fGain + fBias), 0, a);
-            int b = SkTPin(SkScalarFloorToInt(sumB * fGain + fBias), 0, a);
-            if (!convolveAlpha) {
-                a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
-                *dptr++ = SkPreMultiplyARGB(a, r, g, b);
-            } else {
-                *dptr++ = SkPackARGB32(a, r, g, b);
+            SkPMColor srcPixel = convolveAlpha ? 0 : PixelFetcher::fetch(src, x, y, bounds);
+            *dptr++ = finish_pixel<convolveAlpha>(sum, fGain, fBias, srcPixel);
+        }
+    }
+}
+
+// Convolves 'rect', which must not sample outside of 'bounds', with the row kernel and then the
+// column kernel. Rows are filtered in strips so the horizontal results stay in cache.
+template<bool convolveAlpha>
+void SkMatrixConvolutionImageFilter::filterSeparablePixels(const SkBitmap& src,
+                                                           SkBitmap* result,
+                                                           SkIVector& offset,
+                                                           SkIRect rect,
+                                                           const SkIRect& bounds) const {
+    static constexpr int kStripRows = 16;
+
+    if (!rect.intersect(bounds)) {
+        return;
+    }
+    const int kw = fKernelSize.width(),
+              kh = fKernelSize.height();
+    const SkScalar* rowKernel = fSeparableKernel.get();
+    const SkScalar* columnKernel = fSeparableKernel.get() + kw;
+    const int width = rect.width();
+
+    SkAutoTMalloc<float4> rows(width * (kStripRows + kh - 1));
+    for (int stripTop = rect.fTop; stripTop < rect.fBottom; stripTop += kStripRows) {
+        int stripBottom = std::min(stripTop + kStripRows, rect.fBottom);
+
+        // Horizontal pass over every source row the strip's outputs read.
+        int srcTop = stripTop - fKernelOffset.fY;
+        for (int sy = 0; sy < stripBottom - stripTop + kh - 1; ++sy) {
+            const SkPMColor* sptr = src.getAddr32(rect.fLeft - fKernelOffset.fX, srcTop + sy);
+            float4* row = rows.get() + sy * width;
+            for (int x = 0; x < width; ++x) {
+                float4 sum = 0;
+                for (int cx = 0; cx < kw; ++cx) {
+                    sum += load_pixel(sptr[x + cx]) * rowKernel[cx];
+                }
+                row[x] = sum;
+            }
+        }
+
+        // Vertical pass.
+        for (int y = stripTop; y < stripBottom; ++y) {
+            SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
+            const float4* column = rows.get() + (y - stripTop) * width;
+            for (int x = 0; x < width; ++x) {
+                float4 sum = 0;
+                for (int cy = 0; cy < kh; ++cy) {
+                    sum += column[cy * width + x] * columnKernel[cy];
+                }
+                SkPMColor srcPixel = convolveAlpha ? 0 : *src.getAddr32(rect.fLeft + x, y);
+                *dptr++ = finish_pixel<convolveAlpha>(sum, fGain, fBias, srcPixel);
             }
         }
     }
@@ -303,7 +422,15 @@ void SkMatrixConvolutionImageFilter::filterInteriorPixels(const SkBitmap& src,
         case SkTileMode::kClamp:
             // Fall through
         case SkTileMode::kDecal:
-            filterPixels<UncheckedPixelFetcher>(src, result, offset, rect, bounds);
+            if (fSeparableKernel) {
+                if (fConvolveAlpha) {
+                    filterSeparablePixels<true>(src, result, offset, rect, bounds);
+                } else {
+                    filterSeparablePixels<false>(src, result, offset, rect, bounds);
+                }
+            } else {
+                filterPixels<UncheckedPixelFetcher>(src, result, offset, rect, bounds);
+            }
             break;
     }
 }
@@ -419,9 +546,15 @@ sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilter::onFilterImage(const Contex
 
     if (!fConvolveAlpha && !inputBM.isOpaque()) {
         // This leaves the bitmap tagged as premul, which seems weird to me,
-        // but is consistent with old behavior.
-        inputBM.readPixels(inputBM.info().makeAlphaType(kUnpremul_SkAlphaType),
-                           inputBM.getPixels(), inputBM.rowBytes(), 0,0);
+        // but is consistent with old behavior. The input's pixels may be shared with other
+        // branches of the filter DAG, so they're unpremultiplied into a copy.
+        SkBitmap unpremul;
+        if (!unpremul.tryAllocPixels(inputBM.info()) ||
+            !inputBM.readPixels(inputBM.info().makeAlphaType(kUnpremul_SkAlphaType),
+                                unpremul.getPixels(), unpremul.rowBytes(), 0, 0)) {
+            return nullptr;
+        }
+        inputBM = unpremul;
     }
 
     if (!inputBM.getPixels()) {
@@ -464,11 +597,21 @@ sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilter::onFilterImage(const Contex
 
     SkIVector dstContentOffset = { offset->fX - inputOffset.fX, offset->fY - inputOffset.fY };
 
-    this->filterBorderPixels(inputBM, &dst, dstContentOffset, top, srcBounds);
-    this->filterBorderPixels(inputBM, &dst, dstContentOffset, left, srcBounds);
-    this->filterInteriorPixels(inputBM, &dst, dstContentOffset, interior, srcBounds);
-    this->filterBorderPixels(inputBM, &dst, dstContentOffset, right, srcBounds);
-    this->filterBorderPixels(inputBM, &dst, dstContentOffset, bottom, srcBounds);
+    // Every output pixel only depends on the input, so bands of rows can be filtered concurrently.
+    int kernelArea = fKernelSize.width() * fKernelSize.height();
+    ctx.forEachBand(dstBounds.height(), dstBounds.width() * kernelArea, [&](int start, int end) {
+        SkIRect band = SkIRect::MakeLTRB(dstBounds.left(), dstBounds.top() + start,
+                                         dstBounds.right(), dstBounds.top() + end);
+        auto clip = [&band](const SkIRect& rect) {
+            SkIRect clipped;
+            return clipped.intersect(rect, band) ? clipped : SkIRect::MakeEmpty();
+        };
+        this->filterBorderPixels(inputBM, &dst, dstContentOffset, clip(top), srcBounds);
+        this->filterBorderPixels(inputBM, &dst, dstContentOffset, clip(left), srcBounds);
+        this->filterInteriorPixels(inputBM, &dst, dstContentOffset, clip(interior), srcBounds);
+        this->filterBorderPixels(inputBM, &dst, dstContentOffset, clip(right), srcBounds);
+        this->filterBorderPixels(inputBM, &dst, dstContentOffset, clip(bottom), srcBounds);
+    });
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(), dstBounds.height()),
                                           dst, ctx.surfaceProps());
@@ -71,9 +71,11 @@ sk_sp<SkSpecialImage> SkMergeImageFilter::onFilterImage(const Context& ctx,
     std::unique_ptr<SkIPoint[]> offsets(new SkIPoint[inputCount]);
 
     // Filter all of the inputs.
+    std::unique_ptr<skif::FilterResult[]> results(new skif::FilterResult[inputCount]);
+    this->filterInputs(ctx, results.get());
     for (int i = 0; i < inputCount; ++i) {
         offsets[i] = { 0, 0 };
-        inputs[i] = this->filterInput(i, ctx, &offsets[i]);
+        inputs[i] = results[i].imageAndOffset(&offsets[i]);
         if (!inputs[i]) {
             continue;
         }
@@ -9,6 +9,7 @@
 #include "include/core/SkRect.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkTemplates.h"
 #include "include/private/SkVx.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
@@ -31,10 +32,6 @@
 #include "src/gpu/glsl/GrGLSLUniformHandler.h"
 #endif
 
-#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
-    #include <immintrin.h>
-#endif
-
 namespace {
 
 enum class MorphType {
@@ -142,20 +139,28 @@ void SkMorphologyImageFilter::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static void call_proc_X(SkMorphologyImageFilter::Proc procX,
+// Each row is processed independently in X (and each column in Y), so the procs are called on
+// bands of them, which may run concurrently.
+static void call_proc_X(const SkImageFilter_Base::Context& ctx,
+                        SkMorphologyImageFilter::Proc procX,
                         const SkBitmap& src, SkBitmap* dst,
                         int radiusX, const SkIRect& bounds) {
-    procX(src.getAddr32(bounds.left(), bounds.top()), dst->getAddr32(0, 0),
-          radiusX, bounds.width(), bounds.height(),
-          src.rowBytesAsPixels(), dst->rowBytesAsPixels());
+    ctx.forEachBand(bounds.height(), bounds.width(), [&](int start, int end) {
+        procX(src.getAddr32(bounds.left(), bounds.top() + start), dst->getAddr32(0, start),
+              radiusX, bounds.width(), end - start,
+              src.rowBytesAsPixels(), dst->rowBytesAsPixels());
+    });
 }
 
-static void call_proc_Y(SkMorphologyImageFilter::Proc procY,
+static void call_proc_Y(const SkImageFilter_Base::Context& ctx,
+                        SkMorphologyImageFilter::Proc procY,
                         const SkPMColor* src, int srcRowBytesAsPixels, SkBitmap* dst,
                         int radiusY, const SkIRect& bounds) {
-    procY(src, dst->getAddr32(0, 0),
-          radiusY, bounds.height(), bounds.width(),
-          srcRowBytesAsPixels, dst->rowBytesAsPixels());
+    ctx.forEachBand(bounds.width(), bounds.height(), [&](int start, int end) {
+        procY(src + start, dst->getAddr32(start, 0),
+              radiusY, bounds.height(), end - start,
+              srcRowBytesAsPixels, dst->rowBytesAsPixels());
+    });
 }
 
 SkRect SkMorphologyImageFilter::computeFastBounds(const SkRect& src) const {
@@ -506,117 +511,127 @@ static sk_sp<SkSpecialImage> apply_morphology(
 
 namespace {
 
-#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
-    template<MorphType type, MorphDirection direction>
-    static void morph(const SkPMColor* src, SkPMColor* dst,
-                      int radius, int width, int height, int srcStride, int dstStride) {
-        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
-        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
-        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
-        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
-        radius = std::min(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
+// Windows at least this wide are filtered with the van Herk/Gil-Werman algorithm, which takes three
+// min/max per pixel no matter the radius, rather than by scanning the whole window.
+static constexpr int kMinVanHerkRadius = 3;
+
+// The pixels of kLines adjacent lines (rows in X, columns in Y) at one position along them, with
+// every channel in its own lane.
+template <int kLines> using Pixels = skvx::Vec<4 * kLines, uint8_t>;
+
+template <MorphDirection direction, int kLines>
+static Pixels<kLines> load(const SkPMColor* src, int lineStride) {
+    if (direction == MorphDirection::kY) {
+        // Adjacent columns are adjacent in memory.
+        return Pixels<kLines>::Load(src);
+    }
+    SkPMColor pixels[kLines];
+    for (int i = 0; i < kLines; ++i) {
+        pixels[i] = src[i * lineStride];
+    }
+    return Pixels<kLines>::Load(pixels);
+}
+
+template <MorphDirection direction, int kLines>
+static void store(SkPMColor* dst, int lineStride, const Pixels<kLines>& pixels) {
+    if (direction == MorphDirection::kY) {
+        pixels.store(dst);
+        return;
+    }
+    SkPMColor stored[kLines];
+    pixels.store(stored);
+    for (int i = 0; i < kLines; ++i) {
+        dst[i * lineStride] = stored[i];
+    }
+}
+
+template <MorphType type, int kLines>
+static Pixels<kLines> extreme(const Pixels<kLines>& a, const Pixels<kLines>& b) {
+    return type == MorphType::kDilate ? max(a, b) : min(a, b);
+}
+
+// Each output pixel is the extreme of the input pixels within 'radius' of it along the line,
+// ignoring those past the ends of the line. 'scratch' must hold 2 * (width + 2 * radius) entries
+// when radius is at least kMinVanHerkRadius.
+template <MorphType type, MorphDirection direction, int kLines>
+static void morph_lines(const SkPMColor* src, SkPMColor* dst, int radius, int width,
+                        int srcStride, int dstStride, Pixels<kLines>* scratch) {
+    const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
+    const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
+    const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
+    const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
+
+    if (radius < kMinVanHerkRadius) {
         for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                __m128i extreme = (type == MorphType::kDilate) ? _mm_setzero_si128()
-                                                               : _mm_set1_epi32(0xFFFFFFFF);
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    __m128i src_pixel = _mm_cvtsi32_si128(*p);
-                    extreme = (type == MorphType::kDilate) ? _mm_max_epu8(src_pixel, extreme)
-                                                           : _mm_min_epu8(src_pixel, extreme);
-                }
-                *dptr = _mm_cvtsi128_si32(extreme);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
+            int lower = std::max(x - radius, 0),
+                upper = std::min(x + radius, width - 1);
+            Pixels<kLines> result = load<direction, kLines>(src + lower * srcStrideX, srcStrideY);
+            for (int i = lower + 1; i <= upper; ++i) {
+                result = extreme<type, kLines>(
+                        result, load<direction, kLines>(src + i * srcStrideX, srcStrideY));
             }
-            if (x >= radius) { src += srcStrideX; }
-            if (x + radius < width - 1) { upperSrc += srcStrideX; }
-            dst += dstStrideX;
+            store<direction, kLines>(dst + x * dstStrideX, dstStrideY, result);
         }
+        return;
     }
 
-#elif defined(SK_ARM_HAS_NEON)
-    template<MorphType type, MorphDirection direction>
-    static void morph(const SkPMColor* src, SkPMColor* dst,
-                      int radius, int width, int height, int srcStride, int dstStride) {
-        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
-        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
-        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
-        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
-        radius = std::min(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                uint8x8_t extreme = vdup_n_u8(type == MorphType::kDilate ? 0 : 255);
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    uint8x8_t src_pixel = vreinterpret_u8_u32(vdup_n_u32(*p));
-                    extreme = (type == MorphType::kDilate) ? vmax_u8(src_pixel, extreme)
-                                                           : vmin_u8(src_pixel, extreme);
-                }
-                *dptr = vget_lane_u32(vreinterpret_u32_u8(extreme), 0);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
-            }
-            if (x >= radius) src += srcStrideX;
-            if (x + radius < width - 1) upperSrc += srcStrideX;
-            dst += dstStrideX;
+    // The line is padded with 'radius' pixels on each end that don't change the extreme, and split
+    // into blocks as wide as the window. Each window then spans the end of one block and the start
+    // of the next, so its extreme is that of the suffix of one and the prefix of the other.
+    const int window = 2 * radius + 1,
+              paddedWidth = width + 2 * radius;
+    const Pixels<kLines> identity(type == MorphType::kDilate ? 0 : 255);
+    Pixels<kLines>* prefix = scratch;
+    Pixels<kLines>* suffix = scratch + paddedWidth;
+    for (int i = 0, block = 0; i < paddedWidth; ++i, ++block) {
+        int x = i - radius;
+        suffix[i] = 0 <= x && x < width
+                ? load<direction, kLines>(src + x * srcStrideX, srcStrideY)
+                : identity;
+        if (block == window) {
+            block = 0;
         }
+        prefix[i] = block == 0 ? suffix[i] : extreme<type, kLines>(prefix[i - 1], suffix[i]);
     }
+    for (int i = paddedWidth - 2, block = i % window; i >= 0; --i, --block) {
+        if (block < 0) {
+            block = window - 1;
+        }
+        if (block != window - 1) {
+            suffix[i] = extreme<type, kLines>(suffix[i], suffix[i + 1]);
+        }
+    }
+    for (int x = 0; x < width; ++x) {
+        store<direction, kLines>(dst + x * dstStrideX, dstStrideY,
+                                 extreme<type, kLines>(suffix[x], prefix[x + 2 * radius]));
+    }
+}
 
-#else
-    template<MorphType type, MorphDirection direction>
-    static void morph(const SkPMColor* src, SkPMColor* dst,
-                      int radius, int width, int height, int srcStride, int dstStride) {
-        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
-        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
-        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
-        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
-        radius = std::min(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                // If we're maxing (dilate), start from 0; if minning (erode), start from 255.
-                const int start = (type == MorphType::kDilate) ? 0 : 255;
-                int B = start, G = start, R = start, A = start;
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    int b = SkGetPackedB32(*p),
-                        g = SkGetPackedG32(*p),
-                        r = SkGetPackedR32(*p),
-                        a = SkGetPackedA32(*p);
-                    if (type == MorphType::kDilate) {
-                        B = std::max(b, B);
-                        G = std::max(g, G);
-                        R = std::max(r, R);
-                        A = std::max(a, A);
-                    } else {
-                        B = std::min(b, B);
-                        G = std::min(g, G);
-                        R = std::min(r, R);
-                        A = std::min(a, A);
-                    }
-                }
-                *dptr = SkPackARGB32(A, R, G, B);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
-            }
-            if (x >= radius) { src += srcStrideX; }
-            if (x + radius < width - 1) { upperSrc += srcStrideX; }
-            dst += dstStrideX;
+template<MorphType type, MorphDirection direction>
+static void morph(const SkPMColor* src, SkPMColor* dst,
+                  int radius, int width, int height, int srcStride, int dstStride) {
+    const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
+    const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
+    radius = std::min(radius, width - 1);
+    int scratchCount = radius < kMinVanHerkRadius ? 0 : 2 * (width + 2 * radius);
+
+    // Four lines are filtered at once, so that their pixels fill a vector.
+    int y = 0;
+    if (height >= 4) {
+        SkAutoTMalloc<Pixels<4>> scratch(scratchCount);
+        for (; y + 4 <= height; y += 4) {
+            morph_lines<type, direction, 4>(src + y * srcStrideY, dst + y * dstStrideY, radius,
+                                            width, srcStride, dstStride, scratch.get());
         }
     }
-#endif
+    if (y < height) {
+        SkAutoTMalloc<Pixels<1>> scratch(scratchCount);
+        for (; y < height; ++y) {
+            morph_lines<type, direction, 1>(src + y * srcStrideY, dst + y * dstStrideY, radius,
+                                            width, srcStride, dstStride, scratch.get());
+        }
+    }
+}
 }  // namespace
 
 sk_sp<SkSpecialImage> SkMorphologyImageFilter::onFilterImage(const Context& ctx,
@@ -709,15 +724,15 @@ sk_sp<SkSpecialImage> SkMorphologyImageFilter::onFilterImage(const Context& ctx,
             return nullptr;
         }
 
-        call_proc_X(procX, inputBM, &tmp, width, srcBounds);
+        call_proc_X(ctx, procX, inputBM, &tmp, width, srcBounds);
         SkIRect tmpBounds = SkIRect::MakeWH(srcBounds.width(), srcBounds.height());
-        call_proc_Y(procY,
+        call_proc_Y(ctx, procY,
                     tmp.getAddr32(tmpBounds.left(), tmpBounds.top()), tmp.rowBytesAsPixels(),
                     &dst, height, tmpBounds);
     } else if (width > 0) {
-        call_proc_X(procX, inputBM, &dst, width, srcBounds);
+        call_proc_X(ctx, procX, inputBM, &dst, width, srcBounds);
     } else if (height > 0) {
-        call_proc_Y(procY,
+        call_proc_Y(ctx, procY,
                     inputBM.getAddr32(srcBounds.left(), srcBounds.top()),
                     inputBM.rowBytesAsPixels(),
                     &dst, height, srcBounds);
@@ -41,6 +41,8 @@ public:
 
     bool onAffectsTransparentBlack() const override { return true; }
     MatrixCapability onGetCTMCapability() const override { return MatrixCapability::kTranslate; }
+    // The shader can sample its children anywhere, but they're only filtered for the output area.
+    bool onCanFilterTiles() const override { return false; }
 
 protected:
     void flatten(SkWriteBuffer&) const override;
@@ -168,10 +170,13 @@ sk_sp<SkSpecialImage> SkRuntimeImageFilter::onFilterImage(const Context& ctx,
     const int inputCount = this->countInputs();
     SkASSERT(inputCount == fChildShaderNames.count());
 
+    SkAutoSTArray<1, skif::FilterResult> inputs(inputCount);
+    this->filterInputs(ctx, inputs.get());
+
     SkSTArray<1, sk_sp<SkShader>> inputShaders;
     for (int i = 0; i < inputCount; i++) {
         SkIPoint inputOffset = SkIPoint::Make(0, 0);
-        sk_sp<SkSpecialImage> input(this->filterInput(i, ctx, &inputOffset));
+        sk_sp<SkSpecialImage> input = inputs[i].imageAndOffset(&inputOffset);
         if (!input) {
             return nullptr;
         }
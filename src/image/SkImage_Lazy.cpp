@@ -142,9 +142,16 @@ bool SkImage_Lazy::getROPixels(GrDirectContext*, SkBitmap* bitmap,
     }
 
     if (SkImage::kAllow_CachingHint == chint) {
+        ScopedGenerator generator(fSharedGenerator);
+        // Another thread (e.g. an SkImageDecodeScheduler task) may have decoded and cached the
+        // pixels while we waited for the generator.
+        if (SkBitmapCache::Find(desc, bitmap)) {
+            check_output_bitmap();
+            return true;
+        }
         SkPixmap pmap;
         SkBitmapCache::RecPtr cacheRec = SkBitmapCache::Alloc(desc, this->imageInfo(), &pmap);
-        if (!cacheRec || !ScopedGenerator(fSharedGenerator)->getPixels(pmap)) {
+        if (!cacheRec || !generator->getPixels(pmap)) {
             return false;
         }
         SkBitmapCache::Add(std::move(cacheRec), bitmap);
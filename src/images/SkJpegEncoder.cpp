@@ -15,10 +15,12 @@
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/images/SkImageEncoderFns.h"
 #include "src/images/SkJPEGWriteUtility.h"
 
 #include <stdio.h>
+#include <vector>
 
 extern "C" {
     #include "jpeglib.h"
@@ -164,8 +166,12 @@ bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder
     return true;
 }
 
-std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
-                                               const Options& options) {
+// Sets up the compressor, and writes the jpeg's headers to dst. If restartInterval is not zero,
+// the image is one strip of a parallel encode, which uses the standard Huffman tables and ends
+// on a restart boundary.
+static std::unique_ptr<SkJpegEncoderMgr> make_encoder_mgr(SkWStream* dst, const SkPixmap& src,
+                                                          const SkJpegEncoder::Options& options,
+                                                          unsigned int restartInterval) {
     if (!SkPixmapIsValid(src)) {
         return nullptr;
     }
@@ -182,6 +188,10 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& s
     }
 
     jpeg_set_quality(encoderMgr->cinfo(), options.fQuality, TRUE);
+    if (restartInterval) {
+        encoderMgr->cinfo()->optimize_coding = FALSE;
+        encoderMgr->cinfo()->restart_interval = restartInterval;
+    }
     jpeg_start_compress(encoderMgr->cinfo(), TRUE);
 
     sk_sp<SkData> icc = icc_from_color_space(src.info());
@@ -199,6 +209,15 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& s
         jpeg_write_marker(encoderMgr->cinfo(), kICCMarker, markerData->bytes(), markerData->size());
     }
 
+    return encoderMgr;
+}
+
+std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
+                                               const Options& options) {
+    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = make_encoder_mgr(dst, src, options, 0);
+    if (!encoderMgr) {
+        return nullptr;
+    }
     return std::unique_ptr<SkJpegEncoder>(new SkJpegEncoder(std::move(encoderMgr), src));
 }
 
@@ -249,9 +268,127 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Strips in a parallel encode are roughly this many pixels.
+static constexpr int kStripPixels = 1 << 20;
+
+// The markers (following an 0xFF byte) needed to join the strips of a parallel encode.
+static constexpr uint8_t kSOIMarker  = 0xD8;
+static constexpr uint8_t kEOIMarker  = 0xD9;
+static constexpr uint8_t kSOF0Marker = 0xC0;
+static constexpr uint8_t kSOF1Marker = 0xC1;
+static constexpr uint8_t kSOSMarker  = 0xDA;
+static constexpr uint8_t kRST0Marker = 0xD0;
+
+// Returns the number of rows in each strip of a parallel encode, which is a whole number of MCU
+// rows, or 0 if the image is too small to split.
+static int strip_rows(const SkPixmap& src, const SkJpegEncoder::Options& options,
+                      unsigned int* restartInterval) {
+    // Images taller than this can't be encoded, and their height wouldn't fit in the 16 bits the
+    // strips' frame header is patched with. They are left to the serial encoder, which fails.
+    if (src.height() > JPEG_MAX_DIMENSION) {
+        return 0;
+    }
+
+    bool gray = src.colorType() == kGray_8_SkColorType;
+    int mcuWidth  = gray || options.fDownsample == SkJpegEncoder::Downsample::k444 ? 8 : 16;
+    int mcuHeight = gray || options.fDownsample != SkJpegEncoder::Downsample::k420 ? 8 : 16;
+    int mcusPerRow = (src.width() + mcuWidth - 1) / mcuWidth;
+
+    // A restart interval is at most 65535 MCUs.
+    int mcuRows = std::min(std::max(1, kStripPixels / (src.width() * mcuHeight)),
+                           0xFFFF / mcusPerRow);
+    int rows = mcuRows * mcuHeight;
+    if (mcuRows < 1 || rows >= src.height()) {
+        return 0;
+    }
+    *restartInterval = mcuRows * mcusPerRow;
+    return rows;
+}
+
+// Finds where the frame header stores the image height, and where the entropy coded data starts
+// after the scan header. Returns false if the strip isn't laid out as expected.
+static bool parse_strip(const SkData* strip, size_t* heightOffset, size_t* scanOffset) {
+    const uint8_t* bytes = strip->bytes();
+    size_t size = strip->size();
+    if (size < 4 || bytes[0] != 0xFF || bytes[1] != kSOIMarker ||
+        bytes[size - 2] != 0xFF || bytes[size - 1] != kEOIMarker) {
+        return false;
+    }
+    *heightOffset = 0;
+    for (size_t offset = 2; offset + 4 <= size;) {
+        if (bytes[offset] != 0xFF) {
+            return false;
+        }
+        uint8_t marker = bytes[offset + 1];
+        size_t length = (bytes[offset + 2] << 8) | bytes[offset + 3];
+        if (marker == kSOF0Marker || marker == kSOF1Marker) {
+            *heightOffset = offset + 5;
+        } else if (marker == kSOSMarker) {
+            *scanOffset = offset + 2 + length;
+            return *heightOffset && *scanOffset <= size - 2;
+        }
+        offset += 2 + length;
+    }
+    return false;
+}
+
 bool SkJpegEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
-    auto encoder = SkJpegEncoder::Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    unsigned int restartInterval = 0;
+    int stripRows = options.fExecutor && SkPixmapIsValid(src)
+                            ? strip_rows(src, options, &restartInterval) : 0;
+    if (!stripRows) {
+        auto encoder = SkJpegEncoder::Make(dst, src, options);
+        return encoder.get() && encoder->encodeRows(src.height());
+    }
+
+    // Encode each strip as a jpeg of its own, which are all restart intervals of the same length.
+    int stripCount = (src.height() + stripRows - 1) / stripRows;
+    std::vector<sk_sp<SkData>> strips(stripCount);
+    SkTaskGroup taskGroup(*options.fExecutor);
+    taskGroup.batch(stripCount, [&](int i) {
+        SkPixmap strip;
+        int top = i * stripRows;
+        SkAssertResult(src.extractSubset(
+                &strip, SkIRect::MakeLTRB(0, top, src.width(),
+                                          std::min(top + stripRows, src.height()))));
+        SkDynamicMemoryWStream stream;
+        std::unique_ptr<SkJpegEncoderMgr> encoderMgr =
+                make_encoder_mgr(&stream, strip, options, restartInterval);
+        if (encoderMgr) {
+            SkJpegEncoder encoder(std::move(encoderMgr), strip);
+            if (encoder.encodeRows(strip.height())) {
+                strips[i] = stream.detachAsData();
+            }
+        }
+    });
+    taskGroup.wait();
+
+    // The first strip supplies the headers, with the height of the whole image. The entropy coded
+    // data of the rest follows it, each after the next restart marker.
+    size_t heightOffset, scanOffset;
+    for (int i = 0; i < stripCount; ++i) {
+        if (!strips[i] || !parse_strip(strips[i].get(), &heightOffset, &scanOffset)) {
+            return false;
+        }
+        const uint8_t* bytes = strips[i]->bytes();
+        size_t end = strips[i]->size() - 2;
+        if (i == 0) {
+            const uint8_t height[2] = { (uint8_t)(src.height() >> 8), (uint8_t)src.height() };
+            if (!dst->write(bytes, heightOffset) || !dst->write(height, 2) ||
+                !dst->write(bytes + heightOffset + 2, end - heightOffset - 2)) {
+                return false;
+            }
+        } else {
+            const uint8_t restart[2] = { 0xFF, (uint8_t)(kRST0Marker + (i - 1) % 8) };
+            if (!dst->write(restart, 2) || !dst->write(bytes + scanOffset, end - scanOffset)) {
+                return false;
+            }
+        }
+    }
+    const uint8_t eoi[2] = { 0xFF, kEOIMarker };
+    return dst->write(eoi, 2);
 }
 
 #endif
@@ -16,10 +16,12 @@
 #include "src/codec/SkColorTable.h"
 #include "src/codec/SkPngPriv.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/images/SkImageEncoderFns.h"
 #include <vector>
 
 #include <png.h>
+#include "zlib.h"
 
 static_assert(PNG_FILTER_NONE  == (int)SkPngEncoder::FilterFlag::kNone,  "Skia libpng filter err.");
 static_assert(PNG_FILTER_SUB   == (int)SkPngEncoder::FilterFlag::kSub,   "Skia libpng filter err.");
@@ -58,11 +60,14 @@ public:
     bool setColorSpace(const SkImageInfo& info);
     bool writeInfo(const SkImageInfo& srcInfo);
     void chooseProc(const SkImageInfo& srcInfo);
+    bool writeChunk(const char name[4], const void* data, size_t length);
 
     png_structp pngPtr() { return fPngPtr; }
     png_infop infoPtr() { return fInfoPtr; }
     int pngBytesPerPixel() const { return fPngBytesPerPixel; }
     transform_scanline_proc proc() const { return fProc; }
+    int filters() const { return fFilters; }
+    int zlibLevel() const { return fZLibLevel; }
 
     ~SkPngEncoderMgr() {
         png_destroy_write_struct(&fPngPtr, &fInfoPtr);
@@ -79,6 +84,8 @@ private:
     png_infop               fInfoPtr;
     int                     fPngBytesPerPixel;
     transform_scanline_proc fProc;
+    int                     fFilters;
+    int                     fZLibLevel;
 };
 
 std::unique_ptr<SkPngEncoderMgr> SkPngEncoderMgr::Make(SkWStream* stream) {
@@ -197,10 +204,12 @@ bool SkPngEncoderMgr::setHeader(const SkImageInfo& srcInfo, const SkPngEncoder::
     int filters = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
     SkASSERT(filters == (int)options.fFilterFlags);
     png_set_filter(fPngPtr, PNG_FILTER_TYPE_BASE, filters);
+    fFilters = filters;
 
     int zlibLevel = std::min(std::max(0, options.fZLibLevel), 9);
     SkASSERT(zlibLevel == options.fZLibLevel);
     png_set_compression_level(fPngPtr, zlibLevel);
+    fZLibLevel = zlibLevel;
 
     // Set comments in tEXt chunk
     const sk_sp<SkDataTable>& comments = options.fComments;
@@ -398,6 +407,306 @@ void SkPngEncoderMgr::chooseProc(const SkImageInfo& srcInfo) {
     fProc = choose_proc(srcInfo);
 }
 
+bool SkPngEncoderMgr::writeChunk(const char name[4], const void* data, size_t length) {
+    if (setjmp(png_jmpbuf(fPngPtr))) {
+        return false;
+    }
+
+    png_write_chunk(fPngPtr, (png_const_bytep)name, (png_const_bytep)data, length);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Bands are roughly this many bytes of (unfiltered) png rows.
+static constexpr size_t kBandBytes = 256 * 1024;
+
+// With FilterSelection::kPerBand, a band chooses its filter after this many rows.
+static constexpr int kFilterSampleRows = 4;
+
+// Deflate can refer back this far, so each band is primed with this much of the previous band.
+static constexpr size_t kDeflateWindow = 32 * 1024;
+
+// The number of bands that are filtered and compressed at once.
+static constexpr int kBandsInFlight = 8;
+
+enum PngFilterType { kNone_PngFilter, kSub_PngFilter, kUp_PngFilter, kAvg_PngFilter,
+                     kPaeth_PngFilter, kPngFilterCount };
+
+static constexpr int kFilterFlags[kPngFilterCount] = {
+    PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVG, PNG_FILTER_PAETH,
+};
+
+static uint8_t paeth_predictor(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a),
+        pb = abs(p - b),
+        pc = abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Writes the filter type and the filtered row to dst. prev is the previous unfiltered row, which
+// is all zeros for the first row of the image.
+static void filter_row(int filter, uint8_t* dst, const uint8_t* row, const uint8_t* prev,
+                       size_t rowBytes, size_t bpp) {
+    *dst++ = filter;
+    switch (filter) {
+        case kNone_PngFilter:
+            memcpy(dst, row, rowBytes);
+            break;
+        case kSub_PngFilter:
+            memcpy(dst, row, bpp);
+            for (size_t i = bpp; i < rowBytes; ++i) {
+                dst[i] = row[i] - row[i - bpp];
+            }
+            break;
+        case kUp_PngFilter:
+            for (size_t i = 0; i < rowBytes; ++i) {
+                dst[i] = row[i] - prev[i];
+            }
+            break;
+        case kAvg_PngFilter:
+            for (size_t i = 0; i < bpp; ++i) {
+                dst[i] = row[i] - (prev[i] >> 1);
+            }
+            for (size_t i = bpp; i < rowBytes; ++i) {
+                dst[i] = row[i] - ((row[i - bpp] + prev[i]) >> 1);
+            }
+            break;
+        case kPaeth_PngFilter:
+            for (size_t i = 0; i < bpp; ++i) {
+                dst[i] = row[i] - prev[i];
+            }
+            for (size_t i = bpp; i < rowBytes; ++i) {
+                dst[i] = row[i] - paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]);
+            }
+            break;
+    }
+}
+
+// The same heuristic as libpng: the filtered row with the smallest sum of absolute values (as
+// signed bytes) is likely to compress best.
+static uint64_t filter_cost(const uint8_t* filtered, size_t rowBytes) {
+    uint64_t cost = 0;
+    for (size_t i = 0; i < rowBytes; ++i) {
+        cost += abs((int8_t)filtered[i]);
+    }
+    return cost;
+}
+
+namespace {
+
+struct PngBand {
+    int                  fTop;
+    int                  fBottom;
+    size_t               fOffset;      // into the filtered image data
+    size_t               fSize;
+    uLong                fAdler;
+    std::vector<uint8_t> fCompressed;
+    bool                 fSuccess = false;
+};
+
+}  // namespace
+
+// Transforms and filters the band's rows into dst.
+static void filter_band(const SkPixmap& src, transform_scanline_proc proc, int filters,
+                        SkPngEncoder::FilterSelection selection, size_t rowBytes, size_t bpp,
+                        const PngBand& band, uint8_t* dst) {
+    std::vector<uint8_t> storage(2 * rowBytes + 2 * (rowBytes + 1), 0);
+    uint8_t* prev = storage.data();
+    uint8_t* row = prev + rowBytes;
+    uint8_t* trial = row + rowBytes;
+    uint8_t* best = trial + rowBytes + 1;
+
+    auto transform = [&](int y, uint8_t* dstRow) {
+        const void* srcRow = src.addr(0, y);
+        sk_msan_assert_initialized(srcRow,
+                                   (const uint8_t*)srcRow + (src.width() << src.shiftPerPixel()));
+        proc((char*)dstRow, (const char*)srcRow, src.width(),
+             SkColorTypeBytesPerPixel(src.colorType()));
+    };
+    if (band.fTop > 0) {
+        transform(band.fTop - 1, prev);
+    }
+
+    int fixedFilter = filters ? -1 : kNone_PngFilter;
+    for (int filter = 0; filter < kPngFilterCount; ++filter) {
+        if (filters == kFilterFlags[filter]) {
+            fixedFilter = filter;
+        }
+    }
+    uint64_t sampleCosts[kPngFilterCount] = {};
+
+    for (int y = band.fTop; y < band.fBottom; ++y) {
+        transform(y, row);
+        if (fixedFilter >= 0) {
+            filter_row(fixedFilter, dst, row, prev, rowBytes, bpp);
+        } else {
+            uint64_t bestCost = UINT64_MAX;
+            for (int filter = 0; filter < kPngFilterCount; ++filter) {
+                if (filters & kFilterFlags[filter]) {
+                    filter_row(filter, trial, row, prev, rowBytes, bpp);
+                    uint64_t cost = filter_cost(trial + 1, rowBytes);
+                    sampleCosts[filter] += cost;
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        std::swap(trial, best);
+                    }
+                }
+            }
+            memcpy(dst, best, rowBytes + 1);
+
+            if (selection == SkPngEncoder::FilterSelection::kPerBand &&
+                y - band.fTop + 1 == kFilterSampleRows) {
+                uint64_t bestSampleCost = UINT64_MAX;
+                for (int filter = 0; filter < kPngFilterCount; ++filter) {
+                    if ((filters & kFilterFlags[filter]) && sampleCosts[filter] < bestSampleCost) {
+                        bestSampleCost = sampleCosts[filter];
+                        fixedFilter = filter;
+                    }
+                }
+            }
+        }
+        dst += rowBytes + 1;
+        std::swap(prev, row);
+    }
+}
+
+// Compresses the band as raw deflate data, primed with the end of the previous band. All but the
+// last band end with a full flush, so they are byte aligned and can simply be concatenated.
+static bool deflate_band(const uint8_t* image, int level, int strategy, bool last,
+                         PngBand* band) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, strategy) != Z_OK) {
+        return false;
+    }
+
+    size_t dictSize = std::min(band->fOffset, kDeflateWindow);
+    bool success = !dictSize ||
+                   deflateSetDictionary(&stream, image + band->fOffset - dictSize,
+                                        SkToUInt(dictSize)) == Z_OK;
+
+    const uint8_t* data = image + band->fOffset;
+    band->fCompressed.resize(deflateBound(&stream, band->fSize) + 16);
+    stream.next_in = const_cast<uint8_t*>(data);
+    stream.avail_in = SkToUInt(band->fSize);
+    stream.next_out = band->fCompressed.data();
+    stream.avail_out = SkToUInt(band->fCompressed.size());
+    int flush = last ? Z_FINISH : Z_FULL_FLUSH;
+    while (success) {
+        int result = deflate(&stream, flush);
+        if (result == Z_STREAM_END || (!last && result == Z_OK && stream.avail_out > 0)) {
+            break;
+        }
+        if (result != Z_OK && result != Z_BUF_ERROR) {
+            success = false;
+            break;
+        }
+        // Out of room, which deflateBound() shouldn't allow, but grow and carry on.
+        size_t used = band->fCompressed.size() - stream.avail_out;
+        band->fCompressed.resize(band->fCompressed.size() * 2);
+        stream.next_out = band->fCompressed.data() + used;
+        stream.avail_out = SkToUInt(band->fCompressed.size() - used);
+    }
+    band->fCompressed.resize(band->fCompressed.size() - stream.avail_out);
+    deflateEnd(&stream);
+
+    band->fAdler = adler32(adler32(0L, Z_NULL, 0), data, SkToUInt(band->fSize));
+    return success;
+}
+
+// Returns the number of rows in each band, or 0 if the image can't be split into bands.
+static int band_rows(SkPngEncoderMgr* mgr, const SkPixmap& src) {
+    // libpng's row size can differ from what our procs write, e.g. when it drops the alpha of
+    // opaque F16. Those images are left to libpng.
+    size_t rowBytes = png_get_rowbytes(mgr->pngPtr(), mgr->infoPtr());
+    if (!mgr->proc() || rowBytes != (size_t)mgr->pngBytesPerPixel() * src.width()) {
+        return 0;
+    }
+    int bandRows = (int)std::max<size_t>(1, kBandBytes / rowBytes);
+    return bandRows < src.height() ? bandRows : 0;
+}
+
+// Encodes the image data in bands on the executor, and writes it as IDAT chunks followed by IEND.
+// The bands are encoded kBandsInFlight at a time, and each group is written out before the next
+// one starts, so only a few bands of filtered and compressed data are held at once.
+static bool encode_bands(SkPngEncoderMgr* mgr, const SkPixmap& src, int bandRows,
+                         const SkPngEncoder::Options& options) {
+    size_t rowBytes = png_get_rowbytes(mgr->pngPtr(), mgr->infoPtr());
+    int bandCount = (src.height() + bandRows - 1) / bandRows;
+    size_t filteredBytes = rowBytes + 1;
+    size_t bandBytes = bandRows * filteredBytes;
+    size_t bpp = std::max<size_t>(1, rowBytes / src.width());
+
+    // Like libpng, only use the filtered strategy if rows are being filtered.
+    int strategy = mgr->filters() & ~PNG_FILTER_NONE ? Z_FILTERED : Z_DEFAULT_STRATEGY;
+
+    // The zlib header that deflate would write for this level, which starts the first band.
+    int level = mgr->zlibLevel();
+    uint8_t header[2] = { 0x78, (uint8_t)((level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3)
+                                          << 6) };
+    header[1] += 31 - ((header[0] << 8) + header[1]) % 31;
+
+    // Each group of bands is filtered after the last kDeflateWindow bytes of the previous group,
+    // which prime the compression of its first band.
+    std::vector<uint8_t> filtered(kDeflateWindow + kBandsInFlight * bandBytes);
+    size_t historySize = 0;
+    std::vector<PngBand> bands(std::min(bandCount, kBandsInFlight));
+    uLong adler = adler32(0L, Z_NULL, 0);
+    SkTaskGroup taskGroup(*options.fExecutor);
+    for (int first = 0; first < bandCount; first += kBandsInFlight) {
+        int count = std::min(kBandsInFlight, bandCount - first);
+        for (int i = 0; i < count; ++i) {
+            PngBand& band = bands[i];
+            band.fTop = (first + i) * bandRows;
+            band.fBottom = std::min(band.fTop + bandRows, src.height());
+            band.fOffset = historySize + i * bandBytes;
+            band.fSize = (band.fBottom - band.fTop) * filteredBytes;
+        }
+
+        taskGroup.batch(count, [&](int i) {
+            filter_band(src, mgr->proc(), mgr->filters(), options.fFilterSelection, rowBytes, bpp,
+                        bands[i], filtered.data() + bands[i].fOffset);
+        });
+        taskGroup.wait();
+        taskGroup.batch(count, [&](int i) {
+            bands[i].fSuccess = deflate_band(filtered.data(), level, strategy,
+                                             first + i == bandCount - 1, &bands[i]);
+        });
+        taskGroup.wait();
+
+        for (int i = 0; i < count; ++i) {
+            PngBand& band = bands[i];
+            if (!band.fSuccess) {
+                return false;
+            }
+            if (first + i == 0) {
+                band.fCompressed.insert(band.fCompressed.begin(), header, header + 2);
+            }
+            // The stream ends with the checksum of all of the filtered data.
+            adler = adler32_combine(adler, band.fAdler, (z_off_t)band.fSize);
+            if (first + i == bandCount - 1) {
+                const uint8_t trailer[4] = { (uint8_t)(adler >> 24), (uint8_t)(adler >> 16),
+                                             (uint8_t)(adler >> 8), (uint8_t)adler };
+                band.fCompressed.insert(band.fCompressed.end(), trailer, trailer + 4);
+            }
+            if (!mgr->writeChunk("IDAT", band.fCompressed.data(), band.fCompressed.size())) {
+                return false;
+            }
+        }
+
+        size_t end = bands[count - 1].fOffset + bands[count - 1].fSize;
+        size_t keep = std::min(end, kDeflateWindow);
+        memmove(filtered.data(), filtered.data() + end - keep, keep);
+        historySize = keep;
+    }
+    return mgr->writeChunk("IEND", nullptr, 0);
+}
+
 std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkPixmap& src,
                                               const Options& options) {
     if (!SkPixmapIsValid(src)) {
@@ -462,7 +771,16 @@ bool SkPngEncoder::onEncodeRows(int numRows) {
 
 bool SkPngEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
     auto encoder = SkPngEncoder::Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    if (!encoder) {
+        return false;
+    }
+    if (options.fExecutor) {
+        SkPngEncoderMgr* mgr = static_cast<SkPngEncoder*>(encoder.get())->fEncoderMgr.get();
+        if (int bandRows = band_rows(mgr, src)) {
+            return encode_bands(mgr, src, bandRows, options);
+        }
+    }
+    return encoder->encodeRows(src.height());
 }
 
 #endif
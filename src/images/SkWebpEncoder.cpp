@@ -16,6 +16,7 @@
 #include "include/private/SkColorData.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkTemplates.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/images/SkImageEncoderFns.h"
 #include "src/utils/SkUTF.h"
 
@@ -26,6 +27,7 @@
 //   http://review.webmproject.org/gitweb?p=libwebp.git
 
 #include <stdio.h>
+#include <atomic>
 extern "C" {
 // If moving libwebp out of skia source tree, path for webp headers must be
 // updated accordingly. Here, we enforce using local copy in webp sub-directory.
@@ -41,6 +43,30 @@ static int stream_writer(const uint8_t* data, size_t data_size,
 
 using WebPPictureImportProc = int (*) (WebPPicture* picture, const uint8_t* pixels, int stride);
 
+// Rows are converted to unpremul RGBA in strips of this many rows when there is an executor.
+static constexpr int kConvertStripRows = 64;
+
+static bool convert_to_rgba(const SkPixmap& src, const SkPixmap& dst, SkExecutor* executor) {
+    int stripCount = (src.height() + kConvertStripRows - 1) / kConvertStripRows;
+    if (!executor || stripCount < 2) {
+        return src.readPixels(dst);
+    }
+
+    std::atomic<bool> ok{true};
+    SkTaskGroup taskGroup(*executor);
+    taskGroup.batch(stripCount, [&](int i) {
+        SkIRect rows = SkIRect::MakeLTRB(0, i * kConvertStripRows, src.width(),
+                                         std::min((i + 1) * kConvertStripRows, src.height()));
+        SkPixmap srcStrip, dstStrip;
+        if (!src.extractSubset(&srcStrip, rows) || !dst.extractSubset(&dstStrip, rows) ||
+            !srcStrip.readPixels(dstStrip)) {
+            ok = false;
+        }
+    });
+    taskGroup.wait();
+    return ok;
+}
+
 bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& opts) {
     if (!SkPixmapIsValid(pixmap)) {
         return false;
@@ -83,6 +109,9 @@ bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Opti
         webp_config.method = 0;
         pic.use_argb = 1;
     }
+    if (opts.fExecutor) {
+        webp_config.thread_level = 1;
+    }
 
     // If there is no need to embed an ICC profile, we write directly to the input stream.
     // Otherwise, we will first encode to |tmp| and use a mux to add the ICC chunk.  libwebp
@@ -108,7 +137,7 @@ bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Opti
             auto info = pixmap.info().makeColorType(kRGBA_8888_SkColorType)
                                      .makeAlphaType(kUnpremul_SkAlphaType);
             if (!tmpBm.tryAllocPixels(info)
-                    || !pixmap.readPixels(tmpBm.info(), tmpBm.getPixels(), tmpBm.rowBytes())) {
+                    || !convert_to_rgba(pixmap, tmpBm.pixmap(), opts.fExecutor)) {
                 return false;
             }
             src = &tmpBm.pixmap();
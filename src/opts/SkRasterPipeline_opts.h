@@ -2475,13 +2475,28 @@ STAGE(evenly_spaced_gradient, const SkRasterPipeline_GradientCtx* c) {
     gradient_lookup(c, idx, t, &r, &g, &b, &a);
 }
 
+// Finds t's stop by looking up its bucket, then stepping over the stops within the bucket that t
+// has passed. NaN and negative t share bucket 0 with t = 0, and pass none of its stops.
+SI U32 gradient_bucket_search(const SkRasterPipeline_GradientCtx* c, F t) {
+    F clamped = min(if_then_else(t >= 0, t, F(0)), 1.0f);
+    U32 idx = gather(c->buckets, trunc_(clamped * (float)c->bucketCount));
+    for (int i = 0; i < c->maxStopsInBucket; i++) {
+        idx += if_then_else(t >= gather(c->ts, idx + 1), U32(1), U32(0));
+    }
+    return idx;
+}
+
 STAGE(gradient, const SkRasterPipeline_GradientCtx* c) {
     auto t = r;
     U32 idx = 0;
 
-    // N.B. The loop starts at 1 because idx 0 is the color to use before the first stop.
-    for (size_t i = 1; i < c->stopCount; i++) {
-        idx += if_then_else(t >= c->ts[i], U32(1), U32(0));
+    if (c->buckets) {
+        idx = gradient_bucket_search(c, t);
+    } else {
+        // N.B. The loop starts at 1 because idx 0 is the color to use before the first stop.
+        for (size_t i = 1; i < c->stopCount; i++) {
+            idx += if_then_else(t >= c->ts[i], U32(1), U32(0));
+        }
     }
 
     gradient_lookup(c, idx, t, &r, &g, &b, &a);
@@ -2883,6 +2898,23 @@ STAGE(bicubic_clamp_8888, const SkRasterPipeline_GatherCtx* ctx) {
     }
 }
 
+// ~~~~~~ Fused stages ~~~~~~ //
+// SkRasterPipeline substitutes these for the sequences of stages they're named after,
+// saving the dispatch between them.  Each just runs those stages' kernels back to back.
+
+STAGE(load_8888_premul, const SkRasterPipeline_MemoryCtx* ctx) {
+    load_8888_k(ctx, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    premul_k(Ctx::None{}, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+}
+STAGE(seed_shader_matrix_scale_translate, const float* m) {
+    seed_shader_k(Ctx::None{}, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    matrix_scale_translate_k(m, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+}
+STAGE(seed_shader_matrix_2x3, const float* m) {
+    seed_shader_k(Ctx::None{}, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    matrix_2x3_k(m, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+}
+
 // ~~~~~~ skgpu::Swizzle stage ~~~~~~ //
 
 STAGE(swizzle, void* ctx) {
@@ -4083,13 +4115,27 @@ SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                    r,g,b,a);
 }
 
+// See the highp gradient_bucket_search().
+SI U32 gradient_bucket_search(const SkRasterPipeline_GradientCtx* c, F t) {
+    F clamped = min(if_then_else(t >= 0, t, F(0)), 1.0f);
+    U32 idx = gather<U32>(c->buckets, trunc_(clamped * (float)c->bucketCount));
+    for (int i = 0; i < c->maxStopsInBucket; i++) {
+        idx += if_then_else(t >= gather<F>(c->ts, idx + 1), U32(1), U32(0));
+    }
+    return idx;
+}
+
 STAGE_GP(gradient, const SkRasterPipeline_GradientCtx* c) {
     auto t = x;
     U32 idx = 0;
 
-    // N.B. The loop starts at 1 because idx 0 is the color to use before the first stop.
-    for (size_t i = 1; i < c->stopCount; i++) {
-        idx += if_then_else(t >= c->ts[i], U32(1), U32(0));
+    if (c->buckets) {
+        idx = gradient_bucket_search(c, t);
+    } else {
+        // N.B. The loop starts at 1 because idx 0 is the color to use before the first stop.
+        for (size_t i = 1; i < c->stopCount; i++) {
+            idx += if_then_else(t >= c->ts[i], U32(1), U32(0));
+        }
     }
 
     gradient_lookup(c, idx, t, &r, &g, &b, &a);
@@ -4250,6 +4296,21 @@ STAGE_PP(srcover_rgba_8888, const SkRasterPipeline_MemoryCtx* ctx) {
     store_8888_(ptr, tail, r,g,b,a);
 }
 
+// ~~~~~~ Fused stages ~~~~~~ //
+
+STAGE_PP(load_8888_premul, const SkRasterPipeline_MemoryCtx* ctx) {
+    load_8888_k(ctx, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    premul_k(Ctx::None{}, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+}
+STAGE_GG(seed_shader_matrix_scale_translate, const float* m) {
+    seed_shader_k(Ctx::None{}, dx,dy,tail, x,y);
+    matrix_scale_translate_k(m, dx,dy,tail, x,y);
+}
+STAGE_GG(seed_shader_matrix_2x3, const float* m) {
+    seed_shader_k(Ctx::None{}, dx,dy,tail, x,y);
+    matrix_2x3_k(m, dx,dy,tail, x,y);
+}
+
 // ~~~~~~ skgpu::Swizzle stage ~~~~~~ //
 
 STAGE_PP(swizzle, void* ctx) {
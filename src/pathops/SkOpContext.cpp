@@ -0,0 +1,55 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/pathops/SkPathOps.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/pathops/SkPathOpsCommon.h"
+
+#include <algorithm>
+
+static constexpr size_t kInitialStorageSize = 16 * 1024;
+// Larger ops still succeed, but allocate the rest of what they need as they go.
+static constexpr size_t kMaxStorageSize = 1024 * 1024;
+
+SkOpContext::SkOpContext()
+        : fStorage(new char[kInitialStorageSize])
+        , fStorageSize(kInitialStorageSize) {}
+
+SkOpContext::~SkOpContext() = default;
+
+template <typename Fn> bool SkOpContext::run(Fn&& fn) {
+    bool success;
+    bool spilled;
+    {
+        SkArenaAlloc allocator(fStorage.get(), fStorageSize, fStorageSize);
+        success = fn(&allocator);
+        // The arena only moves on to heap blocks once the storage is used up, so the next byte it
+        // hands out shows whether the op fit.
+        const char* next = allocator.makeArrayDefault<char>(1);
+        spilled = next < fStorage.get() || next >= fStorage.get() + fStorageSize;
+    }
+    // The arena's destructor still reads the storage, so it can only be replaced afterwards.
+    if (spilled && fStorageSize < kMaxStorageSize) {
+        fStorageSize = std::min(fStorageSize * 2, kMaxStorageSize);
+        fStorage.reset(new char[fStorageSize]);
+    }
+    return success;
+}
+
+bool SkOpContext::op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
+    return this->run([&](SkArenaAlloc* allocator) {
+        return OpWithAllocator(one, two, op, result, allocator
+                               SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+    });
+}
+
+bool SkOpContext::simplify(const SkPath& path, SkPath* result) {
+    return this->run([&](SkArenaAlloc* allocator) {
+        return SimplifyWithAllocator(path, result, allocator
+                                     SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+    });
+}
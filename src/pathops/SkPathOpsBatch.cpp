@@ -0,0 +1,221 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPath.h"
+#include "include/pathops/SkPathOps.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+// Disjoint-set forest over path indices, used to group the paths whose bounds touch.
+class PathClusters {
+public:
+    explicit PathClusters(int count) : fParent(count) {
+        std::iota(fParent.begin(), fParent.end(), 0);
+    }
+
+    int find(int index) {
+        while (fParent[index] != index) {
+            fParent[index] = fParent[fParent[index]];
+            index = fParent[index];
+        }
+        return index;
+    }
+
+    void join(int a, int b) {
+        a = this->find(a);
+        b = this->find(b);
+        if (a != b) {
+            fParent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+private:
+    std::vector<int> fParent;
+};
+
+// Unlike SkRect::Intersects, this accepts bounds which only share an edge, so that adjacent paths
+// (e.g. tiles of a map) end up in the same cluster, and are merged into a single contour.
+bool bounds_touch(const SkRect& a, const SkRect& b) {
+    return a.fLeft <= b.fRight && b.fLeft <= a.fRight &&
+           a.fTop <= b.fBottom && b.fTop <= a.fBottom;
+}
+
+// Splits the paths into groups which can be unioned independently: paths in different groups have
+// disjoint bounds, so their unions don't overlap either. Uses a sweep over the left edges, which
+// only compares each path with the paths that are still open at that point.
+std::vector<std::vector<SkPath>> cluster_for_union(const SkPath paths[], int count) {
+    std::vector<std::vector<SkPath>> groups;
+    for (int index = 0; index < count; ++index) {
+        if (paths[index].isInverseFillType()) {
+            // Inverse paths are unbounded, so everything interacts with them.
+            groups.emplace_back(paths, paths + count);
+            return groups;
+        }
+    }
+
+    std::vector<int> order;
+    for (int index = 0; index < count; ++index) {
+        // Empty paths don't contribute anything to a union.
+        if (!paths[index].isEmpty()) {
+            order.push_back(index);
+        }
+    }
+    std::sort(order.begin(), order.end(), [paths](int a, int b) {
+        return paths[a].getBounds().fLeft < paths[b].getBounds().fLeft;
+    });
+
+    PathClusters clusters(count);
+    std::vector<int> open;
+    for (int index : order) {
+        const SkRect& bounds = paths[index].getBounds();
+        // Paths which end before this one starts can't touch it, nor any path after it.
+        open.erase(std::remove_if(open.begin(), open.end(), [&](int other) {
+                       return paths[other].getBounds().fRight < bounds.fLeft;
+                   }),
+                   open.end());
+        for (int other : open) {
+            if (bounds_touch(bounds, paths[other].getBounds())) {
+                clusters.join(index, other);
+            }
+        }
+        open.push_back(index);
+    }
+
+    std::vector<int> groupIndex(count, -1);
+    for (int index : order) {
+        int root = clusters.find(index);
+        if (groupIndex[root] < 0) {
+            groupIndex[root] = SkToInt(groups.size());
+            groups.emplace_back();
+        }
+        groups[groupIndex[root]].push_back(paths[index]);
+    }
+    return groups;
+}
+
+// Reduces each group to a single path, combining pairs of paths one level of a balanced tree at a
+// time. All of the groups advance together, so that all of the ops of a level can run at once.
+bool reduce_groups(std::vector<std::vector<SkPath>>* groups, SkPathOp op, SkExecutor* executor) {
+    struct Task {
+        const SkPath* fOne;
+        const SkPath* fTwo;  // When null, fOne is simplified instead.
+        SkPath*       fResult;
+    };
+    std::vector<Task> tasks;
+    std::vector<std::vector<SkPath>> nextGroups(groups->size());
+
+    auto run_tasks = [&]() {
+        std::atomic<bool> succeeded{true};
+        auto run_task = [&](int index) {
+            const Task& task = tasks[index];
+            bool ok = task.fTwo ? Op(*task.fOne, *task.fTwo, op, task.fResult)
+                                : Simplify(*task.fOne, task.fResult);
+            if (!ok) {
+                succeeded = false;
+            }
+        };
+        if (executor) {
+            SkTaskGroup taskGroup(*executor);
+            taskGroup.batch(SkToInt(tasks.size()), run_task);
+            taskGroup.wait();
+        } else {
+            for (int index = 0; index < SkToInt(tasks.size()); ++index) {
+                run_task(index);
+            }
+        }
+        return succeeded.load();
+    };
+
+    // Paths that are alone in their group are simplified, so that every group's result consists of
+    // non-overlapping contours, just like the result of an Op.
+    for (auto& group : *groups) {
+        if (group.size() == 1) {
+            tasks.push_back({&group[0], nullptr, &group[0]});
+        }
+    }
+
+    for (bool more = true; more;) {
+        more = false;
+        for (size_t groupIndex = 0; groupIndex < groups->size(); ++groupIndex) {
+            const std::vector<SkPath>& group = (*groups)[groupIndex];
+            if (group.size() < 2) {
+                continue;
+            }
+            std::vector<SkPath>& nextGroup = nextGroups[groupIndex];
+            nextGroup.resize((group.size() + 1) / 2);
+            for (size_t pair = 0; pair < group.size() / 2; ++pair) {
+                tasks.push_back({&group[2 * pair], &group[2 * pair + 1], &nextGroup[pair]});
+            }
+            if (group.size() & 1) {
+                nextGroup.back() = group.back();
+            }
+            more = true;
+        }
+        if (!tasks.empty() && !run_tasks()) {
+            return false;
+        }
+        tasks.clear();
+        for (size_t groupIndex = 0; groupIndex < groups->size(); ++groupIndex) {
+            if ((*groups)[groupIndex].size() > 1) {
+                (*groups)[groupIndex].swap(nextGroups[groupIndex]);
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool BatchOp(const SkPath paths[], int count, SkPathOp op, SkPath* result, SkExecutor* executor) {
+    if (op != kUnion_SkPathOp && op != kIntersect_SkPathOp) {
+        return false;
+    }
+
+    std::vector<std::vector<SkPath>> groups;
+    if (op == kUnion_SkPathOp) {
+        groups = cluster_for_union(paths, count);
+    } else if (count > 0) {
+        // An intersection is empty as soon as the bounds of the (non-inverse) paths don't overlap.
+        SkRect common = SkRect::MakeLTRB(-SK_ScalarInfinity, -SK_ScalarInfinity,
+                                         SK_ScalarInfinity, SK_ScalarInfinity);
+        for (int index = 0; index < count && !common.isEmpty(); ++index) {
+            if (!paths[index].isInverseFillType() && !common.intersect(paths[index].getBounds())) {
+                common.setEmpty();
+            }
+        }
+        if (!common.isEmpty()) {
+            groups.emplace_back(paths, paths + count);
+        }
+    }
+
+    if (!reduce_groups(&groups, op, executor)) {
+        return false;
+    }
+
+    // Groups have disjoint bounds, so their results can simply be appended to each other.
+    SkPath combined;
+    for (const auto& group : groups) {
+        SkASSERT(group.size() == 1);
+        if (groups.size() == 1) {
+            combined = group[0];
+        } else {
+            combined.addPath(group[0]);
+        }
+    }
+    if (groups.size() != 1) {
+        combined.setFillType(SkPathFillType::kEvenOdd);
+    }
+    *result = std::move(combined);
+    return true;
+}
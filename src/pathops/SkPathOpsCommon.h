@@ -10,6 +10,7 @@
 #include "include/private/SkTDArray.h"
 #include "src/pathops/SkOpAngle.h"
 
+class SkArenaAlloc;
 class SkOpCoincidence;
 class SkOpContour;
 class SkPathWriter;
@@ -26,5 +27,12 @@ bool HandleCoincidence(SkOpContourHead* , SkOpCoincidence* );
 bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
              SkDEBUGPARAMS(bool skipAssert)
              SkDEBUGPARAMS(const char* testName));
+// The same as OpDebug and SimplifyDebug, but the contour graph is built in the given allocator,
+// so that it can be reused across calls. Objects are not freed until the allocator is.
+bool OpWithAllocator(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+                     SkArenaAlloc* allocator
+                     SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName));
+bool SimplifyWithAllocator(const SkPath& path, SkPath* result, SkArenaAlloc* allocator
+                           SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName));
 
 #endif
@@ -4,12 +4,16 @@
  * Use of this source code is governed by a BSD-style license that can be
  * found in the LICENSE file.
  */
+#include "include/private/SkTArray.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkPathPriv.h"
 #include "src/pathops/SkAddIntersections.h"
 #include "src/pathops/SkOpCoincidence.h"
 #include "src/pathops/SkOpEdgeBuilder.h"
 #include "src/pathops/SkPathOpsCommon.h"
 #include "src/pathops/SkPathWriter.h"
 
+#include <algorithm>
 #include <utility>
 
 static bool findChaseOp(SkTDArray<SkOpSpanBase*>& chase, SkOpSpanBase** startPtr,
@@ -236,8 +240,188 @@ extern void (*gVerboseFinalize)();
 
 #endif
 
+using SkDPolygon = SkSTArray<16, SkDPoint, true>;
+
+// Reads a convex path made only of lines into a polygon with a positive (counterclockwise in
+// y-up coordinates) signed area. Returns false if the path has no area.
+static bool convex_polygon(const SkPath& path, SkDPolygon* polygon) {
+    if (path.getSegmentMasks() != SkPath::kLine_SegmentMask || !path.isConvex()) {
+        return false;
+    }
+    for (auto [verb, pts, weight] : SkPathPriv::Iterate(path)) {
+        if (verb == SkPathVerb::kMove) {
+            if (!polygon->empty()) {
+                return false;
+            }
+            polygon->push_back().set(pts[0]);
+        } else if (verb == SkPathVerb::kLine) {
+            SkDPoint pt;
+            pt.set(pts[1]);
+            if (pt != polygon->back()) {
+                polygon->push_back(pt);
+            }
+        }
+    }
+    if (polygon->count() > 1 && polygon->front() == polygon->back()) {
+        polygon->pop_back();
+    }
+    if (polygon->count() < 3) {
+        return false;
+    }
+    double area = 0;
+    for (int index = 0; index < polygon->count(); ++index) {
+        const SkDPoint& pt = (*polygon)[index];
+        const SkDPoint& next = (*polygon)[(index + 1) % polygon->count()];
+        area += pt.fX * next.fY - next.fX * pt.fY;
+    }
+    if (area == 0) {
+        return false;
+    }
+    if (area < 0) {
+        std::reverse(polygon->begin(), polygon->end());
+    }
+    return true;
+}
+
+// Intersects two convex polygons by clipping one against each edge of the other. Returns false,
+// leaving result unmodified, if a vertex lies on (or very nearly on) an edge of the other
+// polygon: those coincidences are left to the general algorithm.
+static bool intersect_convex(const SkPath& one, const SkPath& two, SkPath* result) {
+    SkDPolygon subject, clip;
+    if (!convex_polygon(one, &subject) || !convex_polygon(two, &clip)) {
+        return false;
+    }
+    SkDPolygon clipped;
+    for (int edge = 0; edge < clip.count() && !subject.empty(); ++edge) {
+        const SkDPoint& start = clip[edge];
+        SkDVector edgeVector = clip[(edge + 1) % clip.count()] - start;
+        clipped.reset();
+        const SkDPoint* prior = &subject.back();
+        double priorCross = edgeVector.crossCheck(*prior - start);
+        if (priorCross == 0) {
+            return false;
+        }
+        for (const SkDPoint& pt : subject) {
+            double cross = edgeVector.crossCheck(pt - start);
+            if (cross == 0) {
+                return false;
+            }
+            if ((cross > 0) != (priorCross > 0)) {
+                double t = priorCross / (priorCross - cross);
+                clipped.push_back({prior->fX + (pt.fX - prior->fX) * t,
+                                   prior->fY + (pt.fY - prior->fY) * t});
+            }
+            if (cross > 0) {
+                clipped.push_back(pt);
+            }
+            prior = &pt;
+            priorCross = cross;
+        }
+        subject.swap(clipped);
+    }
+    result->reset();
+    result->setFillType(SkPathFillType::kEvenOdd);
+    if (subject.count() >= 3) {
+        result->moveTo(subject[0].asSkPoint());
+        for (int index = 1; index < subject.count(); ++index) {
+            result->lineTo(subject[index].asSkPoint());
+        }
+        result->close();
+    }
+    return true;
+}
+
+// Handles ops whose result follows directly from the operands' bounds or shapes, without
+// building the contour graph: operands with disjoint bounds, rects containing each other, and
+// the intersection of convex polygons. Returns false if the general algorithm is needed;
+// otherwise success is set to whether the op succeeded. Neither operand may be inverse or empty.
+static bool trivial_op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+                       SkArenaAlloc* allocator, bool* success) {
+    const SkRect& bounds1 = one.getBounds();
+    const SkRect& bounds2 = two.getBounds();
+    // Operands which only share an edge must still be joined along it.
+    if (bounds1.fRight < bounds2.fLeft || bounds2.fRight < bounds1.fLeft ||
+            bounds1.fBottom < bounds2.fTop || bounds2.fBottom < bounds1.fTop) {
+        switch (op) {
+            case kIntersect_SkPathOp:
+                result->reset();
+                result->setFillType(SkPathFillType::kEvenOdd);
+                *success = true;
+                break;
+            case kDifference_SkPathOp:
+                *success = SimplifyWithAllocator(one, result, allocator
+                                                 SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+                break;
+            case kReverseDifference_SkPathOp:
+                *success = SimplifyWithAllocator(two, result, allocator
+                                                 SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+                break;
+            case kUnion_SkPathOp:
+            case kXOR_SkPathOp: {
+                // Each simplified operand is made of non-overlapping contours, and the operands
+                // don't overlap each other, so their contours can simply be combined.
+                SkPath simple1, simple2;
+                *success = SimplifyWithAllocator(one, &simple1, allocator
+                                                 SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr)) &&
+                           SimplifyWithAllocator(two, &simple2, allocator
+                                                 SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+                if (*success) {
+                    simple1.addPath(simple2);
+                    simple1.setFillType(SkPathFillType::kEvenOdd);
+                    *result = std::move(simple1);
+                }
+                break;
+            }
+            default:
+                SkASSERT(0);  // unhandled case
+                return false;
+        }
+        return true;
+    }
+    SkRect rect1, rect2;
+    if (one.isRect(&rect1) && two.isRect(&rect2)) {
+        const SkRect* rect = nullptr;
+        bool empty = false;
+        switch (op) {
+            case kUnion_SkPathOp:
+                rect = rect1.contains(rect2) ? &rect1 : rect2.contains(rect1) ? &rect2 : nullptr;
+                break;
+            case kDifference_SkPathOp:
+                empty = rect2.contains(rect1);
+                break;
+            case kReverseDifference_SkPathOp:
+                empty = rect1.contains(rect2);
+                break;
+            default:
+                break;
+        }
+        if (rect || empty) {
+            result->reset();
+            result->setFillType(SkPathFillType::kEvenOdd);
+            if (rect) {
+                result->addRect(*rect);
+            }
+            *success = true;
+            return true;
+        }
+    }
+    if (kIntersect_SkPathOp == op && intersect_convex(one, two, result)) {
+        *success = true;
+        return true;
+    }
+    return false;
+}
+
 bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
         SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
+    SkSTArenaAlloc<4096> allocator;  // FIXME: add a constant expression here, tune
+    return OpWithAllocator(one, two, op, result, &allocator
+                           SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+}
+
+bool OpWithAllocator(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+                     SkArenaAlloc* allocator
+                     SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
 #if DEBUG_DUMP_VERIFY
 #ifndef SK_DEBUG
     const char* testName = "release";
@@ -284,12 +468,18 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
         if (inverseFill != work.isInverseFillType()) {
             work.toggleInverseFillType();
         }
-        return Simplify(work, result);
+        return SimplifyWithAllocator(work, result, allocator
+                                     SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+    }
+    if (!one.isInverseFillType() && !two.isInverseFillType()) {
+        bool success;
+        if (trivial_op(one, two, op, result, allocator, &success)) {
+            return success;
+        }
     }
-    SkSTArenaAlloc<4096> allocator;  // FIXME: add a constant expression here, tune
     SkOpContour contour;
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
-    SkOpGlobalState globalState(contourList, &allocator
+    SkOpGlobalState globalState(contourList, allocator
             SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
     SkOpCoincidence coincidence(&globalState);
     const SkPath* minuend = &one;
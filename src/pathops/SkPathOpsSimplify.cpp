@@ -139,6 +139,13 @@ static bool bridgeXor(SkOpContourHead* contourList, SkPathWriter* writer) {
 // FIXME : add this as a member of SkPath
 bool SimplifyDebug(const SkPath& path, SkPath* result
         SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
+    SkSTArenaAlloc<4096> allocator;  // FIXME: constant-ize, tune
+    return SimplifyWithAllocator(path, result, &allocator
+                                 SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+}
+
+bool SimplifyWithAllocator(const SkPath& path, SkPath* result, SkArenaAlloc* allocator
+        SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     SkPathFillType fillType = path.isInverseFillType() ? SkPathFillType::kInverseEvenOdd
             : SkPathFillType::kEvenOdd;
@@ -150,10 +157,9 @@ bool SimplifyDebug(const SkPath& path, SkPath* result
         return true;
     }
     // turn path into list of segments
-    SkSTArenaAlloc<4096> allocator;  // FIXME: constant-ize, tune
     SkOpContour contour;
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
-    SkOpGlobalState globalState(contourList, &allocator
+    SkOpGlobalState globalState(contourList, allocator
             SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
     SkOpCoincidence coincidence(&globalState);
 #if DEBUG_DUMP_VERIFY
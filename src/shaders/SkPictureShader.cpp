@@ -9,8 +9,12 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/private/SkImageInfoPriv.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkSemaphore.h"
+#include "include/private/SkTArray.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkImagePriv.h"
 #include "src/core/SkMatrixPriv.h"
@@ -105,6 +109,78 @@ struct ImageFromPictureRec : public SkResourceCache::Rec {
     }
 };
 
+// A tile that one thread is rasterizing, and others are waiting for.
+struct PendingImage : public SkNVRefCnt<PendingImage> {
+    explicit PendingImage(const ImageFromPictureKey& key) : fKey(key) {}
+
+    ImageFromPictureKey fKey;
+    int                 fWaiters = 0;
+    sk_sp<SkImage>      fImage;
+    SkSemaphore         fDone;
+};
+
+static SkMutex& pending_mutex() {
+    static SkMutex& mutex = *(new SkMutex);
+    return mutex;
+}
+
+static SkTArray<sk_sp<PendingImage>>& pending_images() {
+    static auto& pending = *(new SkTArray<sk_sp<PendingImage>>);
+    return pending;
+}
+
+// Returns the cached image for 'key', or calls 'make' and caches the result. Concurrent misses for
+// the same key wait for the first one's image, rather than all rasterizing the same tile.
+template <typename MakeImage>
+sk_sp<SkImage> find_or_make_image(const ImageFromPictureKey& key, const SkPicture* picture,
+                                  MakeImage&& make) {
+    sk_sp<SkImage> image;
+    if (SkResourceCache::Find(key, ImageFromPictureRec::Visitor, &image)) {
+        return image;
+    }
+
+    sk_sp<PendingImage> pending;
+    {
+        SkAutoMutexExclusive lock(pending_mutex());
+        for (const sk_sp<PendingImage>& p : pending_images()) {
+            if (p->fKey == key) {
+                pending = p;
+                break;
+            }
+        }
+        if (pending) {
+            pending->fWaiters++;
+        } else if (SkResourceCache::Find(key, ImageFromPictureRec::Visitor, &image)) {
+            // Another thread finished this image after our first look.
+            return image;
+        } else {
+            pending_images().push_back(sk_make_sp<PendingImage>(key));
+        }
+    }
+    if (pending) {
+        pending->fDone.wait();
+        return pending->fImage;
+    }
+
+    image = make();
+    if (image) {
+        SkResourceCache::Add(new ImageFromPictureRec(key, image));
+        SkPicturePriv::AddedToCache(picture);
+    }
+
+    SkAutoMutexExclusive lock(pending_mutex());
+    SkTArray<sk_sp<PendingImage>>& all = pending_images();
+    for (int i = 0; i < all.count(); ++i) {
+        if (all[i]->fKey == key) {
+            all[i]->fImage = image;
+            all[i]->fDone.signal(all[i]->fWaiters);
+            all.removeShuffle(i);
+            break;
+        }
+    }
+    return image;
+}
+
 } // namespace
 
 SkPictureShader::SkPictureShader(sk_sp<SkPicture> picture, SkTileMode tmx, SkTileMode tmy,
@@ -167,9 +243,30 @@ static sk_sp<SkColorSpace> ref_or_srgb(SkColorSpace* cs) {
     return cs ? sk_ref_sp(cs) : SkColorSpace::MakeSRGB();
 }
 
+// Clamp the tile size to about 4M pixels
+static constexpr SkScalar kMaxTileArea = 2048 * 2048;
+
+// Tiles with at least this many pixels are rasterized in bands of about kBandArea pixels, on the
+// default executor. Anti-aliasing near a clip edge can differ from unclipped drawing, so each band
+// is drawn kBandOverlap rows taller on both sides, and those rows are thrown away.
+static constexpr int kMinBandedTileArea = 1024 * 1024;
+static constexpr int kBandArea = 512 * 1024;
+static constexpr int kBandOverlap = 32;
+
+// Bands are claimed from a shared counter by the rasterizing thread and by tasks on the executor.
+// The rasterizing thread only waits for claimed bands to finish, and never runs unrelated tasks
+// meanwhile, so it can't end up waiting on a tile it's rasterizing itself (see
+// find_or_make_image). Tasks that start after every band is claimed just return.
+struct BandedRaster : public SkNVRefCnt<BandedRaster> {
+    std::atomic<int> fNext{0};
+    std::atomic<int> fFinished{0};
+    SkSemaphore      fAllFinished;
+};
+
 struct CachedImageInfo {
     bool        success;
     SkSize      tileScale;
+    SkSize      requestedScale;  // tileScale before the tile size was rounded up
     SkMatrix    matrixForDraw;
     SkImageInfo imageInfo;
 
@@ -196,8 +293,6 @@ struct CachedImageInfo {
             size.fWidth  *= bounds.width();
             size.fHeight *= bounds.height();
 
-            // Clamp the tile size to about 4M pixels
-            static const SkScalar kMaxTileArea = 2048 * 2048;
             SkScalar tileArea = size.width() * size.height();
             if (tileArea > kMaxTileArea) {
                 SkScalar clampScale = SkScalarSqrt(kMaxTileArea / tileArea);
@@ -219,7 +314,7 @@ struct CachedImageInfo {
 
         const SkISize tileSize = scaledSize.toCeil();
         if (tileSize.isEmpty()) {
-            return {false, {}, {}, {}};
+            return {false, {}, {}, {}, {}};
         }
 
         const SkSize tileScale = {
@@ -237,12 +332,40 @@ struct CachedImageInfo {
         return {
             true,
             tileScale,
+            {scaledSize.width() / bounds.width(), scaledSize.height() / bounds.height()},
             SkMatrix::RectToRect(bounds, SkRect::MakeIWH(tileSize.width(), tileSize.height())),
             SkImageInfo::Make(tileSize.width(), tileSize.height(),
                               imgCT, kPremul_SkAlphaType, imgCS),
         };
     }
 
+    // Returns the info for a tile at the next power of two scale up (per axis), which nearby
+    // scales can share by downsampling it. Returns this info if there is no such bucket, e.g. for
+    // scales that are (nearly) a power of two already.
+    CachedImageInfo makeBucket(const SkRect& bounds) const {
+        auto roundUp = [](SkScalar scale) {
+            return std::exp2(std::ceil(std::log2(scale) - 1.0f / 64));
+        };
+        SkSize bucketScale = {roundUp(requestedScale.width()), roundUp(requestedScale.height())};
+        SkSize scaledSize = {bounds.width() * bucketScale.width(),
+                             bounds.height() * bucketScale.height()};
+        if (!(scaledSize.width() * scaledSize.height() <= kMaxTileArea)) {
+            return *this;
+        }
+        const SkISize tileSize = scaledSize.toCeil();
+        if (tileSize == imageInfo.dimensions() ||
+            tileSize.width() < imageInfo.width() || tileSize.height() < imageInfo.height()) {
+            return *this;
+        }
+        return {
+            true,
+            {tileSize.width() / bounds.width(), tileSize.height() / bounds.height()},
+            bucketScale,
+            SkMatrix::RectToRect(bounds, SkRect::MakeIWH(tileSize.width(), tileSize.height())),
+            imageInfo.makeDimensions(tileSize),
+        };
+    }
+
     sk_sp<SkImage> makeImage(sk_sp<SkSurface> surf, const SkPicture* pict) const {
         if (!surf) {
             return nullptr;
@@ -252,6 +375,61 @@ struct CachedImageInfo {
         canvas->drawPicture(pict);
         return surf->makeImageSnapshot();
     }
+
+    // Large tiles are split into bands of rows, which are played back concurrently.
+    sk_sp<SkImage> makeRasterImage(const SkPicture* pict) const {
+        if (imageInfo.width() * imageInfo.height() < kMinBandedTileArea) {
+            return this->makeImage(SkSurface::MakeRaster(imageInfo), pict);
+        }
+        SkBitmap bitmap;
+        if (!bitmap.tryAllocPixels(imageInfo)) {
+            return nullptr;
+        }
+
+        const int bandRows = std::max(1, kBandArea / imageInfo.width());
+        const int bands = (imageInfo.height() + bandRows - 1) / bandRows;
+        std::atomic<bool> failed{false};
+        auto drawBand = [&](int i) {
+            int top = i * bandRows,
+                bottom = std::min(top + bandRows, imageInfo.height()),
+                drawTop = std::max(top - kBandOverlap, 0),
+                drawBottom = std::min(bottom + kBandOverlap, imageInfo.height());
+            SkBitmap band;
+            if (!band.tryAllocPixels(imageInfo.makeWH(imageInfo.width(), drawBottom - drawTop))) {
+                failed = true;
+                return;
+            }
+            band.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(band);
+            canvas.translate(0, -drawTop);
+            canvas.concat(matrixForDraw);
+            canvas.drawPicture(pict);
+            for (int y = top; y < bottom; ++y) {
+                memcpy(bitmap.getAddr(0, y), band.getAddr(0, y - drawTop),
+                       imageInfo.minRowBytes());
+            }
+        };
+
+        auto job = sk_make_sp<BandedRaster>();
+        auto drawBands = [job, bands, drawBand] {
+            for (int i; (i = job->fNext++) < bands;) {
+                drawBand(i);
+                if (++job->fFinished == bands) {
+                    job->fAllFinished.signal();
+                }
+            }
+        };
+        for (int i = 1; i < bands; ++i) {
+            SkExecutor::GetDefault().add(drawBands);
+        }
+        drawBands();
+        job->fAllFinished.wait();
+        if (failed) {
+            return nullptr;
+        }
+        bitmap.setImmutable();
+        return bitmap.asImage();
+    }
 };
 
 // Returns a cached image shader, which wraps a single picture tile at the given
@@ -268,18 +446,34 @@ sk_sp<SkShader> SkPictureShader::rasterShader(const SkMatrix& viewMatrix,
         return nullptr;
     }
 
-    ImageFromPictureKey key(info.imageInfo.colorSpace(), info.imageInfo.colorType(),
-                        fPicture->uniqueID(), fTile, info.tileScale);
-
-    sk_sp<SkImage> image;
-    if (!SkResourceCache::Find(key, ImageFromPictureRec::Visitor, &image)) {
-        image = info.makeImage(SkSurface::MakeRaster(info.imageInfo), fPicture.get());
-        if (!image) {
-            return nullptr;
+    auto makeKey = [&](const CachedImageInfo& tileInfo) {
+        return ImageFromPictureKey(tileInfo.imageInfo.colorSpace(), tileInfo.imageInfo.colorType(),
+                                   fPicture->uniqueID(), fTile, tileInfo.tileScale);
+    };
+
+    // Tiles are rasterized at the next power of two scale, so that while zooming, the picture is
+    // only played back once per doubling. Each scale's tile is downsampled from that.
+    sk_sp<SkImage> image = find_or_make_image(makeKey(info), fPicture.get(), [&] {
+        CachedImageInfo bucket = info.makeBucket(fTile);
+        if (bucket.imageInfo.dimensions() == info.imageInfo.dimensions()) {
+            return info.makeRasterImage(fPicture.get());
         }
-
-        SkResourceCache::Add(new ImageFromPictureRec(key, image));
-        SkPicturePriv::AddedToCache(fPicture.get());
+        sk_sp<SkImage> bucketImage = find_or_make_image(makeKey(bucket), fPicture.get(), [&] {
+            return bucket.makeRasterImage(fPicture.get());
+        });
+        sk_sp<SkSurface> surface = SkSurface::MakeRaster(info.imageInfo);
+        if (!bucketImage || !surface) {
+            return sk_sp<SkImage>();
+        }
+        SkPaint paint;
+        paint.setBlendMode(SkBlendMode::kSrc);
+        // The bucket is at most about twice as big, so bilerp reaches every one of its pixels.
+        surface->getCanvas()->drawImageRect(bucketImage, SkRect::Make(info.imageInfo.bounds()),
+                                            SkSamplingOptions(SkFilterMode::kLinear), &paint);
+        return surface->makeImageSnapshot();
+    });
+    if (!image) {
+        return nullptr;
     }
     return image->makeShader(fTmx, fTmy, SkSamplingOptions(fFilter), nullptr);
 }
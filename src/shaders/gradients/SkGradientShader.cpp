@@ -275,6 +275,42 @@ static void init_stop_pos(
     add_stop_color(ctx, stop, Fs, Bs);
 }
 
+const SkGradientShaderBase::StopBuckets& SkGradientShaderBase::stopBuckets(
+        const float* ts, size_t stopCount) const {
+    fStopBucketsOnce([&] {
+        // With few stops, comparing t against each of them is as fast as the bucket lookup.
+        constexpr size_t kMinStopsForBuckets = 16;
+        if (stopCount < kMinStopsForBuckets) {
+            return;
+        }
+
+        // About four buckets per stop leaves most buckets with no stop inside them at all.
+        const int bucketCount = SkToInt(4 * stopCount);
+        SkTArray<int> stopsInBucket;
+        stopsInBucket.push_back_n(bucketCount + 1, 0);
+        for (size_t i = 1; i < stopCount; ++i) {
+            // The same math as gradient_bucket_search() in SkRasterPipeline_opts.h.
+            stopsInBucket[(int)(ts[i] * (float)bucketCount)] += 1;
+        }
+
+        int maxStopsInBucket = 0;
+        uint32_t stopsBefore = 0;
+        SkTArray<uint32_t> buckets(bucketCount + 1);
+        for (int count : stopsInBucket) {
+            buckets.push_back(stopsBefore);
+            stopsBefore += count;
+            maxStopsInBucket = std::max(maxStopsInBucket, count);
+        }
+
+        // Stops bunched into a few buckets would take as many steps as the direct search.
+        if (maxStopsInBucket <= SkToInt(stopCount / 4)) {
+            fStopBuckets.fBuckets = std::move(buckets);
+            fStopBuckets.fMaxStopsInBucket = maxStopsInBucket;
+        }
+    });
+    return fStopBuckets;
+}
+
 bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
     SkRasterPipeline* p = rec.fPipeline;
     SkArenaAlloc* alloc = rec.fAlloc;
@@ -367,7 +403,8 @@ bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
         } else {
             // Handle arbitrary stops.
 
-            ctx->ts = alloc->makeArray<float>(fColorCount+1);
+            // One more than the stops, for the NaN that ends a bucket search.
+            ctx->ts = alloc->makeArray<float>(fColorCount+2);
 
             // Remove the default stops inserted by SkGradientShaderBase::SkGradientShaderBase
             // because they are naturally handled by the search method.
@@ -403,6 +440,13 @@ bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
             add_const_color(ctx, stopCount++, c_l);
 
             ctx->stopCount = stopCount;
+            const StopBuckets& buckets = this->stopBuckets(ctx->ts, stopCount);
+            if (!buckets.fBuckets.empty()) {
+                ctx->ts[stopCount]    = SK_FloatNaN;
+                ctx->buckets          = buckets.fBuckets.data();
+                ctx->bucketCount      = buckets.fBuckets.count() - 1;
+                ctx->maxStopsInBucket = buckets.fMaxStopsInBucket;
+            }
             p->append(SkRasterPipeline::gradient, ctx);
         }
     }
@@ -11,6 +11,7 @@
 #include "include/effects/SkGradientShader.h"
 
 #include "include/core/SkMatrix.h"
+#include "include/private/SkOnce.h"
 #include "include/private/SkTArray.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkArenaAlloc.h"
@@ -132,6 +133,18 @@ public:
     SkTileMode getTileMode() const { return fTileMode; }
 
 private:
+    // Speeds up the raster pipeline gradient stage's search for t's stop when there are many
+    // stops (see SkRasterPipeline_GradientCtx). It only depends on the stop positions, so it's
+    // built by the first draw and shared by the rest.
+    struct StopBuckets {
+        SkTArray<uint32_t> fBuckets;    // empty when searching the stops directly is as fast
+        int                fMaxStopsInBucket = 0;
+    };
+    const StopBuckets& stopBuckets(const float* ts, size_t stopCount) const;
+
+    mutable SkOnce      fStopBucketsOnce;
+    mutable StopBuckets fStopBuckets;
+
     // Reserve inline space for up to 4 stops.
     inline static constexpr size_t kInlineStopCount   = 4;
     inline static constexpr size_t kInlineStorageSize = (sizeof(SkColor4f) + sizeof(SkScalar))
@@ -9,6 +9,8 @@
 #include "include/private/SkSLString.h"
 #include "src/sksl/SkSLBuiltinMap.h"
 
+#include <iterator>
+
 namespace SkSL {
 
 void BuiltinMap::insertOrDie(std::string key, std::unique_ptr<ProgramElement> element) {
@@ -16,25 +18,68 @@ void BuiltinMap::insertOrDie(std::string key, std::unique_ptr<ProgramElement> el
     fElements[key] = BuiltinElement{std::move(element), false};
 }
 
-const ProgramElement* BuiltinMap::find(const std::string& key) {
+void BuiltinMap::insertDeferred(std::vector<std::string> keys,
+                                bool needsAncestors,
+                                std::function<void(BuiltinMap&)> load) {
+    SkASSERT(!fLoadDeferred);
+    fDeferredKeys.insert(std::make_move_iterator(keys.begin()), std::make_move_iterator(keys.end()));
+    fDeferredNeedsAncestors = needsAncestors;
+    fLoadDeferred = std::move(load);
+}
+
+void BuiltinMap::loadDeferred() {
+    if (!fLoadDeferred) {
+        return;
+    }
+    if (fDeferredNeedsAncestors) {
+        // Our elements may refer to any of our ancestors' elements, so those are loaded first (from
+        // the root down), exactly as if every map had been populated up front.
+        std::vector<BuiltinMap*> ancestors;
+        for (BuiltinMap* map = fParent; map; map = map->fParent) {
+            ancestors.push_back(map);
+        }
+        for (auto iter = ancestors.rbegin(); iter != ancestors.rend(); ++iter) {
+            (*iter)->loadDeferred();
+        }
+    }
+    std::function<void(BuiltinMap&)> load = std::move(fLoadDeferred);
+    fLoadDeferred = nullptr;
+    fDeferredKeys.clear();
+    load(*this);
+}
+
+BuiltinMap::BuiltinElement* BuiltinMap::lookup(const std::string& key) {
     auto iter = fElements.find(key);
     if (iter == fElements.end()) {
+        if (fDeferredKeys.find(key) == fDeferredKeys.end()) {
+            return nullptr;
+        }
+        this->loadDeferred();
+        iter = fElements.find(key);
+        SkASSERT(iter != fElements.end());
+    }
+    return &iter->second;
+}
+
+const ProgramElement* BuiltinMap::find(const std::string& key) {
+    BuiltinElement* element = this->lookup(key);
+    if (!element) {
         return fParent ? fParent->find(key) : nullptr;
     }
-    return iter->second.fElement.get();
+    return element->fElement.get();
 }
 
 // Only returns a builtin element that isn't already marked as included, and then marks it.
 const ProgramElement* BuiltinMap::findAndInclude(const std::string& key) {
-    auto iter = fElements.find(key);
-    if (iter == fElements.end()) {
+    BuiltinElement* element = this->lookup(key);
+    if (!element) {
         return fParent ? fParent->findAndInclude(key) : nullptr;
     }
-    if (iter->second.fAlreadyIncluded) {
+    if (element->fAlreadyIncluded) {
         return nullptr;
     }
-    iter->second.fAlreadyIncluded = true;
-    return iter->second.fElement.get();
+    element->fAlreadyIncluded = true;
+    return element->fElement.get();
 }
 
 void BuiltinMap::resetAlreadyIncluded() {
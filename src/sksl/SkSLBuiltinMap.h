@@ -10,8 +10,11 @@
 
 #include "include/private/SkSLString.h"
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace SkSL {
 
@@ -26,6 +29,13 @@ public:
 
     void insertOrDie(std::string key, std::unique_ptr<ProgramElement> element);
 
+    // Registers the keys of elements which have not been loaded yet. The first time one of them is
+    // looked up, `load` is invoked, and must insert all of them. When `needsAncestors` is set, the
+    // elements of every parent map are loaded beforehand.
+    void insertDeferred(std::vector<std::string> keys,
+                        bool needsAncestors,
+                        std::function<void(BuiltinMap&)> load);
+
     const ProgramElement* find(const std::string& key);
 
     const ProgramElement* findAndInclude(const std::string& key);
@@ -38,8 +48,16 @@ private:
         bool fAlreadyIncluded = false;
     };
 
+    BuiltinElement* lookup(const std::string& key);
+
+    void loadDeferred();
+
     std::unordered_map<std::string, BuiltinElement> fElements;
     BuiltinMap* fParent = nullptr;
+
+    std::unordered_set<std::string> fDeferredKeys;
+    std::function<void(BuiltinMap&)> fLoadDeferred;
+    bool fDeferredNeedsAncestors = false;
 };
 
 } // namespace SkSL
@@ -16,6 +16,7 @@
 #include "src/sksl/SkSLConstantFolder.h"
 #include "src/sksl/SkSLDSLParser.h"
 #include "src/sksl/SkSLOperators.h"
+#include "src/sksl/SkSLPool.h"
 #include "src/sksl/SkSLProgramSettings.h"
 #include "src/sksl/SkSLRehydrator.h"
 #include "src/sksl/SkSLThreadContext.h"
@@ -125,16 +126,54 @@ public:
 class AutoModifiersPool {
 public:
     AutoModifiersPool(std::shared_ptr<Context>& context, ModifiersPool* modifiersPool)
-            : fContext(context.get()) {
-        SkASSERT(!fContext->fModifiersPool);
+            : fContext(context.get())
+            , fOldModifiersPool(fContext->fModifiersPool) {
         fContext->fModifiersPool = modifiersPool;
     }
 
     ~AutoModifiersPool() {
-        fContext->fModifiersPool = nullptr;
+        fContext->fModifiersPool = fOldModifiersPool;
     }
 
     Context* fContext;
+    ModifiersPool* fOldModifiersPool;
+};
+
+// Deferred module elements can be loaded while a program is being compiled. Those elements belong
+// to the compiler, so they must not be allocated from the program's memory pool, and errors
+// already reported against the program must not interfere with them.
+class AutoModuleLoadingScope {
+public:
+    AutoModuleLoadingScope(std::shared_ptr<Context>& context)
+            : fContext(context.get())
+            , fOldErrors(fContext->fErrors) {
+        if (Pool::IsAttached()) {
+            fPool = ThreadContext::MemoryPool().get();
+            fPool->detachFromThread();
+        }
+        fContext->fErrors = &fErrors;
+    }
+
+    ~AutoModuleLoadingScope() {
+        SkASSERT(fErrors.errorCount() == 0);
+        fContext->fErrors = fOldErrors;
+        if (fPool) {
+            fPool->attachToThread();
+        }
+    }
+
+private:
+    class ModuleErrorReporter : public ErrorReporter {
+    public:
+        void handleError(std::string_view msg, PositionInfo pos) override {
+            SkDEBUGFAILF("error in built-in module: %.*s", (int)msg.length(), msg.data());
+        }
+    };
+
+    Context* fContext;
+    ErrorReporter* fOldErrors;
+    ModuleErrorReporter fErrors;
+    Pool* fPool = nullptr;
 };
 
 Compiler::Compiler(const ShaderCaps* caps)
@@ -356,7 +395,9 @@ LoadedModule Compiler::loadModule(ProgramKind kind,
     AutoProgramConfig autoConfig(fContext, &config);
     SkASSERT(data.fData && (data.fSize != 0));
     Rehydrator rehydrator(*this, data.fData, data.fSize, std::move(base));
-    LoadedModule result = { kind, rehydrator.symbolTable(), rehydrator.elements() };
+    std::shared_ptr<SymbolTable> symbols = rehydrator.symbolTable();
+    rehydrator.elementIndex();
+    LoadedModule result = { kind, std::move(symbols), rehydrator.elements() };
 #else
     SkASSERT(this->errorCount() == 0);
     SkASSERT(data.fPath);
@@ -378,26 +419,16 @@ LoadedModule Compiler::loadModule(ProgramKind kind,
     return result;
 }
 
-ParsedModule Compiler::parseModule(ProgramKind kind, ModuleData data, const ParsedModule& base) {
-    LoadedModule module = this->loadModule(kind, data, base.fSymbols, /*dehydrate=*/false);
-    this->optimize(module);
-
-    // For modules that just declare (but don't define) intrinsic functions, there will be no new
-    // program elements. In that case, we can share our parent's element map:
-    if (module.fElements.empty()) {
-        return ParsedModule{module.fSymbols, base.fElements};
-    }
-
-    auto elements = std::make_shared<BuiltinMap>(base.fElements.get());
-
-    // Now, transfer all of the program elements to a builtin element map. This maps certain types
-    // of global objects to the declaring ProgramElement.
-    for (std::unique_ptr<ProgramElement>& element : module.fElements) {
+static void insert_module_elements(BuiltinMap* map,
+                                   std::vector<std::unique_ptr<ProgramElement>> moduleElements) {
+    // Transfer all of the program elements to a builtin element map. This maps certain types of
+    // global objects to the declaring ProgramElement.
+    for (std::unique_ptr<ProgramElement>& element : moduleElements) {
         switch (element->kind()) {
             case ProgramElement::Kind::kFunction: {
                 const FunctionDefinition& f = element->as<FunctionDefinition>();
                 SkASSERT(f.declaration().isBuiltin());
-                elements->insertOrDie(f.declaration().description(), std::move(element));
+                map->insertOrDie(f.declaration().description(), std::move(element));
                 break;
             }
             case ProgramElement::Kind::kFunctionPrototype: {
@@ -408,13 +439,13 @@ ParsedModule Compiler::parseModule(ProgramKind kind, ModuleData data, const Pars
                 const GlobalVarDeclaration& global = element->as<GlobalVarDeclaration>();
                 const Variable& var = global.declaration()->as<VarDeclaration>().var();
                 SkASSERT(var.isBuiltin());
-                elements->insertOrDie(std::string(var.name()), std::move(element));
+                map->insertOrDie(std::string(var.name()), std::move(element));
                 break;
             }
             case ProgramElement::Kind::kInterfaceBlock: {
                 const Variable& var = element->as<InterfaceBlock>().variable();
                 SkASSERT(var.isBuiltin());
-                elements->insertOrDie(std::string(var.name()), std::move(element));
+                map->insertOrDie(std::string(var.name()), std::move(element));
                 break;
             }
             default:
@@ -423,8 +454,77 @@ ParsedModule Compiler::parseModule(ProgramKind kind, ModuleData data, const Pars
                 break;
         }
     }
+}
+
+ParsedModule Compiler::parseModule(ProgramKind kind, ModuleData data, const ParsedModule& base) {
+#if REHYDRATE
+    // Only the module's symbols are rehydrated up front. Function bodies and global declarations
+    // are rehydrated (and optimized) the first time one of them is looked up in the element map,
+    // which many programs never do.
+    SkASSERT(data.fData && (data.fSize != 0));
+    auto rehydrator = std::make_shared<Rehydrator>(*this, data.fData, data.fSize, base.fSymbols);
+    std::shared_ptr<SymbolTable> symbols;
+    Rehydrator::ElementIndex index;
+    {
+        AutoModifiersPool autoPool(fContext, &fCoreModifiers);
+        ProgramConfig config;
+        config.fIsBuiltinCode = true;
+        config.fKind = kind;
+        config.fSettings.fReplaceSettings = true;
+        AutoProgramConfig autoConfig(fContext, &config);
+        symbols = rehydrator->symbolTable();
+        index = rehydrator->elementIndex();
+    }
+
+    // For modules that just declare (but don't define) intrinsic functions, there will be no new
+    // program elements. In that case, we can share our parent's element map:
+    if (index.fKeys.empty()) {
+        return ParsedModule{std::move(symbols), base.fElements};
+    }
+
+    auto elements = std::make_shared<BuiltinMap>(base.fElements.get());
+    elements->insertDeferred(std::move(index.fKeys), index.fHasFunctions,
+                             [this, kind, symbols, rehydrator](BuiltinMap& map) {
+        this->loadDeferredModuleElements(kind, symbols, *rehydrator, map);
+    });
+    return ParsedModule{std::move(symbols), std::move(elements)};
+#else
+    LoadedModule module = this->loadModule(kind, data, base.fSymbols, /*dehydrate=*/false);
+    this->optimize(module);
+
+    // For modules that just declare (but don't define) intrinsic functions, there will be no new
+    // program elements. In that case, we can share our parent's element map:
+    if (module.fElements.empty()) {
+        return ParsedModule{module.fSymbols, base.fElements};
+    }
 
+    auto elements = std::make_shared<BuiltinMap>(base.fElements.get());
+    insert_module_elements(elements.get(), std::move(module.fElements));
     return ParsedModule{module.fSymbols, std::move(elements)};
+#endif
+}
+
+void Compiler::loadDeferredModuleElements(ProgramKind kind,
+                                          std::shared_ptr<SymbolTable> symbols,
+                                          Rehydrator& rehydrator,
+                                          BuiltinMap& map) {
+    TRACE_EVENT0("skia.shaders", "SkSL::Compiler::loadDeferredModuleElements");
+    AutoModuleLoadingScope autoScope(fContext);
+    AutoModifiersPool autoPool(fContext, &fCoreModifiers);
+
+    ProgramConfig config;
+    config.fIsBuiltinCode = true;
+    config.fKind = kind;
+    config.fSettings.fReplaceSettings = true;
+    AutoProgramConfig autoConfig(fContext, &config);
+
+    // The inliner borrows fSymbolTable, which may currently belong to a program.
+    std::shared_ptr<SymbolTable> programSymbols = std::move(fSymbolTable);
+    LoadedModule module = { kind, std::move(symbols), rehydrator.elements() };
+    this->optimize(module);
+    fSymbolTable = std::move(programSymbols);
+
+    insert_module_elements(&map, std::move(module.fElements));
 }
 
 std::unique_ptr<Program> Compiler::convertProgram(ProgramKind kind,
@@ -45,9 +45,11 @@ namespace dsl {
     class DSLWriter;
 }
 
+class BuiltinMap;
 class ExternalFunction;
 class FunctionDeclaration;
 class ProgramUsage;
+class Rehydrator;
 struct ShaderCaps;
 
 struct LoadedModule {
@@ -238,6 +240,12 @@ private:
     /** Optimize the module. */
     bool optimize(LoadedModule& module);
 
+    /** Rehydrates and optimizes the elements of a module whose loading was deferred. */
+    void loadDeferredModuleElements(ProgramKind kind,
+                                    std::shared_ptr<SymbolTable> symbols,
+                                    Rehydrator& rehydrator,
+                                    BuiltinMap& map);
+
     /** Flattens out function calls when it is safe to do so. */
     bool runInliner(const std::vector<std::unique_ptr<ProgramElement>>& elements,
                     std::shared_ptr<SymbolTable> symbols,
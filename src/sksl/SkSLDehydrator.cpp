@@ -7,6 +7,7 @@
 
 #include "src/sksl/SkSLDehydrator.h"
 
+#include <algorithm>
 #include <map>
 
 #include "include/private/SkSLProgramElement.h"
@@ -15,6 +16,7 @@
 #include "src/sksl/SkSLRehydrator.h"
 #include "src/sksl/ir/SkSLBinaryExpression.h"
 #include "src/sksl/ir/SkSLBreakStatement.h"
+#include "src/sksl/ir/SkSLChildCall.h"
 #include "src/sksl/ir/SkSLConstructor.h"
 #include "src/sksl/ir/SkSLConstructorArray.h"
 #include "src/sksl/ir/SkSLConstructorArrayCast.h"
@@ -286,9 +288,17 @@ void Dehydrator::write(const Expression* e) {
                 this->write(b.right().get());
                 break;
             }
-            case Expression::Kind::kChildCall:
-                SkDEBUGFAIL("unimplemented--not expected to be used from within an include file");
+            case Expression::Kind::kChildCall: {
+                const ChildCall& c = e->as<ChildCall>();
+                this->writeCommand(Rehydrator::kChildCall_Command);
+                this->write(c.type());
+                this->writeId(&c.child());
+                this->writeU8(c.arguments().size());
+                for (const auto& a : c.arguments()) {
+                    this->write(a.get());
+                }
                 break;
+            }
 
             case Expression::Kind::kCodeString:
                 SkDEBUGFAIL("shouldn't be able to receive kCodeString here");
@@ -622,6 +632,40 @@ void Dehydrator::write(const std::vector<std::unique_ptr<ProgramElement>>& eleme
     this->writeCommand(Rehydrator::kElementsComplete_Command);
 }
 
+void Dehydrator::writeIndex(const std::vector<std::unique_ptr<ProgramElement>>& elements) {
+    this->writeCommand(Rehydrator::kElementIndex_Command);
+    int count = std::count_if(elements.begin(), elements.end(),
+                              [](const std::unique_ptr<ProgramElement>& e) {
+                                  return !e->is<FunctionPrototype>();
+                              });
+    this->writeU16(count);
+    for (const auto& e : elements) {
+        switch (e->kind()) {
+            case ProgramElement::Kind::kFunction:
+                this->writeCommand(Rehydrator::kFunctionDefinition_Command);
+                this->writeU16(this->symbolId(&e->as<FunctionDefinition>().declaration()));
+                break;
+            case ProgramElement::Kind::kGlobalVar: {
+                const VarDeclaration& decl =
+                        e->as<GlobalVarDeclaration>().declaration()->as<VarDeclaration>();
+                this->writeCommand(Rehydrator::kGlobalVar_Command);
+                this->writeU16(this->symbolId(&decl.var()));
+                break;
+            }
+            case ProgramElement::Kind::kInterfaceBlock:
+                this->writeCommand(Rehydrator::kInterfaceBlock_Command);
+                this->write(e->as<InterfaceBlock>().variable().name());
+                break;
+            case ProgramElement::Kind::kFunctionPrototype:
+                break;
+            default:
+                // Modules don't contain any other kind of element.
+                SkASSERT(false);
+                break;
+        }
+    }
+}
+
 void Dehydrator::write(const Program& program) {
     this->writeCommand(Rehydrator::kProgram_Command);
     this->writeU8((int)program.fConfig->fKind);
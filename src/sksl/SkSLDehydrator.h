@@ -49,6 +49,10 @@ public:
 
     void write(const std::vector<std::unique_ptr<ProgramElement>>& elements);
 
+    // Writes an index of a module's elements, which allows the Rehydrator to defer reading the
+    // elements themselves until one of them is needed. Must be followed by the elements.
+    void writeIndex(const std::vector<std::unique_ptr<ProgramElement>>& elements);
+
     void finish(OutputStream& out);
 
     // Inserts line breaks at meaningful offsets.
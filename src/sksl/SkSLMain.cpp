@@ -535,6 +535,7 @@ ResultCode processCommand(const std::vector<std::string>& args) {
                                     /*base=*/nullptr, /*dehydrate=*/true);
         SkSL::Dehydrator dehydrator;
         dehydrator.write(*module.fSymbols);
+        dehydrator.writeIndex(module.fElements);
         dehydrator.write(module.fElements);
         std::string baseName = base_name(inputPath, "", ".sksl");
         SkSL::StringStream buffer;
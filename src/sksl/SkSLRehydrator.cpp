@@ -19,6 +19,7 @@
 #include "src/sksl/SkSLThreadContext.h"
 #include "src/sksl/ir/SkSLBinaryExpression.h"
 #include "src/sksl/ir/SkSLBreakStatement.h"
+#include "src/sksl/ir/SkSLChildCall.h"
 #include "src/sksl/ir/SkSLConstructor.h"
 #include "src/sksl/ir/SkSLConstructorArray.h"
 #include "src/sksl/ir/SkSLConstructorArrayCast.h"
@@ -102,8 +103,9 @@ Rehydrator::Rehydrator(Compiler& compiler, const uint8_t* src, size_t length,
 
 #ifdef SK_DEBUG
 Rehydrator::~Rehydrator() {
-    // ensure that we have read the expected number of bytes
-    SkASSERT(fIP == fEnd);
+    // ensure that we have read the expected number of bytes (unless a module's elements were never
+    // needed)
+    SkASSERT(fIP == fEnd || fElementsPending);
 }
 #endif
 
@@ -293,7 +295,9 @@ std::unique_ptr<Program> Rehydrator::program() {
     Program::Inputs inputs;
     inputs.fUseFlipRTUniform = this->readU8();
     std::unique_ptr<Pool> pool = std::move(ThreadContext::MemoryPool());
-    pool->detachFromThread();
+    if (pool) {
+        pool->detachFromThread();
+    }
     std::unique_ptr<Program> result = std::make_unique<Program>(nullptr, std::move(config),
             fCompiler.fContext, std::move(elements),
             /*sharedElements=*/std::vector<const ProgramElement*>(), std::move(modifiers),
@@ -306,6 +310,7 @@ std::unique_ptr<Program> Rehydrator::program() {
 std::vector<std::unique_ptr<ProgramElement>> Rehydrator::elements() {
     SkDEBUGCODE(uint8_t command = )this->readU8();
     SkASSERT(command == kElements_Command);
+    SkDEBUGCODE(fElementsPending = false;)
     std::vector<std::unique_ptr<ProgramElement>> result;
     while (std::unique_ptr<ProgramElement> elem = this->element()) {
         result.push_back(std::move(elem));
@@ -313,6 +318,38 @@ std::vector<std::unique_ptr<ProgramElement>> Rehydrator::elements() {
     return result;
 }
 
+Rehydrator::ElementIndex Rehydrator::elementIndex() {
+    SkDEBUGCODE(uint8_t command = )this->readU8();
+    SkASSERT(command == kElementIndex_Command);
+    SkDEBUGCODE(fElementsPending = true;)
+    ElementIndex result;
+    uint16_t count = this->readU16();
+    result.fKeys.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        switch (this->readU8()) {
+            case kFunctionDefinition_Command: {
+                const FunctionDeclaration* decl = this->symbolRef<FunctionDeclaration>(
+                                                                Symbol::Kind::kFunctionDeclaration);
+                result.fKeys.push_back(decl->description());
+                result.fHasFunctions = true;
+                break;
+            }
+            case kGlobalVar_Command: {
+                const Variable* var = this->symbolRef<Variable>(Symbol::Kind::kVariable);
+                result.fKeys.push_back(std::string(var->name()));
+                break;
+            }
+            case kInterfaceBlock_Command:
+                result.fKeys.push_back(std::string(this->readString()));
+                break;
+            default:
+                SkASSERT(false);
+                break;
+        }
+    }
+    return result;
+}
+
 std::unique_ptr<ProgramElement> Rehydrator::element() {
     int kind = this->readU8();
     switch (kind) {
@@ -632,6 +669,12 @@ std::unique_ptr<Expression> Rehydrator::expression() {
         }
         case Rehydrator::kVoid_Command:
             return nullptr;
+        case Rehydrator::kChildCall_Command: {
+            const Type* type = this->type();
+            const Variable* child = this->symbolRef<Variable>(Symbol::Kind::kVariable);
+            ExpressionArray args = this->expressionArray();
+            return ChildCall::Make(this->context(), /*line=*/-1, type, *child, std::move(args));
+        }
         default:
             printf("unsupported expression %d\n", kind);
             SkASSERT(false);
@@ -661,13 +704,11 @@ std::shared_ptr<SymbolTable> Rehydrator::symbolTable() {
         if (index != kBuiltin_Symbol) {
             fSymbolTable->addWithoutOwnership(ownedSymbols[index]);
         } else {
+            // Builtins are looked up through the enclosing tables, which for programs include the
+            // module they were compiled against (not just the root table).
             std::string_view name = this->readString();
-            SymbolTable* root = fSymbolTable.get();
-            while (root->fParent) {
-                root = root->fParent.get();
-            }
-            const Symbol* s = (*root)[name];
-            SkASSERT(s);
+            const Symbol* s = (*fSymbolTable->fParent)[name];
+            SkASSERTF(s, "symbol '%s' not found", std::string(name).c_str());
             fSymbolTable->addWithoutOwnership(s);
         }
     }
@@ -14,6 +14,7 @@
 #include "src/sksl/SkSLContext.h"
 #include "src/sksl/ir/SkSLProgram.h"
 
+#include <string>
 #include <vector>
 
 namespace SkSL {
@@ -34,7 +35,7 @@ class Type;
  */
 class Rehydrator {
 public:
-    static constexpr uint16_t kVersion = 8;
+    static constexpr uint16_t kVersion = 9;
 
     // see binary_format.md for a description of the command data
     enum Command {
@@ -97,6 +98,19 @@ public:
         kVarDeclaration_Command,
         kVariableReference_Command,
         kVoid_Command,
+        // Commands below this point were added after the enum was sorted, and are kept at the end
+        // so that existing dehydrated files remain valid.
+        kChildCall_Command,
+        kElementIndex_Command,
+    };
+
+    // Describes the program elements of a module without reading them; see elementIndex().
+    struct ElementIndex {
+        // The BuiltinMap keys of the module's function definitions, global variables and interface
+        // blocks, in the order they are stored.
+        std::vector<std::string> fKeys;
+        // True if any of the elements is a function definition.
+        bool fHasFunctions = false;
     };
 
     // src must remain in memory as long as the objects created from it do
@@ -113,6 +127,11 @@ public:
     // Reads a collection of program elements and returns it
     std::vector<std::unique_ptr<ProgramElement>> elements();
 
+    // Reads the index that precedes a module's elements. The elements themselves can then be read
+    // with elements() at a later time, as long as this Rehydrator is kept alive; they are always
+    // the last thing in a module.
+    ElementIndex elementIndex();
+
     // Reads an entire program.
     //
     // NOTE: The program is initialized using a new ProgramConfig that may differ from the one that
@@ -223,6 +242,7 @@ private:
     const uint8_t* fStringStart;
     const uint8_t* fIP;
     SkDEBUGCODE(const uint8_t* fEnd;)
+    SkDEBUGCODE(bool fElementsPending = false;)
 
     friend class AutoRehydratorSymbolTable;
     friend class Dehydrator;
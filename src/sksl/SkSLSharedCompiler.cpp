@@ -35,19 +35,67 @@ struct SharedCompiler::Impl {
 
     std::unique_ptr<SkSL::ShaderCaps> fCaps;
     SkSL::Compiler*                   fCompiler;
+    SkMutex                           fMutex;
+
+    // The number of SharedCompilers holding or waiting for fMutex; guarded by pool_mutex().
+    int fUsers = 0;
 };
 
-SharedCompiler::Impl* SharedCompiler::gImpl = nullptr;
+// Each compiler keeps its own copy of the built-in modules, and compilers are never destroyed
+// (programs and effects refer to them), so the pool is kept small.
+static constexpr size_t kMaxSharedCompilers = 4;
+
+std::vector<SharedCompiler::Impl*>* SharedCompiler::gPool = nullptr;
+
+SharedCompiler::SharedCompiler() : SharedCompiler(nullptr) {}
+
+SharedCompiler::SharedCompiler(const Context* context) : fImpl(Acquire(context)) {}
+
+// The compiler lock is held for the lifetime of the SharedCompiler, which the analysis can't follow.
+SharedCompiler::~SharedCompiler() SK_NO_THREAD_SAFETY_ANALYSIS {
+    fImpl->fMutex.release();
+
+    SkAutoMutexExclusive lock(pool_mutex());
+    fImpl->fUsers--;
+}
 
-SharedCompiler::SharedCompiler() : fLock(compiler_mutex()) {
-    if (!gImpl) {
-        gImpl = new Impl();
+SharedCompiler::Impl* SharedCompiler::Acquire(const Context* context)
+        SK_NO_THREAD_SAFETY_ANALYSIS {
+    Impl* impl = nullptr;
+    {
+        SkAutoMutexExclusive lock(pool_mutex());
+        if (!gPool) {
+            gPool = new std::vector<Impl*>;
+        }
+        if (context) {
+            for (Impl* candidate : *gPool) {
+                if (&candidate->fCompiler->context() == context) {
+                    impl = candidate;
+                    break;
+                }
+            }
+        }
+        if (!impl) {
+            // Prefer an idle compiler, then a new one, and finally the least contended one.
+            for (Impl* candidate : *gPool) {
+                if (!impl || candidate->fUsers < impl->fUsers) {
+                    impl = candidate;
+                }
+            }
+            if ((!impl || impl->fUsers > 0) && gPool->size() < kMaxSharedCompilers) {
+                impl = new Impl();
+                gPool->push_back(impl);
+            }
+        }
+        impl->fUsers++;
     }
+    impl->fMutex.acquire();
+    return impl;
 }
 
-SkSL::Compiler* SharedCompiler::operator->() const { return gImpl->fCompiler; }
+SkSL::Compiler* SharedCompiler::operator->() const { return fImpl->fCompiler; }
 
-SkMutex& SharedCompiler::compiler_mutex() {
+SkMutex& SharedCompiler::pool_mutex() {
     static SkMutex& mutex = *(new SkMutex);
     return mutex;
 }
@@ -11,24 +11,45 @@
 #include "include/private/SkMutex.h"
 #include "src/sksl/SkSLCompiler.h"
 
+#include <vector>
+
 #ifdef SK_ENABLE_SKSL
 
 namespace SkSL {
 
-/** A shared compiler instance for runtime client SkSL that is internally guarded by a mutex. */
+/**
+ * A shared compiler instance for runtime client SkSL that is internally guarded by a mutex.
+ *
+ * A small pool of compilers is kept behind this interface, so that several threads can compile
+ * runtime client SkSL at the same time. Programs refer to state owned by the compiler that made
+ * them, so any later work on a program should lock that same compiler, via the Context overload.
+ */
 class SharedCompiler {
 public:
+    // Locks an idle compiler, creating a new one if all of them are busy (up to a limit).
     SharedCompiler();
 
+    // Locks the compiler which owns `context`. If `context` doesn't belong to any of the shared
+    // compilers (e.g. a DSL program built with a client's compiler), locks any compiler instead.
+    explicit SharedCompiler(const Context* context);
+
+    ~SharedCompiler();
+
+    SharedCompiler(const SharedCompiler&) = delete;
+    SharedCompiler& operator=(const SharedCompiler&) = delete;
+
     SkSL::Compiler* operator->() const;
 
 private:
-    SkAutoMutexExclusive fLock;
+    struct Impl;
 
-    static SkMutex& compiler_mutex();
+    static Impl* Acquire(const Context* context);
 
-    struct Impl;
-    static Impl* gImpl;
+    static SkMutex& pool_mutex();
+
+    static std::vector<Impl*>* gPool;
+
+    Impl* fImpl;
 };
 
 }  // namespace SkSL
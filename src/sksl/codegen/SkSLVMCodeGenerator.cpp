@@ -251,11 +251,20 @@ private:
             // As we encounter (possibly conditional) return statements, fReturned is updated to
             // store the lanes that have already returned. For the remainder of the current
             // function, those lanes should be disabled.
-            result = result & ~currentFunction().fReturned;
+            result = skvm::bit_clear(result, currentFunction().fReturned);
         }
         return result;
     }
 
+    /**
+     * Returns true if no lanes can be active here, e.g. after an unconditional `break` or `return`,
+     * or in a branch that is statically false for this iteration of an unrolled loop.
+     */
+    bool isMaskKnownZero() {
+        int imm;
+        return fBuilder->allImm(this->mask().id, &imm) && imm == 0;
+    }
+
     size_t fieldSlotOffset(const FieldAccess& expr);
     size_t indexSlotOffset(const IndexExpression& expr);
 
@@ -814,7 +823,9 @@ Value SkVMGenerator::writeBinaryExpression(const BinaryExpression& b) {
         for (int r = 0; r < lRows; ++r) {
             skvm::F32 sum = zero;
             for (int j = 0; j < lCols; ++j) {
-                sum += f32(lVal[j*lRows + r]) * f32(rVal[c*rRows + j]);
+                // Like component-wise multiplication, this uses `**` so that terms with a constant
+                // zero factor fold away. Diagonal, resized, and affine matrices are mostly zeros.
+                sum += f32(lVal[j*lRows + r]) ** f32(rVal[c*rRows + j]);
             }
             result[resultIdx++] = sum;
         }
@@ -1843,14 +1854,14 @@ void SkVMGenerator::writeBlock(const Block& b) {
 
 void SkVMGenerator::writeBreakStatement() {
     // Any active lanes stop executing for the duration of the current loop
-    fLoopMask &= ~this->mask();
+    fLoopMask = skvm::bit_clear(fLoopMask, this->mask());
 }
 
 void SkVMGenerator::writeContinueStatement() {
     // Any active lanes stop executing for the current iteration.
     // Remember them in fContinueMask, to be re-enabled later.
     skvm::I32 mask = this->mask();
-    fLoopMask &= ~mask;
+    fLoopMask = skvm::bit_clear(fLoopMask, mask);
     fContinueMask |= mask;
 }
 
@@ -1886,6 +1897,11 @@ void SkVMGenerator::writeForStatement(const ForStatement& f) {
 
             this->emitTraceLine(f.test() ? f.test()->fLine : f.fLine);
             val += loop.fDelta;
+
+            // Once every lane has left the loop (or returned), the remaining iterations are dead.
+            if (this->isMaskKnownZero()) {
+                break;
+            }
         }
 
         this->emitTraceScope(mask, -1);
@@ -1988,6 +2004,14 @@ void SkVMGenerator::emitTraceScope(skvm::I32 executionMask, int delta) {
 }
 
 void SkVMGenerator::writeStatement(const Statement& s) {
+    // Code that can't execute (e.g. a statically false branch in an unrolled loop) would only
+    // produce stores that skvm later discards, so skip generating it. Declarations still need
+    // their slots initialized, in case a later (live) statement refers to them.
+    if (this->isMaskKnownZero() && !s.is<VarDeclaration>() &&
+        !(s.is<Block>() && !s.as<Block>().isScope())) {
+        return;
+    }
+
     this->emitTraceLine(s.fLine);
 
     switch (s.kind()) {
@@ -8,6 +8,7 @@
 #include "src/sksl/ir/SkSLFunctionDeclaration.h"
 
 #include "include/private/SkStringView.h"
+#include "src/sksl/SkSLBuiltinMap.h"
 #include "src/sksl/SkSLCompiler.h"
 #include "src/sksl/ir/SkSLUnresolvedFunction.h"
 
@@ -349,6 +350,11 @@ static bool find_existing_declaration(const Context& context,
                     return false;
                 }
             }
+            if (other->isBuiltin() && !other->definition() && context.fBuiltins) {
+                // Built-in function bodies are loaded on demand. Make sure that the existing
+                // declaration is up to date before the definition is checked for duplicates.
+                context.fBuiltins->find(other->description());
+            }
             if (other->definition() && !other->isBuiltin()) {
                 errors.error(line, "duplicate definition of " + other->description());
                 return false;
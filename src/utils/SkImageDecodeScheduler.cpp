@@ -0,0 +1,183 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkImageDecodeScheduler.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkMatrix.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkTHash.h"
+#include "src/codec/SkCodecImageGenerator.h"
+#include "src/core/SkBitmapCache.h"
+#include "src/core/SkTDPQueue.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/image/SkImage_Base.h"
+
+struct SkImageDecodeScheduler::Request {
+    sk_sp<SkImage> fImage;
+    int            fPriority;
+    float          fScale;
+    uint64_t       fSequence;   // breaks ties between equal priorities, first come first served
+    int            fIndex = -1; // position in the Queue's SkTDPQueue
+
+    static bool Less(Request* const& a, Request* const& b) {
+        return a->fPriority != b->fPriority ? a->fPriority > b->fPriority
+                                            : a->fSequence < b->fSequence;
+    }
+    static int* Index(Request* const& r) { return &r->fIndex; }
+};
+
+class SkImageDecodeScheduler::Queue {
+public:
+    SkMutex fMutex;
+    // Requests that have not started, keyed by image ID. Each is also in fPending.
+    SkTHashMap<uint32_t, std::unique_ptr<Request>> fRequests SK_GUARDED_BY(fMutex);
+    SkTDPQueue<Request*, Request::Less, Request::Index> fPending SK_GUARDED_BY(fMutex);
+    uint64_t fNextSequence SK_GUARDED_BY(fMutex) = 0;
+
+    // Takes the request out of both containers, and returns it.
+    std::unique_ptr<Request> remove(Request* request) SK_REQUIRES(fMutex) {
+        const uint32_t id = request->fImage->uniqueID();
+        fPending.remove(request);
+        std::unique_ptr<Request> owned = std::move(*fRequests.find(id));
+        fRequests.remove(id);
+        return owned;
+    }
+};
+
+// Decodes the image into the raster cache, at a reduced size when its codec supports one that
+// covers 'scale'.
+static void decode(const SkImage* image, float scale) {
+    if (SkImageDecodeScheduler::IsDecoded(image, scale)) {
+        return;
+    }
+
+    if (scale < 1) {
+        // Images only return their encoded data when they draw it as is (e.g. not subsets or
+        // color conversions), so decoding it ourselves yields the same pixels the image would.
+        // Using our own generator also keeps this from holding up the image's generator.
+        sk_sp<SkData> data = image->refEncodedData();
+        auto generator = data ? SkCodecImageGenerator::MakeFromEncodedCodec(std::move(data))
+                              : nullptr;
+        if (generator) {
+            auto codecGenerator = static_cast<SkCodecImageGenerator*>(generator.get());
+            SkISize size = codecGenerator->getScaledDimensions(scale);
+            if (!size.isEmpty() &&
+                size.width() < image->width() && size.height() < image->height()) {
+                auto desc = SkBitmapCacheDesc::Make(image);
+                SkPixmap pmap;
+                SkBitmapCache::RecPtr rec =
+                        SkBitmapCache::AllocScaled(desc, image->imageInfo().makeDimensions(size),
+                                                   &pmap);
+                if (rec && codecGenerator->getPixels(pmap.info(), pmap.writable_addr(),
+                                                     pmap.rowBytes())) {
+                    SkBitmap bitmap;
+                    SkBitmapCache::Add(std::move(rec), &bitmap);
+                    as_IB(image)->notifyAddedToRasterCache();
+                    return;
+                }
+            }
+        }
+    }
+
+    SkBitmap bitmap;
+    (void)as_IB(image)->getROPixels(nullptr, &bitmap);
+}
+
+SkImageDecodeScheduler::SkImageDecodeScheduler(SkExecutor* executor)
+        : fQueue(new Queue)
+        , fTasks(new SkTaskGroup(executor ? *executor : SkExecutor::GetDefault())) {}
+
+SkImageDecodeScheduler::~SkImageDecodeScheduler() {
+    {
+        SkAutoMutexExclusive lock(fQueue->fMutex);
+        while (fQueue->fPending.count() > 0) {
+            fQueue->remove(fQueue->fPending.peek());
+        }
+    }
+    // The tasks for the dropped requests find nothing to do.
+    fTasks->wait();
+}
+
+void SkImageDecodeScheduler::enqueue(sk_sp<SkImage> image, int priority, float scale) {
+    if (!image || !image->isLazyGenerated()) {
+        return;
+    }
+
+    {
+        SkAutoMutexExclusive lock(fQueue->fMutex);
+        if (std::unique_ptr<Request>* queued = fQueue->fRequests.find(image->uniqueID())) {
+            Request* request = queued->get();
+            fQueue->fPending.remove(request);
+            request->fPriority = priority;
+            request->fScale    = scale;
+            fQueue->fPending.insert(request);
+            return;
+        }
+
+        const uint32_t id = image->uniqueID();
+        auto request = std::make_unique<Request>();
+        request->fImage    = std::move(image);
+        request->fPriority = priority;
+        request->fScale    = scale;
+        request->fSequence = fQueue->fNextSequence++;
+        fQueue->fPending.insert(request.get());
+        fQueue->fRequests.set(id, std::move(request));
+    }
+
+    // Each task decodes whichever request is first in line when it runs, not necessarily this one.
+    fTasks->add([this] { this->decodeNext(); });
+}
+
+bool SkImageDecodeScheduler::cancel(const SkImage* image) {
+    if (!image) {
+        return false;
+    }
+    SkAutoMutexExclusive lock(fQueue->fMutex);
+    std::unique_ptr<Request>* queued = fQueue->fRequests.find(image->uniqueID());
+    if (!queued) {
+        return false;
+    }
+    fQueue->remove(queued->get());
+    return true;
+}
+
+void SkImageDecodeScheduler::waitForAll() {
+    fTasks->wait();
+}
+
+void SkImageDecodeScheduler::decodeNext() {
+    std::unique_ptr<Request> request;
+    {
+        SkAutoMutexExclusive lock(fQueue->fMutex);
+        if (fQueue->fPending.count() == 0) {
+            return;     // cancelled
+        }
+        request = fQueue->remove(fQueue->fPending.peek());
+    }
+    decode(request->fImage.get(), request->fScale);
+}
+
+bool SkImageDecodeScheduler::IsDecoded(const SkImage* image, float scale) {
+    if (!image) {
+        return false;
+    }
+    if (!image->isLazyGenerated()) {
+        return true;
+    }
+
+    auto desc = SkBitmapCacheDesc::Make(image);
+    SkBitmap bitmap;
+    if (SkBitmapCache::Find(desc, &bitmap)) {
+        return true;
+    }
+    return scale > 0 &&
+           SkFindPrescaledBitmap(as_IB(image), SkMatrix::Scale(1 / scale, 1 / scale), &bitmap);
+}
@@ -14,6 +14,7 @@
 #include "src/utils/SkUTF.h"
 
 #include <cmath>
+#include <limits>
 #include <tuple>
 #include <vector>
 
@@ -899,6 +900,273 @@ void Write(const Value& v, SkWStream* stream) {
     }
 }
 
+// Compact binary DOM encoding, produced by DOM::writeBinary():
+//
+//   [magic (8 bytes)] [version (u32)] [root value]
+//
+// Each value is a one byte tag followed by a tag-specific payload:
+//
+//   kNull, kFalse, kTrue -> no payload
+//   kInt                 -> zigzag varint
+//   kFloat               -> float (little-endian, unaligned)
+//   kString              -> varint length, followed by (length) chars (no terminator)
+//   kArray               -> varint count, followed by (count) values
+//   kObject              -> varint count, followed by (count) [key string payload] [value] pairs
+//
+// Varints use the common LEB128 encoding (7 bits per byte, low bits first).  Since counts and
+// lengths are known upfront, the reader can allocate final storage directly and skip all
+// tokenizing/number parsing.
+static constexpr char     kBinaryMagic[] = { '\x89', 'S', 'K', 'J', 'S', 'O', 'N', '\n' };
+static constexpr uint32_t kBinaryVersion = 1;
+
+// Guards against stack exhaustion for malicious inputs.
+static constexpr int      kBinaryMaxDepth = 1024;
+
+enum class BinaryTag : uint8_t {
+    kNull,
+    kFalse,
+    kTrue,
+    kInt,
+    kFloat,
+    kString,
+    kArray,
+    kObject,
+};
+
+void WriteVarint(uint32_t v, SkWStream* stream) {
+    while (v >= 0x80) {
+        stream->write8(SkToU8((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    stream->write8(SkToU8(v));
+}
+
+void WriteBinaryString(const StringValue& str, SkWStream* stream) {
+    WriteVarint(SkToU32(str.size()), stream);
+    stream->write(str.begin(), str.size());
+}
+
+void WriteBinary(const Value& v, SkWStream* stream) {
+    switch (v.getType()) {
+    case Value::Type::kNull:
+        stream->write8(SkToU8(BinaryTag::kNull));
+        break;
+    case Value::Type::kBool:
+        stream->write8(SkToU8(*v.as<BoolValue>() ? BinaryTag::kTrue : BinaryTag::kFalse));
+        break;
+    case Value::Type::kNumber: {
+        // Numbers are stored as either int32 or float, so the conversions below are lossless.
+        const auto n = *v.as<NumberValue>();
+        // Only cast values in range: converting anything else to int32 is undefined.
+        if (n >= std::numeric_limits<int32_t>::min() &&
+            n <= std::numeric_limits<int32_t>::max()) {
+            const auto i = static_cast<int32_t>(n);
+            if (static_cast<double>(i) == n) {
+                stream->write8(SkToU8(BinaryTag::kInt));
+                WriteVarint((static_cast<uint32_t>(i) << 1) ^ static_cast<uint32_t>(i >> 31),
+                            stream);
+                break;
+            }
+        }
+        stream->write8(SkToU8(BinaryTag::kFloat));
+        stream->writeScalar(static_cast<float>(n));
+        break;
+    }
+    case Value::Type::kString:
+        stream->write8(SkToU8(BinaryTag::kString));
+        WriteBinaryString(v.as<StringValue>(), stream);
+        break;
+    case Value::Type::kArray: {
+        const auto& array = v.as<ArrayValue>();
+        stream->write8(SkToU8(BinaryTag::kArray));
+        WriteVarint(SkToU32(array.size()), stream);
+        for (const auto& entry : array) {
+            WriteBinary(entry, stream);
+        }
+        break;
+    }
+    case Value::Type::kObject:
+        const auto& object = v.as<ObjectValue>();
+        stream->write8(SkToU8(BinaryTag::kObject));
+        WriteVarint(SkToU32(object.size()), stream);
+        for (const auto& member : object) {
+            WriteBinaryString(member.fKey.as<StringValue>(), stream);
+            WriteBinary(member.fValue, stream);
+        }
+        break;
+    }
+}
+
+bool IsBinary(const char* data, size_t size) {
+    return size >= sizeof(kBinaryMagic) && !memcmp(data, kBinaryMagic, sizeof(kBinaryMagic));
+}
+
+// Array/Object record with (count) uninitialized slots, to be filled in place by the reader.
+template <typename VectorT>
+class UninitializedVector final : public Value {
+public:
+    using T = typename VectorT::ValueT;
+
+    UninitializedVector(size_t count, SkArenaAlloc& alloc) {
+        auto* size_ptr = reinterpret_cast<size_t*>(
+                alloc.makeBytesAlignedTo(sizeof(size_t) + count * sizeof(T), kRecAlign));
+        *size_ptr = count;
+
+        this->init_tagged_pointer(VectorT::kType == Type::kArray ? Tag::kArray : Tag::kObject,
+                                  size_ptr);
+    }
+
+    T* data() const {
+        return const_cast<T*>(this->template as<VectorT>().begin());
+    }
+};
+
+class BinaryDOMReader {
+public:
+    BinaryDOMReader(const char* data, size_t size, SkArenaAlloc& alloc)
+        : fAlloc(alloc)
+        , fCurrent(data)
+        , fStop(data + size) {}
+
+    Value read() {
+        SkASSERT(IsBinary(fCurrent, SkToSizeT(fStop - fCurrent)));
+        fCurrent += sizeof(kBinaryMagic);
+
+        uint32_t version;
+        if (!this->readRaw(&version) || version != kBinaryVersion) {
+            return NullValue();
+        }
+
+        Value root;
+        if (!this->readValue(&root, 0) || fCurrent != fStop ||
+            (!root.is<ObjectValue>() && !root.is<ArrayValue>())) {
+            return NullValue();
+        }
+
+        return root;
+    }
+
+private:
+    SkArenaAlloc& fAlloc;
+    const char*   fCurrent;
+    const char*   fStop;
+
+    size_t remaining() const { return SkToSizeT(fStop - fCurrent); }
+
+    template <typename T>
+    bool readRaw(T* v) {
+        if (this->remaining() < sizeof(T)) {
+            return false;
+        }
+        memcpy(v, fCurrent, sizeof(T));
+        fCurrent += sizeof(T);
+        return true;
+    }
+
+    bool readVarint(uint32_t* v) {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 7) {
+            uint8_t byte;
+            if (!this->readRaw(&byte)) {
+                return false;
+            }
+            result |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                *v = result;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Counts are validated against the remaining input (assuming the smallest possible
+    // element encoding), to avoid large bogus allocations.
+    bool readCount(uint32_t* count, size_t min_element_size) {
+        return this->readVarint(count) && *count <= this->remaining() / min_element_size;
+    }
+
+    bool readString(Value* str) {
+        uint32_t len;
+        if (!this->readCount(&len, 1)) {
+            return false;
+        }
+        *str = StringValue(fCurrent, len, fAlloc);
+        fCurrent += len;
+        return true;
+    }
+
+    bool readValue(Value* v, int depth) {
+        uint8_t tag;
+        if (!this->readRaw(&tag) || depth > kBinaryMaxDepth) {
+            return false;
+        }
+
+        switch (static_cast<BinaryTag>(tag)) {
+        case BinaryTag::kNull:
+            *v = NullValue();
+            return true;
+        case BinaryTag::kFalse:
+            *v = BoolValue(false);
+            return true;
+        case BinaryTag::kTrue:
+            *v = BoolValue(true);
+            return true;
+        case BinaryTag::kInt: {
+            uint32_t zz;
+            if (!this->readVarint(&zz)) {
+                return false;
+            }
+            *v = NumberValue(static_cast<int32_t>((zz >> 1) ^ (0u - (zz & 1))));
+            return true;
+        }
+        case BinaryTag::kFloat: {
+            float f;
+            if (!this->readRaw(&f)) {
+                return false;
+            }
+            *v = NumberValue(f);
+            return true;
+        }
+        case BinaryTag::kString: {
+            return this->readString(v);
+        }
+        case BinaryTag::kArray: {
+            uint32_t count;
+            if (!this->readCount(&count, sizeof(uint8_t))) {
+                return false;
+            }
+            const UninitializedVector<ArrayValue> array(count, fAlloc);
+            auto* values = array.data();
+            for (uint32_t i = 0; i < count; ++i) {
+                if (!this->readValue(values + i, depth + 1)) {
+                    return false;
+                }
+            }
+            *v = array;
+            return true;
+        }
+        case BinaryTag::kObject: {
+            uint32_t count;
+            if (!this->readCount(&count, 2 * sizeof(uint8_t))) {
+                return false;
+            }
+            const UninitializedVector<ObjectValue> object(count, fAlloc);
+            auto* members = object.data();
+            for (uint32_t i = 0; i < count; ++i) {
+                if (!this->readString(&members[i].fKey) ||
+                    !this->readValue(&members[i].fValue, depth + 1)) {
+                    return false;
+                }
+            }
+            *v = object;
+            return true;
+        }
+        }
+
+        return false;
+    }
+};
+
 } // namespace
 
 SkString Value::toString() const {
@@ -913,6 +1181,13 @@ static constexpr size_t kMinChunkSize = 4096;
 
 DOM::DOM(const char* data, size_t size)
     : fAlloc(kMinChunkSize) {
+    if (IsBinary(data, size)) {
+        BinaryDOMReader reader(data, size, fAlloc);
+
+        fRoot = reader.read();
+        return;
+    }
+
     DOMParser parser(fAlloc);
 
     fRoot = parser.parse(data, size);
@@ -922,4 +1197,10 @@ void DOM::write(SkWStream* stream) const {
     Write(fRoot, stream);
 }
 
+void DOM::writeBinary(SkWStream* stream) const {
+    stream->write(kBinaryMagic, sizeof(kBinaryMagic));
+    stream->write32(kBinaryVersion);
+    WriteBinary(fRoot, stream);
+}
+
 } // namespace skjson
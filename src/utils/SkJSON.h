@@ -339,12 +339,22 @@ public:
 
 class DOM final : public SkNoncopyable {
 public:
+    /**
+     * Builds a DOM from either JSON text or the binary encoding produced by writeBinary()
+     * (detected automatically).
+     */
     DOM(const char*, size_t);
 
     const Value& root() const { return fRoot; }
 
     void write(SkWStream*) const;
 
+    /**
+     * Writes a compact binary encoding of the DOM.  Loading the binary form skips all
+     * tokenizing and number parsing, and allocates the final records directly.
+     */
+    void writeBinary(SkWStream*) const;
+
 private:
     SkArenaAlloc fAlloc;
     Value        fRoot;
@@ -422,6 +422,58 @@ static void test_crbug_422693(skiatest::Reporter* reporter) {
     rc.op(path, SkMatrix::I(), SkClipOp::kIntersect, true);
 }
 
+// Intersecting with a path in a single pass must match building a clip for the path, and then
+// intersecting with that.
+static void test_path_op(skiatest::Reporter* reporter) {
+    SkPath ring;
+    ring.addCircle(50, 50, 45);
+    ring.addCircle(50, 50, 20);
+    ring.setFillType(SkPathFillType::kEvenOdd);
+    SkAAClip clips[2];
+    clips[0].setPath(ring, SkIRect::MakeWH(100, 100), true);
+    clips[1].setPath(SkPath::RRect(SkRRect::MakeRectXY({10.5f, 0, 90.5f, 70}, 20, 20)),
+                     SkIRect::MakeWH(100, 100), true);
+    clips[1].op(SkIRect::MakeLTRB(30, 30, 60, 50), SkClipOp::kDifference);
+
+    SkRandom rand;
+    for (int i = 0; i < 200; ++i) {
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(-10, 90), rand.nextRangeScalar(-10, 90),
+                                    rand.nextRangeScalar(0.25f, 60), rand.nextRangeScalar(0, 60));
+        SkPath path;
+        switch (i % 5) {
+            case 0: path.addRect(r); break;
+            case 1: path.addRect(SkRect::Make(r.round())); break;
+            case 2: path.addRRect(SkRRect::MakeRectXY(r, 8, 8)); break;
+            case 3: path.addOval(r); break;
+            case 4:
+                path.addRect(SkRect::MakeXYWH(r.fLeft, r.fTop, 0.75f, r.height()));
+                path.addCircle(r.centerX(), r.centerY(), r.width() / 3);
+                break;
+        }
+        if (i % 7 == 0) {
+            path.toggleInverseFillType();
+        }
+        bool doAA = i % 3 != 0;
+        for (const SkAAClip& clip : clips) {
+            SkAAClip pathClip;
+            pathClip.setPath(path, clip.getBounds(), doAA);
+            SkAAClip expected = clip;
+            expected.op(pathClip, SkClipOp::kIntersect);
+
+            SkAAClip actual = clip;
+            REPORTER_ASSERT(reporter, actual.op(path, SkClipOp::kIntersect, doAA) ==
+                                      !expected.isEmpty());
+
+            SkMask expectedMask, actualMask;
+            expected.copyToMask(&expectedMask);
+            actual.copyToMask(&actualMask);
+            SkAutoMaskFreeImage freeExpected(expectedMask.fImage),
+                                freeActual(actualMask.fImage);
+            REPORTER_ASSERT(reporter, expectedMask == actualMask);
+        }
+    }
+}
+
 static void test_huge(skiatest::Reporter* reporter) {
     SkAAClip clip;
     int big = 0x70000000;
@@ -441,5 +493,6 @@ DEF_TEST(AAClip, reporter) {
     test_nearly_integral(reporter);
     test_really_a_rect(reporter);
     test_crbug_422693(reporter);
+    test_path_op(reporter);
     test_huge(reporter);
 }
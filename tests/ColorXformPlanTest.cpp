@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkColorXformPlan.h"
+#include "tests/Test.h"
+#include "tools/Resources.h"
+
+#include <vector>
+
+DEF_TEST(ColorXformPlan, r) {
+    // A profile with A2B LUTs, transforming to one with parametric curves.
+    sk_sp<SkData> data = GetResourceAsData("icc_profiles/srgb_lab_pcs.icc");
+    skcms_ICCProfile src;
+    if (!data || !skcms_Parse(data->data(), data->size(), &src)) {
+        return;
+    }
+    skcms_ICCProfile dst;
+    SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDisplayP3)->toProfile(&dst);
+
+    // Big enough to be split into bands, which don't divide the rows evenly.
+    constexpr int kWidth = 509, kHeight = 517;
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (int padding : {0, 3}) {
+        const size_t srcRowBytes = (kWidth + padding) * 4,
+                     dstRowBytes = (kWidth + padding) * 8;
+        std::vector<uint32_t> pixels((kWidth + padding) * kHeight);
+        SkRandom random;
+        for (uint32_t& p : pixels) {
+            p = random.nextU();
+        }
+
+        const SkColorXformPlan plan(skcms_PixelFormat_RGBA_8888, skcms_AlphaFormat_Unpremul, &src,
+                                    skcms_PixelFormat_RGBA_hhhh, skcms_AlphaFormat_PremulAsEncoded,
+                                    &dst);
+
+        // Transforming a row at a time, for reference.
+        std::vector<uint64_t> want((kWidth + padding) * kHeight),
+                              got ((kWidth + padding) * kHeight);
+        for (int y = 0; y < kHeight; y++) {
+            REPORTER_ASSERT(r, plan.apply(&want[y * (kWidth + padding)],
+                                          &pixels[y * (kWidth + padding)], kWidth));
+        }
+
+        REPORTER_ASSERT(r, plan.apply(got.data(), dstRowBytes, pixels.data(), srcRowBytes,
+                                      kWidth, kHeight, executor.get()));
+        REPORTER_ASSERT(r, got == want, "padding %d", padding);
+
+        // In place, between formats of the same size.
+        const SkColorXformPlan inPlace(skcms_PixelFormat_RGBA_8888, skcms_AlphaFormat_Unpremul,
+                                       &src,
+                                       skcms_PixelFormat_BGRA_8888, skcms_AlphaFormat_Unpremul,
+                                       &dst);
+        std::vector<uint32_t> want8888 = pixels;
+        for (int y = 0; y < kHeight; y++) {
+            uint32_t* row = &want8888[y * (kWidth + padding)];
+            REPORTER_ASSERT(r, inPlace.apply(row, row, kWidth));
+        }
+
+        REPORTER_ASSERT(r, inPlace.apply(pixels.data(), srcRowBytes, pixels.data(), srcRowBytes,
+                                         kWidth, kHeight, executor.get()));
+        REPORTER_ASSERT(r, pixels == want8888, "padding %d", padding);
+    }
+}
+
+DEF_TEST(ColorXformPlan_JpegExecutor, r) {
+    // A CMYK JPEG with an ICC profile, decoded to a different color space.
+    sk_sp<SkData> data = GetResourceAsData("images/CMYK.jpg");
+    if (!data) {
+        return;
+    }
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+    if (!codec) {
+        ERRORF(r, "Failed to create a codec");
+        return;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                             .makeColorSpace(SkColorSpace::MakeRGB(
+                                                     SkNamedTransferFn::kSRGB,
+                                                     SkNamedGamut::kDisplayP3));
+
+    // Decoding a scanline at a time transforms each row by itself, for reference.
+    SkBitmap want;
+    want.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startScanlineDecode(info));
+    for (int y = 0; y < info.height(); y++) {
+        REPORTER_ASSERT(r, 1 == codec->getScanlines(want.getAddr(0, y), 1, want.rowBytes()));
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkExecutor* e : {(SkExecutor*)nullptr, executor.get()}) {
+        SkCodec::Options options;
+        options.fExecutor = e;
+        SkBitmap got;
+        got.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, got.getPixels(),
+                                                                 got.rowBytes(), &options));
+        REPORTER_ASSERT(r, 0 == memcmp(got.getPixels(), want.getPixels(), want.computeByteSize()),
+                        "executor %p", e);
+    }
+}
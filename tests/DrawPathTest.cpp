@@ -8,6 +8,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
@@ -22,6 +23,13 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkDashPathEffect.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBitmapDevice.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkRasterClip.h"
+#include "src/core/SkScan.h"
 #include "tests/Test.h"
 
 // test that we can draw an aa-rect at coordinates > 32K (bigger than fixedpoint)
@@ -420,3 +428,224 @@ DEF_TEST(DrawPath, reporter) {
     test_big_aa_rect(reporter);
     test_halfway();
 }
+
+// Fills the path with a specific scan converter. (Tests run concurrently, so they can't pick one
+// by changing the global AA flags.)
+static void fill_path(const SkBitmap& bitmap, const SkPath& path, const SkPaint& paint,
+                      const SkRasterClip& clip, SkScan::AAConverter converter) {
+    SkSTArenaAlloc<2048> alloc;
+    SkMatrixProvider matrixProvider(SkMatrix::I());
+    SkBlitter* blitter = SkBlitter::Choose(bitmap.pixmap(), matrixProvider, paint, &alloc,
+                                           /*drawCoverage=*/false, /*clipShader=*/nullptr);
+    SkScan::AntiFillPath(path, clip, blitter, converter);
+}
+
+static SkBitmap draw_alpha(const SkPath& path, bool deltaAA) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeA8(200, 200));
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    fill_path(bitmap, path, paint, SkRasterClip(SkIRect::MakeWH(200, 200)),
+              deltaAA ? SkScan::AAConverter::kDelta : SkScan::AAConverter::kAnalytic);
+    return bitmap;
+}
+
+// Draws the path without anti-aliasing at 8x8 the resolution, and averages the samples.
+static SkBitmap draw_supersampled_alpha(const SkPath& path) {
+    constexpr int kScale = 8;
+    SkBitmap large;
+    large.allocPixels(SkImageInfo::MakeA8(200 * kScale, 200 * kScale));
+    large.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(large);
+    canvas.scale(kScale, kScale);
+    canvas.drawPath(path, SkPaint());
+
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeA8(200, 200));
+    for (int y = 0; y < 200; ++y) {
+        for (int x = 0; x < 200; ++x) {
+            int sum = 0;
+            for (int j = 0; j < kScale; ++j) {
+                for (int i = 0; i < kScale; ++i) {
+                    sum += *large.getAddr8(x * kScale + i, y * kScale + j);
+                }
+            }
+            *bitmap.getAddr8(x, y) = (sum + kScale * kScale / 2) / (kScale * kScale);
+        }
+    }
+    return bitmap;
+}
+
+static int alpha_error(const SkBitmap& bitmap, const SkBitmap& expected, int* maxError) {
+    int sum = 0;
+    *maxError = 0;
+    for (int y = 0; y < expected.height(); ++y) {
+        for (int x = 0; x < expected.width(); ++x) {
+            int error = std::abs(*expected.getAddr8(x, y) - *bitmap.getAddr8(x, y));
+            *maxError = std::max(*maxError, error);
+            sum += error;
+        }
+    }
+    return sum;
+}
+
+// Delta-based AA must be at least as close as analytic AA to supersampled coverage. It doesn't
+// compute exact coverage where edges cross within a pixel, but must never be far off.
+static void check_delta_aa(skiatest::Reporter* reporter, const SkPath& path) {
+    SkBitmap expected = draw_supersampled_alpha(path);
+    int aaaMax, daaMax;
+    int aaaError = alpha_error(draw_alpha(path, false), expected, &aaaMax),
+        daaError = alpha_error(draw_alpha(path, true), expected, &daaMax);
+    REPORTER_ASSERT(reporter, daaError <= aaaError, "error %d vs %d", daaError, aaaError);
+    REPORTER_ASSERT(reporter, daaMax <= 128, "max error %d", daaMax);
+}
+DEF_TEST(DrawPath_DeltaAA, reporter) {
+    // A star with overlapping points, with both fill types.
+    SkPath star;
+    for (int i = 0; i < 7; ++i) {
+        float angle = i * 3 * SK_ScalarPI * 2 / 7;
+        SkPoint pt = {100 + 90 * std::sin(angle), 100 - 90 * std::cos(angle)};
+        i ? star.lineTo(pt) : star.moveTo(pt);
+    }
+    check_delta_aa(reporter, star);
+    star.setFillType(SkPathFillType::kEvenOdd);
+    check_delta_aa(reporter, star);
+
+    // Curves, including contours with opposite directions, and subpixel features.
+    SkPath curves;
+    curves.addCircle(100, 100, 80.5f);
+    curves.addOval({60.25f, 40.75f, 140.5f, 160.25f}, SkPathDirection::kCCW);
+    curves.addRRect(SkRRect::MakeRectXY({20.3f, 20.6f, 180.1f, 30.4f}, 3, 3));
+    curves.moveTo(10, 190);
+    curves.cubicTo(60, 120, 140, 260, 190, 170);
+    curves.conicTo(100, 150, 10, 190, 0.5f);
+    check_delta_aa(reporter, curves);
+
+    // Many small random triangles, which share scanlines.
+    SkRandom random;
+    SkPath triangles;
+    for (int i = 0; i < 200; ++i) {
+        SkPoint pt = {random.nextRangeScalar(0, 190), random.nextRangeScalar(0, 190)};
+        triangles.moveTo(pt);
+        triangles.lineTo(pt + SkVector{random.nextRangeScalar(-10, 10), 10});
+        triangles.lineTo(pt + SkVector{10, random.nextRangeScalar(-10, 10)});
+    }
+    check_delta_aa(reporter, triangles);
+
+    // Paths which extend past the edges of the canvas.
+    SkPath offscreen;
+    offscreen.moveTo(-50, 20);
+    offscreen.lineTo(250, 60.5f);
+    offscreen.lineTo(120, 260);
+    offscreen.lineTo(-30, 150);
+    offscreen.moveTo(190.5f, -40);
+    offscreen.lineTo(230, 100);
+    offscreen.lineTo(150, 80);
+    check_delta_aa(reporter, offscreen);
+
+    // Slivers with edges ending exactly on the left edge of the canvas, or crossing it. (They
+    // don't overlap.) Interpolating along those edges can round a hair below zero.
+    for (float left : {0.0f, -5.0f}) {
+        SkPath leftEdge;
+        for (int i = 0; i < 49; ++i) {
+            float y = i * 4 + random.nextRangeScalar(0, 0.5f);
+            leftEdge.moveTo(random.nextRangeScalar(10, 100), y);
+            leftEdge.lineTo(left * random.nextF(), y + random.nextRangeScalar(1, 3));
+            leftEdge.lineTo(random.nextRangeScalar(10, 100), y + 3.5f);
+        }
+        check_delta_aa(reporter, leftEdge);
+    }
+}
+
+// Draws the path into a 1024x1024 bitmap, clipped to clipPath (if any). With an executor, the
+// path is split into bands on it; without one it's drawn with delta-based AA on this thread.
+// Returns false if banding was asked for but the path wasn't split up.
+static bool draw_banded(const SkPath& path, const SkPaint& paint, SkExecutor* executor,
+                        const SkPath* clipPath, SkBitmap* bitmap) {
+    bitmap->allocN32Pixels(1024, 1024);
+    bitmap->eraseColor(SK_ColorWHITE);
+    SkRasterClip clip(SkIRect::MakeWH(1024, 1024));
+    if (clipPath) {
+        clip.op(*clipPath, SkMatrix::I(), SkClipOp::kIntersect, /*doAA=*/false);
+    }
+
+    if (!executor) {
+        fill_path(*bitmap, path, paint, clip, SkScan::AAConverter::kDelta);
+        return true;
+    }
+    SkMatrixProvider matrixProvider(SkMatrix::I());
+    return SkScan::AntiFillPathBands(path, clip, executor, [&](SkArenaAlloc* alloc) {
+        return SkBlitter::Choose(bitmap->pixmap(), matrixProvider, paint, alloc,
+                                 /*drawCoverage=*/false, /*clipShader=*/nullptr);
+    });
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(uint32_t))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Banded scan conversion produces the same pixels as scan converting the whole path at once.
+DEF_TEST(DrawPath_Bands, reporter) {
+    SkRandom random;
+    SkPath triangles;
+    for (int i = 0; i < 2000; ++i) {
+        SkPoint pt = {random.nextRangeScalar(-20, 1000), random.nextRangeScalar(-20, 1000)};
+        triangles.moveTo(pt);
+        triangles.lineTo(pt + SkVector{random.nextRangeScalar(-40, 40), 40});
+        triangles.lineTo(pt + SkVector{40, random.nextRangeScalar(-40, 40)});
+    }
+    triangles.addCircle(512, 512, 400.5f);
+    SkPath evenOdd = triangles;
+    evenOdd.setFillType(SkPathFillType::kEvenOdd);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(0xC0204080);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkPath rectClip = SkPath::Rect({100, 37, 900, 1000}),
+                 circleClip = SkPath::Circle(500, 500, 300);
+    for (const SkPath& path : {triangles, evenOdd}) {
+        for (const SkPath* clip : {(const SkPath*)nullptr, &rectClip, &circleClip}) {
+            SkBitmap banded, whole;
+            REPORTER_ASSERT(reporter, draw_banded(path, paint, executor.get(), clip, &banded));
+            draw_banded(path, paint, nullptr, clip, &whole);
+            REPORTER_ASSERT(reporter, equal_pixels(banded, whole));
+        }
+    }
+
+    // Devices with a path executor draw in bands. With an anti-aliased clip, nothing is drawn
+    // outside of the clip.
+    SkBitmap banded;
+    banded.allocN32Pixels(1024, 1024);
+    banded.eraseColor(SK_ColorWHITE);
+    auto device = sk_make_sp<SkBitmapDevice>(banded);
+    device->setPathExecutor(executor.get());
+    SkCanvas canvas(device);
+    canvas.clipPath(SkPath::Circle(500, 500, 300.5f), true);
+    canvas.drawPath(triangles, paint);
+    int outside = 0;
+    for (int y = 0; y < banded.height(); ++y) {
+        for (int x = 0; x < banded.width(); ++x) {
+            if (SkPoint::Length(x + 0.5f - 500, y + 0.5f - 500) > 302 &&
+                banded.getColor(x, y) != SK_ColorWHITE) {
+                ++outside;
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, outside == 0);
+
+    // Inverse fills and small paths are left to the usual scan converters.
+    SkRasterClip clip(SkIRect::MakeWH(1024, 1024));
+    auto noBlitter = [](SkArenaAlloc*) -> SkBlitter* { return nullptr; };
+    SkPath inverse = triangles;
+    inverse.toggleInverseFillType();
+    REPORTER_ASSERT(reporter, !SkScan::AntiFillPathBands(inverse, clip, executor.get(), noBlitter));
+    REPORTER_ASSERT(reporter, !SkScan::AntiFillPathBands(SkPath::Circle(50, 50, 40), clip,
+                                                         executor.get(), noBlitter));
+}
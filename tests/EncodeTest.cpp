@@ -12,6 +12,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
@@ -332,6 +333,155 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+static bool decode_n32(sk_sp<SkData> data, SkBitmap* dst) {
+    sk_sp<SkImage> image = SkImage::MakeFromEncoded(std::move(data));
+    return image && dst->tryAllocPixels(SkImageInfo::MakeN32Premul(image->dimensions())) &&
+           image->readPixels(dst->pixmap(), 0, 0);
+}
+
+// Banded encodes must decode to the same pixels as serial ones.
+static void check_png_bands(skiatest::Reporter* r, const SkPixmap& src,
+                            const SkPngEncoder::Options& options) {
+    SkDynamicMemoryWStream serial, banded;
+    SkPngEncoder::Options serialOptions = options;
+    serialOptions.fExecutor = nullptr;
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, src, serialOptions));
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&banded, src, options));
+
+    SkBitmap expected, actual;
+    REPORTER_ASSERT(r, decode_n32(serial.detachAsData(), &expected));
+    REPORTER_ASSERT(r, decode_n32(banded.detachAsData(), &actual));
+    REPORTER_ASSERT(r, almost_equals(expected, actual, 0));
+}
+
+DEF_TEST(Encode_PngBands, r) {
+    SkBitmap bitmap;
+    if (!GetResourceAsBitmap("images/mandrill_512.png", &bitmap)) {
+        return;
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkPngEncoder::Options options;
+    options.fExecutor = executor.get();
+
+    const SkColorType colorTypes[] = {
+        kN32_SkColorType, kRGBA_8888_SkColorType, kGray_8_SkColorType, kAlpha_8_SkColorType,
+        kRGBA_F16_SkColorType,
+    };
+    for (SkColorType colorType : colorTypes) {
+        for (SkAlphaType alphaType : {kOpaque_SkAlphaType, kPremul_SkAlphaType}) {
+            SkImageInfo info = bitmap.info().makeColorType(colorType).makeAlphaType(alphaType);
+            if (colorType == kGray_8_SkColorType) {
+                info = info.makeAlphaType(kOpaque_SkAlphaType);
+            } else if (colorType == kAlpha_8_SkColorType) {
+                info = info.makeAlphaType(kPremul_SkAlphaType);
+            }
+            SkBitmap src;
+            src.allocPixels(info);
+            bitmap.readPixels(src.pixmap());
+
+            options.fFilterSelection = alphaType == kOpaque_SkAlphaType
+                                               ? SkPngEncoder::FilterSelection::kPerRow
+                                               : SkPngEncoder::FilterSelection::kPerBand;
+            check_png_bands(r, src.pixmap(), options);
+        }
+    }
+
+    // Enough bands to be encoded in several groups, the last of which is partial.
+    {
+        SkBitmap large;
+        large.allocN32Pixels(1024, 1700);
+        SkCanvas canvas(large);
+        canvas.drawImageRect(bitmap.asImage(), SkRect::Make(large.dimensions()),
+                             SkSamplingOptions());
+        check_png_bands(r, large.pixmap(), options);
+    }
+
+    options.fFilterSelection = SkPngEncoder::FilterSelection::kPerRow;
+    for (auto filters : {SkPngEncoder::FilterFlag::kSub, SkPngEncoder::FilterFlag::kNone,
+                         SkPngEncoder::FilterFlag::kUp | SkPngEncoder::FilterFlag::kAvg |
+                         SkPngEncoder::FilterFlag::kPaeth}) {
+        for (int level : {0, 1, 9}) {
+            options.fFilterFlags = filters;
+            options.fZLibLevel = level;
+            check_png_bands(r, bitmap.pixmap(), options);
+        }
+    }
+
+    // The bands compress about as well as a serial encode.
+    SkDynamicMemoryWStream serial, banded;
+    options = SkPngEncoder::Options();
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, bitmap.pixmap(), options));
+    options.fExecutor = executor.get();
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&banded, bitmap.pixmap(), options));
+    REPORTER_ASSERT(r, banded.bytesWritten() < serial.bytesWritten() * 1.02);
+
+    // Each band is written as its own IDAT chunk.
+    sk_sp<SkData> data = banded.detachAsData();
+    const char* bytes = (const char*)data->data();
+    const char kIDAT[] = "IDAT";
+    int chunks = 0;
+    for (const char* end = bytes + data->size();
+         (bytes = std::search(bytes, end, kIDAT, kIDAT + 4)) != end; bytes += 4) {
+        chunks++;
+    }
+    REPORTER_ASSERT(r, chunks > 1);
+
+    testPngComments(bitmap.pixmap(), options, r);
+}
+
+DEF_TEST(Encode_JpegStrips, r) {
+    sk_sp<SkImage> mandrill = GetResourceAsImage("images/mandrill_512.png");
+    if (!mandrill) {
+        return;
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Large enough to be split into several strips, with partial MCUs on the right and bottom.
+    for (SkISize size : {SkISize{2048, 1100}, SkISize{1999, 1201}}) {
+        for (SkColorType colorType : {kN32_SkColorType, kGray_8_SkColorType}) {
+            SkBitmap src;
+            src.allocPixels(SkImageInfo::Make(size, colorType, kOpaque_SkAlphaType));
+            SkCanvas canvas(src);
+            canvas.drawImageRect(mandrill, SkRect::Make(size), SkSamplingOptions());
+
+            for (auto downsample : {SkJpegEncoder::Downsample::k420,
+                                    SkJpegEncoder::Downsample::k422,
+                                    SkJpegEncoder::Downsample::k444}) {
+                SkJpegEncoder::Options options;
+                options.fDownsample = downsample;
+                SkDynamicMemoryWStream serial, strips;
+                REPORTER_ASSERT(r, SkJpegEncoder::Encode(&serial, src.pixmap(), options));
+                options.fExecutor = executor.get();
+                REPORTER_ASSERT(r, SkJpegEncoder::Encode(&strips, src.pixmap(), options));
+
+                // The strips only differ from a serial encode in their Huffman tables.
+                SkBitmap expected, actual;
+                REPORTER_ASSERT(r, decode_n32(serial.detachAsData(), &expected));
+                REPORTER_ASSERT(r, decode_n32(strips.detachAsData(), &actual));
+                REPORTER_ASSERT(r, almost_equals(expected, actual, 0));
+            }
+        }
+    }
+
+    // Small images are encoded serially.
+    SkBitmap bitmap;
+    mandrill->asLegacyBitmap(&bitmap);
+    SkJpegEncoder::Options options;
+    SkDynamicMemoryWStream serial, strips;
+    REPORTER_ASSERT(r, SkJpegEncoder::Encode(&serial, bitmap.pixmap(), options));
+    options.fExecutor = executor.get();
+    REPORTER_ASSERT(r, SkJpegEncoder::Encode(&strips, bitmap.pixmap(), options));
+    sk_sp<SkData> serialData = serial.detachAsData();
+    REPORTER_ASSERT(r, serialData->equals(strips.detachAsData().get()));
+
+    // Images taller than a jpeg allows fail to encode, rather than writing a truncated height.
+    SkBitmap tall;
+    tall.allocPixels(SkImageInfo::Make(64, 65600, kGray_8_SkColorType, kOpaque_SkAlphaType));
+    tall.eraseColor(SK_ColorGRAY);
+    SkNullWStream null;
+    REPORTER_ASSERT(r, !SkJpegEncoder::Encode(&null, tall.pixmap(), options));
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
@@ -433,6 +583,36 @@ DEF_TEST(Encode_WebpOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm2, bm3, 50));
 }
 
+DEF_TEST(Encode_WebpExecutor, r) {
+    SkBitmap bitmap;
+    if (!GetResourceAsBitmap("images/mandrill_512.png", &bitmap)) {
+        return;
+    }
+    // Premul pixels are converted before they are compressed.
+    SkBitmap src;
+    src.allocPixels(bitmap.info().makeColorType(kBGRA_8888_SkColorType)
+                                 .makeAlphaType(kPremul_SkAlphaType));
+    src.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(src);
+    canvas.drawCircle(256, 256, 200, SkPaint());
+    SkPaint paint;
+    paint.setAlphaf(0.5f);
+    canvas.drawImage(bitmap.asImage(), 0, 0, SkSamplingOptions(), &paint);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkWebpEncoder::Options options;
+    options.fCompression = SkWebpEncoder::Compression::kLossless;
+    SkDynamicMemoryWStream serial, parallel;
+    REPORTER_ASSERT(r, SkWebpEncoder::Encode(&serial, src.pixmap(), options));
+    options.fExecutor = executor.get();
+    REPORTER_ASSERT(r, SkWebpEncoder::Encode(&parallel, src.pixmap(), options));
+
+    SkBitmap expected, actual;
+    REPORTER_ASSERT(r, decode_n32(serial.detachAsData(), &expected));
+    REPORTER_ASSERT(r, decode_n32(parallel.detachAsData(), &actual));
+    REPORTER_ASSERT(r, almost_equals(expected, actual, 0));
+}
+
 DEF_TEST(Encode_Alpha, r) {
     // These formats have no sensible way to encode alpha images.
     for (auto format : { SkEncodedImageFormat::kJPEG,
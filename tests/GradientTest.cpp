@@ -11,6 +11,7 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkGradientShader.h"
+#include "include/private/SkTPin.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkMatrixProvider.h"
 #include "src/core/SkTLazy.h"
@@ -570,6 +571,71 @@ static void test_sweep_fuzzer(skiatest::Reporter*) {
     }
 }
 
+// Gradients with many stops look up t's stop in a table of buckets, rather than comparing it to
+// every stop. Check that against colors computed directly, including hard stops and clamped t, in
+// both a highp pipeline (an F16 destination) and a lowp one (an N32 destination).
+static void test_many_stops(skiatest::Reporter* reporter) {
+    constexpr int kIntervals = 20;
+    constexpr int kWidth     = 480;
+    constexpr float kStart   = 40, kEnd = 440;
+
+    // A hard stop starts each interval.
+    SkColor4f colors[2 * kIntervals];
+    SkScalar  pos[2 * kIntervals];
+    for (int i = 0; i < kIntervals; ++i) {
+        colors[2*i + 0] = {(i % 3) / 2.0f, (i % 5) / 4.0f, (i % 7) / 6.0f, 1};
+        colors[2*i + 1] = {(i % 4) / 3.0f, (i % 2) / 1.0f, (i % 6) / 5.0f, 1};
+        pos[2*i + 0] = (float)i / kIntervals;
+        pos[2*i + 1] = (float)(i + 1) / kIntervals;
+    }
+    const SkPoint pts[] = {{kStart, 0}, {kEnd, 0}};
+
+    // The radial gradient is centered on the row at kStart, so t grows away from it both ways.
+    struct {
+        SkColorType     fColorType;
+        sk_sp<SkShader> fShader;
+        bool            fRadial;
+    } draws[] = {
+        {kRGBA_F16_SkColorType,
+         SkGradientShader::MakeLinear(pts, colors, nullptr, pos, 2 * kIntervals,
+                                      SkTileMode::kClamp),
+         false},
+        {kN32_SkColorType,
+         SkGradientShader::MakeRadial({kStart, 0.5f}, kEnd - kStart, colors, nullptr, pos,
+                                      2 * kIntervals, SkTileMode::kClamp),
+         true},
+    };
+    for (const auto& draw : draws) {
+        auto surface = SkSurface::MakeRaster(SkImageInfo::Make(kWidth, 1, draw.fColorType,
+                                                               kPremul_SkAlphaType));
+        SkPaint paint;
+        paint.setShader(draw.fShader);
+        surface->getCanvas()->drawPaint(paint);
+
+        SkColor4f pixels[kWidth];
+        SkImageInfo info = SkImageInfo::Make(kWidth, 1, kRGBA_F32_SkColorType,
+                                             kPremul_SkAlphaType);
+        REPORTER_ASSERT(reporter, surface->readPixels(info, pixels, sizeof(pixels), 0, 0));
+
+        for (int x = 0; x < kWidth; ++x) {
+            float d = (x + 0.5f - kStart) / (kEnd - kStart);
+            float t = SkTPin(draw.fRadial ? std::abs(d) : d, 0.0f, 1.0f);
+            int i = std::min((int)(t * kIntervals), kIntervals - 1);
+            float frac = t * kIntervals - i;
+            const SkColor4f &c0 = colors[2*i], &c1 = colors[2*i + 1];
+            SkColor4f expected = {c0.fR + (c1.fR - c0.fR) * frac,
+                                  c0.fG + (c1.fG - c0.fG) * frac,
+                                  c0.fB + (c1.fB - c0.fB) * frac,
+                                  1};
+            for (int c = 0; c < 4; ++c) {
+                REPORTER_ASSERT(reporter, std::abs(pixels[x][c] - expected[c]) < 0.01f,
+                                "color type %d, x=%d channel %d: %g vs %g", draw.fColorType, x,
+                                c, pixels[x][c], expected[c]);
+            }
+        }
+    }
+}
+
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestGradientOptimization(reporter);
@@ -584,4 +650,5 @@ DEF_TEST(Gradient, reporter) {
     test_linear_fuzzer(reporter);
     test_sweep_fuzzer(reporter);
     test_unsorted_degenerate(reporter);
+    test_many_stops(reporter);
 }
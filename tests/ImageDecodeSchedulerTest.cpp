@@ -0,0 +1,184 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkShader.h"
+#include "include/utils/SkImageDecodeScheduler.h"
+#include "tests/Test.h"
+#include "tools/Resources.h"
+
+#include <functional>
+#include <vector>
+
+namespace {
+// Holds on to its work until the test runs it.
+class ManualExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override { fWork.push_back(std::move(work)); }
+
+    void runNext() {
+        std::function<void(void)> work = std::move(fWork.front());
+        fWork.erase(fWork.begin());
+        work();
+    }
+
+    int count() const { return (int)fWork.size(); }
+
+private:
+    std::vector<std::function<void(void)>> fWork;
+};
+}  // namespace
+
+// Each call makes a new image, with its own cache entries.
+static sk_sp<SkImage> make_lazy_image(const char* resource = "images/mandrill_512_q075.jpg") {
+    return SkImage::MakeFromEncoded(GetResourceAsData(resource));
+}
+
+DEF_TEST(ImageDecodeScheduler_priority, reporter) {
+    sk_sp<SkImage> a = make_lazy_image(), b = make_lazy_image(), c = make_lazy_image();
+    if (!a || !b || !c) {
+        return;
+    }
+
+    ManualExecutor executor;
+    SkImageDecodeScheduler scheduler(&executor);
+    scheduler.enqueue(a, 0);
+    scheduler.enqueue(b, 2);
+    scheduler.enqueue(c, 2);
+    scheduler.enqueue(a, 3);    // moves a to the front
+    REPORTER_ASSERT(reporter, executor.count() == 3);
+    REPORTER_ASSERT(reporter, !SkImageDecodeScheduler::IsDecoded(a.get()));
+
+    // a, then b and c in the order they were enqueued.
+    executor.runNext();
+    REPORTER_ASSERT(reporter,  SkImageDecodeScheduler::IsDecoded(a.get()));
+    REPORTER_ASSERT(reporter, !SkImageDecodeScheduler::IsDecoded(b.get()));
+    REPORTER_ASSERT(reporter, !SkImageDecodeScheduler::IsDecoded(c.get()));
+    executor.runNext();
+    REPORTER_ASSERT(reporter,  SkImageDecodeScheduler::IsDecoded(b.get()));
+    REPORTER_ASSERT(reporter, !SkImageDecodeScheduler::IsDecoded(c.get()));
+    executor.runNext();
+    REPORTER_ASSERT(reporter,  SkImageDecodeScheduler::IsDecoded(c.get()));
+}
+
+DEF_TEST(ImageDecodeScheduler_cancel, reporter) {
+    sk_sp<SkImage> image = make_lazy_image();
+    if (!image) {
+        return;
+    }
+
+    ManualExecutor executor;
+    SkImageDecodeScheduler scheduler(&executor);
+    scheduler.enqueue(image, 0);
+    REPORTER_ASSERT(reporter,  scheduler.cancel(image.get()));
+    REPORTER_ASSERT(reporter, !scheduler.cancel(image.get()));
+    executor.runNext();
+    REPORTER_ASSERT(reporter, !SkImageDecodeScheduler::IsDecoded(image.get()));
+
+    // Images that aren't lazy have nothing to decode.
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    bitmap.eraseColor(SK_ColorRED);
+    sk_sp<SkImage> raster = bitmap.asImage();
+    scheduler.enqueue(raster, 0);
+    REPORTER_ASSERT(reporter, executor.count() == 0);
+    REPORTER_ASSERT(reporter, SkImageDecodeScheduler::IsDecoded(raster.get()));
+}
+
+static int max_channel_diff(const SkBitmap& a, const SkBitmap& b) {
+    int maxDiff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            SkColor ca = a.getColor(x, y), cb = b.getColor(x, y);
+            for (int shift : {0, 8, 16, 24}) {
+                maxDiff = std::max(maxDiff, std::abs((int)((ca >> shift) & 0xFF) -
+                                                     (int)((cb >> shift) & 0xFF)));
+            }
+        }
+    }
+    return maxDiff;
+}
+
+DEF_TEST(ImageDecodeScheduler_scaled, reporter) {
+    sk_sp<SkImage> image = make_lazy_image();
+    if (!image) {
+        return;
+    }
+
+    // The default executor decodes during enqueue(). JPEGs decode at a quarter size directly.
+    SkImageDecodeScheduler scheduler;
+    scheduler.enqueue(image, 0, 0.25f);
+    REPORTER_ASSERT(reporter,  SkImageDecodeScheduler::IsDecoded(image.get(), 0.25f));
+    REPORTER_ASSERT(reporter,  SkImageDecodeScheduler::IsDecoded(image.get(), 0.2f));
+    REPORTER_ASSERT(reporter, !SkImageDecodeScheduler::IsDecoded(image.get(), 0.5f));
+    REPORTER_ASSERT(reporter, !SkImageDecodeScheduler::IsDecoded(image.get(), 1));
+
+    auto draw = [](const sk_sp<SkImage>& img, bool useShader) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(128, 128);
+        SkCanvas canvas(bitmap);
+        SkSamplingOptions sampling(SkFilterMode::kLinear, SkMipmapMode::kLinear);
+        if (useShader) {
+            SkPaint paint;
+            paint.setShader(img->makeShader(sampling, SkMatrix::Scale(0.25f, 0.25f)));
+            canvas.drawPaint(paint);
+        } else {
+            canvas.drawImageRect(img, SkRect::MakeWH(128, 128), sampling);
+        }
+        return bitmap;
+    };
+
+    // A separate image draws from a full decode, for reference.
+    sk_sp<SkImage> reference = make_lazy_image();
+    for (bool useShader : {false, true}) {
+        SkBitmap expected = draw(reference, useShader),
+                 actual   = draw(image, useShader);
+        // Decoding at a reduced size differs only a little from mipmapping a full decode.
+        int diff = max_channel_diff(expected, actual);
+        REPORTER_ASSERT(reporter, diff <= 16, "diff %d", diff);
+        // Neither draw needed the full decode.
+        REPORTER_ASSERT(reporter, !SkImageDecodeScheduler::IsDecoded(image.get(), 1));
+    }
+
+    // Drawing at full size does.
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(512, 512);
+    SkCanvas canvas(bitmap);
+    canvas.drawImage(image, 0, 0);
+    REPORTER_ASSERT(reporter, SkImageDecodeScheduler::IsDecoded(image.get(), 1));
+}
+
+DEF_TEST(ImageDecodeScheduler_threaded, reporter) {
+    std::vector<sk_sp<SkImage>> images;
+    for (int i = 0; i < 8; ++i) {
+        images.push_back(make_lazy_image());
+        if (!images.back()) {
+            return;
+        }
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkImageDecodeScheduler scheduler(executor.get());
+    for (int i = 0; i < 8; ++i) {
+        scheduler.enqueue(images[i], i, i % 2 ? 1 : 0.5f);
+    }
+    // Drawing an image that is being decoded waits for that decode rather than starting another.
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(512, 512);
+    SkCanvas canvas(bitmap);
+    canvas.drawImage(images[1], 0, 0);
+
+    scheduler.waitForAll();
+    for (int i = 0; i < 8; ++i) {
+        REPORTER_ASSERT(reporter,
+                        SkImageDecodeScheduler::IsDecoded(images[i].get(), i % 2 ? 1 : 0.5f));
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -19,7 +20,10 @@
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/effects/SkTableColorFilter.h"
 #include "include/gpu/GrDirectContext.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkBitmapDevice.h"
 #include "src/core/SkColorFilterBase.h"
+#include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
@@ -2081,3 +2085,331 @@ DEF_TEST(DropShadowImageFilter_Huge, reporter) {
     surf->getCanvas()->saveLayer(nullptr, &paint);
     surf->getCanvas()->restore();
 }
+
+// Draws a layer with a filter DAG that has independent branches and every banded raster filter.
+static SkBitmap draw_filter_dag(SkExecutor* executor, const SkIRect& cropRect) {
+    SkScalar kernel[9] = { 1, 1, 1, 1, -7, 1, 1, 1, 1 };
+    sk_sp<SkImageFilter> blur = SkImageFilters::Blur(3, 5, nullptr);
+    sk_sp<SkImageFilter> bigBlur = SkImageFilters::Blur(40, 2, nullptr);
+    sk_sp<SkImageFilter> dilate = SkImageFilters::Dilate(2, 3, blur);
+    sk_sp<SkImageFilter> erode = SkImageFilters::Erode(3, 1, nullptr);
+    sk_sp<SkImageFilter> convolve = SkImageFilters::MatrixConvolution(
+            {3, 3}, kernel, 0.3f, 0.1f, {1, 1}, SkTileMode::kClamp, true, nullptr);
+    sk_sp<SkImageFilter> convolveDecal = SkImageFilters::MatrixConvolution(
+            {3, 3}, kernel, 0.3f, 0.1f, {1, 1}, SkTileMode::kDecal, false, nullptr, &cropRect);
+    sk_sp<SkImageFilter> diffuse = SkImageFilters::DistantLitDiffuse(
+            {1, 1, 1}, SK_ColorWHITE, 2, 0.8f, blur);
+    sk_sp<SkImageFilter> specular = SkImageFilters::SpotLitSpecular(
+            {100, 100, 50}, {300, 250, 0}, 2, 30, SK_ColorCYAN, 1.5f, 0.7f, 4, dilate, &cropRect);
+    sk_sp<SkImageFilter> arithmetic = SkImageFilters::Arithmetic(
+            0.2f, 0.5f, 0.5f, 0, true, dilate, diffuse);
+    sk_sp<SkImageFilter> blend = SkImageFilters::Blend(SkBlendMode::kMultiply, convolve, erode);
+    sk_sp<SkImageFilter> displace = SkImageFilters::DisplacementMap(
+            SkColorChannel::kR, SkColorChannel::kG, 12, arithmetic, blend);
+    sk_sp<SkImageFilter> inputs[] = { displace, specular, bigBlur, blend, convolveDecal };
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(600, 500);
+    bitmap.eraseColor(SK_ColorWHITE);
+    auto device = sk_make_sp<SkBitmapDevice>(bitmap);
+    device->setImageFilterExecutor(executor);
+    SkCanvas canvas(device);
+
+    // Results cached by the other draw would hide any differences.
+    SkImageFilterCache::Get()->purge();
+
+    SkPaint layerPaint;
+    layerPaint.setImageFilter(SkImageFilters::Merge(inputs, SK_ARRAY_COUNT(inputs)));
+    canvas.saveLayer(nullptr, &layerPaint);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 12; ++i) {
+        paint.setColor(SkColorSetARGB(0xFF, 20 * i, 255 - 20 * i, (80 * i) & 0xFF));
+        canvas.drawCircle(50 + 45 * i, 60 + 33 * i, 40, paint);
+    }
+    canvas.restore();
+    return bitmap;
+}
+
+DEF_TEST(ImageFilterExecutor, reporter) {
+    // Filters nest their concurrent work (e.g. a merge's inputs each blur in bands), which must
+    // also finish on executors whose threads can't be borrowed by waiting tasks.
+    std::unique_ptr<SkExecutor> executors[] = {
+        SkExecutor::MakeFIFOThreadPool(4),
+        SkExecutor::MakeFIFOThreadPool(2, /*allowBorrowing=*/false),
+        SkExecutor::MakeFIFOThreadPool(1, /*allowBorrowing=*/false),
+    };
+    for (const std::unique_ptr<SkExecutor>& executor : executors) {
+        // The second crop rect extends past the layer, so the lighting and convolution filters
+        // also handle edges that are decal tiled.
+        for (SkIRect cropRect : {SkIRect::MakeLTRB(0, 0, 600, 500),
+                                 SkIRect::MakeLTRB(-20, 13, 580, 520)}) {
+            SkBitmap expected = draw_filter_dag(nullptr, cropRect),
+                     actual   = draw_filter_dag(executor.get(), cropRect);
+            bool equal = true;
+            for (int y = 0; y < expected.height(); ++y) {
+                equal &= !memcmp(expected.getAddr32(0, y), actual.getAddr32(0, y),
+                                 expected.width() * sizeof(uint32_t));
+            }
+            REPORTER_ASSERT(reporter, equal);
+        }
+    }
+}
+
+// Draws a filter result into a bitmap that covers 'bounds' in layer space.
+static SkBitmap draw_filter_result(const skif::FilterResult& result, const SkIRect& bounds) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(bounds.width(), bounds.height());
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    if (result.image()) {
+        SkCanvas canvas(bitmap);
+        result.image()->draw(&canvas, result.layerOrigin().x() - bounds.fLeft,
+                             result.layerOrigin().y() - bounds.fTop);
+    }
+    return bitmap;
+}
+
+static bool bitmaps_equal(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(uint32_t))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Forwards to a real cache, and checks that the images small enough to be tiles only hold their
+// own pixels, which is what the cache charges for them.
+class TileSizeCheckingCache : public SkImageFilterCache {
+public:
+    explicit TileSizeCheckingCache(skiatest::Reporter* reporter)
+            : fReporter(reporter)
+            , fCache(SkImageFilterCache::Create(64 * 1024 * 1024)) {}
+
+    bool get(const SkImageFilterCacheKey& key, skif::FilterResult* result) const override {
+        return fCache->get(key, result);
+    }
+    void set(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
+             const skif::FilterResult& result) override {
+        const SkSpecialImage* image = result.image();
+        if (image && image->width() <= 256 && image->height() <= 256) {
+            REPORTER_ASSERT(fReporter,
+                            image->getSize() == (size_t)image->width() * image->height() * 4,
+                            "%dx%d image holds %zu bytes", image->width(), image->height(),
+                            image->getSize());
+        }
+        fCache->set(key, filter, result);
+    }
+    void purge() override { fCache->purge(); }
+    void purgeByImageFilter(const SkImageFilter* filter) override {
+        fCache->purgeByImageFilter(filter);
+    }
+    SkDEBUGCODE(int count() const override { return fCache->count(); })
+
+private:
+    skiatest::Reporter*       fReporter;
+    sk_sp<SkImageFilterCache> fCache;
+};
+
+DEF_TEST(ImageFilterTiled, reporter) {
+    SkBitmap srcBitmap;
+    srcBitmap.allocN32Pixels(900, 700);
+    srcBitmap.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas canvas(srcBitmap);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 20; ++i) {
+            paint.setColor(SkColorSetARGB(0xFF, 12 * i, 255 - 12 * i, (80 * i) & 0xFF));
+            canvas.drawCircle(40 + 43 * i, 30 + 33 * i, 35, paint);
+        }
+    }
+    sk_sp<SkSpecialImage> srcImage = SkSpecialImage::MakeFromRaster(
+            SkIRect::MakeWH(900, 700), srcBitmap, SkSurfaceProps());
+
+    SkPictureRecorder recorder;
+    SkPaint picturePaint;
+    picturePaint.setColor(SK_ColorBLUE);
+    recorder.beginRecording(SkRect::MakeWH(900, 700))->drawRect({100, 50, 700, 400}, picturePaint);
+    sk_sp<SkImageFilter> picture = SkImageFilters::Picture(recorder.finishRecordingAsPicture());
+
+    SkScalar kernel[9] = { 1, 1, 1, 1, -7, 1, 1, 1, 1 };
+    SkIRect cropRect = SkIRect::MakeLTRB(30, 40, 650, 600);
+    sk_sp<SkImageFilter> filters[] = {
+        SkImageFilters::Blur(8, 3, nullptr),
+        SkImageFilters::Blur(5, 5, SkTileMode::kClamp, nullptr),
+        SkImageFilters::DropShadow(10, 12, 6, 6, SK_ColorBLACK, nullptr),
+        SkImageFilters::Dilate(4, 2, SkImageFilters::Offset(7, -5, nullptr)),
+        SkImageFilters::MatrixConvolution({3, 3}, kernel, 0.3f, 0.1f, {1, 1}, SkTileMode::kClamp,
+                                          true, nullptr, &cropRect),
+        SkImageFilters::DisplacementMap(SkColorChannel::kR, SkColorChannel::kG, 12,
+                                        SkImageFilters::Blur(3, 3, nullptr), nullptr),
+        SkImageFilters::Blur(6, 6, picture),
+        SkImageFilters::Merge(SkImageFilters::Erode(2, 2, picture), nullptr),
+    };
+
+    // The first desired output is filtered in one piece. Once it moves, the filter is evaluated in
+    // tiles, and scrolling by a few more pixels keeps the same tiles, so they're all reused.
+    const SkIRect desiredOutputs[] = { SkIRect::MakeLTRB(20, 20, 620, 520),
+                                       SkIRect::MakeLTRB(25, 22, 625, 522),
+                                       SkIRect::MakeLTRB(30, 24, 630, 524) };
+    for (const sk_sp<SkImageFilter>& filter : filters) {
+        sk_sp<SkImageFilterCache> cache = sk_make_sp<TileSizeCheckingCache>(reporter);
+        SkDEBUGCODE(int cachedCount = 0;)
+        for (const SkIRect& desired : desiredOutputs) {
+            SkImageFilter_Base::Context ctx(SkMatrix::I(), desired, cache.get(),
+                                            kN32_SkColorType, nullptr, srcImage.get());
+            SkImageFilter_Base::Context untiledCtx(SkMatrix::I(), desired, nullptr,
+                                                   kN32_SkColorType, nullptr, srcImage.get());
+            SkBitmap tiled = draw_filter_result(as_IFB(filter)->filterImageTiled(ctx), desired),
+                     untiled = draw_filter_result(as_IFB(filter)->filterImage(untiledCtx), desired);
+            REPORTER_ASSERT(reporter, bitmaps_equal(tiled, untiled));
+            SkDEBUGCODE(REPORTER_ASSERT(reporter, &desired != &desiredOutputs[2] ||
+                                                  cache->count() == cachedCount));
+            SkDEBUGCODE(cachedCount = cache->count();)
+        }
+    }
+
+    // Lighting treats the edges of the filtered area as the edges of the surface.
+    REPORTER_ASSERT(reporter, !as_IFB(SkImageFilters::Merge(
+            SkImageFilters::DistantLitSpecular({1, 1, 1}, SK_ColorWHITE, 2, 0.8f, 3, nullptr),
+            nullptr))->canFilterTiles());
+
+    // Filters that don't read the source keep their tiles when the layer matrix is translated.
+    sk_sp<SkImageFilter> filter = SkImageFilters::DropShadow(10, 12, 6, 6, SK_ColorBLACK, picture);
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(64 * 1024 * 1024));
+    SkDEBUGCODE(int cachedCount = 0;)
+    for (int scroll : {0, 3, 7, 40}) {
+        SkMatrix layerMatrix = SkMatrix::Translate(0.25f, 0.5f - scroll);
+        SkIRect desired = SkIRect::MakeLTRB(0, 0, 800, 600);
+        SkImageFilter_Base::Context ctx(layerMatrix, desired, cache.get(),
+                                        kN32_SkColorType, nullptr, srcImage.get());
+        SkImageFilter_Base::Context untiledCtx(layerMatrix, desired, nullptr,
+                                               kN32_SkColorType, nullptr, srcImage.get());
+        SkBitmap tiled = draw_filter_result(as_IFB(filter)->filterImageTiled(ctx), desired),
+                 untiled = draw_filter_result(as_IFB(filter)->filterImage(untiledCtx), desired);
+        REPORTER_ASSERT(reporter, bitmaps_equal(tiled, untiled));
+        SkDEBUGCODE(REPORTER_ASSERT(reporter, scroll < 7 || cache->count() == cachedCount));
+        SkDEBUGCODE(cachedCount = cache->count();)
+    }
+}
+
+// Fills a bitmap with random premultiplied pixels.
+static SkBitmap make_random_bitmap(int width, int height) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(width, height);
+    SkRandom random;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(random.nextU());
+        }
+    }
+    return bitmap;
+}
+
+// Returns the 'index'th byte of each pixel, so the tests don't depend on the channel order.
+static int get_channel(SkPMColor c, int index) {
+    return (c >> (8 * index)) & 0xFF;
+}
+
+static SkBitmap filter_bitmap(const SkImageFilter* filter, const SkBitmap& src) {
+    sk_sp<SkSpecialImage> srcImage = SkSpecialImage::MakeFromRaster(
+            SkIRect::MakeWH(src.width(), src.height()), src, SkSurfaceProps());
+    SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(src.width(), src.height()),
+                                    nullptr, kN32_SkColorType, nullptr, srcImage.get());
+    return draw_filter_result(as_IFB(filter)->filterImage(ctx),
+                              SkIRect::MakeWH(src.width(), src.height()));
+}
+
+DEF_TEST(ImageFilterMorphologyReference, reporter) {
+    SkBitmap src = make_random_bitmap(97, 61);
+
+    // Small radii use a sliding window, large ones the van Herk/Gil-Werman algorithm.
+    for (int radius : {1, 2, 3, 7, 40}) {
+        for (SkISize radii : {SkISize{radius, 0}, SkISize{0, radius}, SkISize{radius, 3}}) {
+            for (bool dilate : {false, true}) {
+                sk_sp<SkImageFilter> filter =
+                        dilate ? SkImageFilters::Dilate(radii.width(), radii.height(), nullptr)
+                               : SkImageFilters::Erode(radii.width(), radii.height(), nullptr);
+                SkBitmap actual = filter_bitmap(filter.get(), src);
+
+                // The source is transparent outside of its bounds.
+                bool equal = true;
+                for (int y = 0; y < src.height(); ++y) {
+                    for (int x = 0; x < src.width(); ++x) {
+                        for (int c = 0; c < 4; ++c) {
+                            int expected = dilate ? 0 : 255;
+                            for (int sy = y - radii.height(); sy <= y + radii.height(); ++sy) {
+                                for (int sx = x - radii.width(); sx <= x + radii.width(); ++sx) {
+                                    int value = 0;
+                                    if (sx >= 0 && sx < src.width() &&
+                                        sy >= 0 && sy < src.height()) {
+                                        value = get_channel(*src.getAddr32(sx, sy), c);
+                                    }
+                                    expected = dilate ? std::max(expected, value)
+                                                      : std::min(expected, value);
+                                }
+                            }
+                            equal &= get_channel(*actual.getAddr32(x, y), c) == expected;
+                        }
+                    }
+                }
+                REPORTER_ASSERT(reporter, equal, "radii %d,%d dilate %d",
+                                radii.width(), radii.height(), dilate);
+            }
+        }
+    }
+}
+
+DEF_TEST(ImageFilterMatrixConvolutionSeparable, reporter) {
+    SkBitmap src = make_random_bitmap(83, 71);
+
+    struct {
+        std::vector<SkScalar> row, column;
+        SkIPoint              offset;
+        SkScalar              gain, bias;
+    } kernels[] = {
+        { {1, 6, 15, 20, 15, 6, 1}, {1, 6, 15, 20, 15, 6, 1}, {3, 3}, 1.0f / 4096, 0 },
+        { {1, -2, 3, 0.5f, -1}, {2, 1, -1, 0.25f}, {1, 2}, 0.1f, 100 },
+    };
+    for (const auto& k : kernels) {
+        int kw = (int)k.row.size(),
+            kh = (int)k.column.size();
+        std::vector<SkScalar> kernel(kw * kh);
+        for (int y = 0; y < kh; ++y) {
+            for (int x = 0; x < kw; ++x) {
+                kernel[y * kw + x] = k.column[y] * k.row[x];
+            }
+        }
+        sk_sp<SkImageFilter> filter = SkImageFilters::MatrixConvolution(
+                {kw, kh}, kernel.data(), k.gain, k.bias, k.offset, SkTileMode::kClamp, true,
+                nullptr);
+        SkBitmap actual = filter_bitmap(filter.get(), src);
+
+        // Filtering with two 1D kernels sums in a different order, so allow off by one results.
+        // Only pixels whose kernel stays within the source are separable, so only they're checked.
+        bool close = true;
+        for (int y = k.offset.fY; y < src.height() - kh + 1 + k.offset.fY; ++y) {
+            for (int x = k.offset.fX; x < src.width() - kw + 1 + k.offset.fX; ++x) {
+                float sums[4] = {0, 0, 0, 0};
+                for (int cy = 0; cy < kh; ++cy) {
+                    for (int cx = 0; cx < kw; ++cx) {
+                        int sx = x + cx - k.offset.fX,
+                            sy = y + cy - k.offset.fY;
+                        for (int c = 0; c < 4; ++c) {
+                            sums[c] += get_channel(*src.getAddr32(sx, sy), c) * kernel[cy * kw + cx];
+                        }
+                    }
+                }
+                int alpha = SkTPin(sk_float_floor2int(sums[SK_A32_SHIFT / 8] * k.gain + k.bias),
+                                   0, 255);
+                for (int c = 0; c < 4; ++c) {
+                    int expected = SkTPin(sk_float_floor2int(sums[c] * k.gain + k.bias), 0, alpha);
+                    close &= std::abs(get_channel(*actual.getAddr32(x, y), c) - expected) <= 1;
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, close);
+    }
+}
+
@@ -468,3 +468,33 @@ DEF_TEST(JSON_ParseNumber, reporter) {
         REPORTER_ASSERT(reporter, SkScalarNearlyEqual(**jnumber, test.value, test.tolerance));
     }
 }
+
+DEF_TEST(JSON_Binary, reporter) {
+    static constexpr const char* gTests[] = {
+        "[]",
+        "{}",
+        "[null,true,false]",
+        "[0,1,-1,42,-2147483648,2147483647,42.75,-0.5,3e+09]",
+        "[\"\",\"foo\",\"foo bar baz\"]",
+        "{\"k0\":{},\"k1\":[],\"key_2\":{\"a\":[1,[2,[3]]],\"long key\":\"long value\"}}",
+    };
+
+    for (const auto& json : gTests) {
+        const DOM dom(json, strlen(json));
+        REPORTER_ASSERT(reporter, !dom.root().is<NullValue>());
+
+        SkDynamicMemoryWStream stream;
+        dom.writeBinary(&stream);
+        const auto bin = stream.detachAsData();
+
+        const DOM bin_dom(static_cast<const char*>(bin->data()), bin->size());
+        REPORTER_ASSERT(reporter, 0 == strcmp(dom.root().toString().c_str(),
+                                              bin_dom.root().toString().c_str()));
+
+        // Truncated inputs are rejected.
+        for (size_t len = 0; len < bin->size(); ++len) {
+            const DOM truncated(static_cast<const char*>(bin->data()), len);
+            REPORTER_ASSERT(reporter, truncated.root().is<NullValue>());
+        }
+    }
+}
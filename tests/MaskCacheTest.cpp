@@ -5,8 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/effects/SkDashPathEffect.h"
 #include "src/core/SkCachedData.h"
+#include "src/core/SkDraw.h"
 #include "src/core/SkMaskCache.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkPathMaskCache.h"
+#include "src/core/SkRasterClip.h"
 #include "src/core/SkResourceCache.h"
 #include "tests/Test.h"
 
@@ -102,3 +108,154 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+static SkPath make_star(SkScalar radius) {
+    SkPath path;
+    for (int index = 0; index < 10; ++index) {
+        SkScalar r = index & 1 ? radius / 2 : radius;
+        SkScalar angle = index * SK_ScalarPI / 5;
+        path.lineTo(r * SkScalarCos(angle), r * SkScalarSin(angle));
+    }
+    path.close();
+    return path;
+}
+
+DEF_TEST(PathMaskCache, reporter) {
+    SkResourceCache cache(64 * 1024);
+    SkPathMaskDrawnSet drawn;
+
+    SkPath path = make_star(20);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkPathMaskCache::Desc desc;
+    REPORTER_ASSERT(reporter, desc.init(path, paint, SkMatrix::Translate(30.3f, 39.9f)));
+    REPORTER_ASSERT(reporter, desc.fOffset == SkIPoint::Make(30, 40));
+    REPORTER_ASSERT(reporter, desc.maskMatrix() == SkMatrix::Translate(0.25f, 0));
+
+    // A path isn't cached until it has been drawn twice.
+    SkMask mask;
+    REPORTER_ASSERT(reporter, !SkPathMaskCache::FindAndRef(desc, &mask, &cache));
+    REPORTER_ASSERT(reporter, !SkPathMaskCache::MarkDrawn(desc, &drawn));
+    REPORTER_ASSERT(reporter, SkPathMaskCache::MarkDrawn(desc, &drawn));
+
+    size_t size = 40 * 40;
+    SkCachedData* data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    mask.fBounds.setXYWH(10, 20, 40, 40);
+    mask.fRowBytes = 40;
+    mask.fFormat = SkMask::kA8_Format;
+    SkPathMaskCache::Add(desc, path, mask, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+    data->unref();
+
+    // The mask is found wherever the path is drawn at the same subpixel phase, but not at other
+    // phases, nor with another style.
+    SkPathMaskCache::Desc moved;
+    REPORTER_ASSERT(reporter, moved.init(path, paint, SkMatrix::Translate(-9.8f, 50.1f)));
+    sk_bzero(&mask, sizeof(mask));
+    data = SkPathMaskCache::FindAndRef(moved, &mask, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, mask.fBounds == SkIRect::MakeXYWH(-30, 30, 40, 40));
+    REPORTER_ASSERT(reporter, data->data() == (const void*)mask.fImage);
+    check_data(reporter, data, 2, kInCache, kLocked);
+    data->unref();
+
+    REPORTER_ASSERT(reporter, moved.init(path, paint, SkMatrix::Translate(30.5f, 40)));
+    REPORTER_ASSERT(reporter, !SkPathMaskCache::FindAndRef(moved, &mask, &cache));
+    SkPaint stroke(paint);
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(2);
+    REPORTER_ASSERT(reporter, moved.init(path, stroke, SkMatrix::Translate(30.25f, 40)));
+    REPORTER_ASSERT(reporter, !SkPathMaskCache::FindAndRef(moved, &mask, &cache));
+
+    // Editing the path purges its masks.
+    path.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, !SkPathMaskCache::FindAndRef(desc, &mask, &cache));
+    REPORTER_ASSERT(reporter, desc.init(path, paint, SkMatrix::Translate(30.25f, 40)));
+    REPORTER_ASSERT(reporter, !SkPathMaskCache::MarkDrawn(desc, &drawn));
+
+    // Draws which can't use the cache.
+    SkPath other = make_star(20);
+    REPORTER_ASSERT(reporter, desc.init(other, paint, SkMatrix::I()));
+    other.setIsVolatile(true);
+    REPORTER_ASSERT(reporter, !desc.init(other, paint, SkMatrix::I()));
+    other.setIsVolatile(false);
+    other.toggleInverseFillType();
+    REPORTER_ASSERT(reporter, !desc.init(other, paint, SkMatrix::I()));
+    REPORTER_ASSERT(reporter, !desc.init(SkPath::Rect({0, 0, 10, 10}), paint, SkMatrix::I()));
+    REPORTER_ASSERT(reporter, !desc.init(path, paint, SkMatrix::MakeAll(1, 0, 0,
+                                                                       0, 1, 0,
+                                                                       0.01f, 0, 1)));
+    REPORTER_ASSERT(reporter, !desc.init(path, paint, SkMatrix::Scale(10, 10)));
+    stroke.setStrokeWidth(0);
+    REPORTER_ASSERT(reporter, !desc.init(path, stroke, SkMatrix::I()));
+    SkScalar intervals[] = {2, 2};
+    paint.setPathEffect(SkDashPathEffect::Make(intervals, 2, 0));
+    REPORTER_ASSERT(reporter, !desc.init(path, paint, SkMatrix::I()));
+}
+
+// A path's first draw, which renders its mask without caching it, its second, which caches the
+// mask, and its later ones, which blit the cached mask, all produce the same pixels. (This draws
+// through a cache and draw set of its own, so that other tests can't purge or displace them.)
+DEF_TEST(PathMaskCacheDraw, reporter) {
+    SkPath path = make_star(20);
+    path.addCircle(0, 0, 6);
+    SkPaint paints[3];
+    paints[0].setAntiAlias(true);
+    paints[1].setAntiAlias(true);
+    paints[1].setStyle(SkPaint::kStroke_Style);
+    paints[1].setStrokeWidth(3);
+    paints[1].setStrokeJoin(SkPaint::kRound_Join);
+    paints[2].setColor(SK_ColorBLUE);
+
+    // The translation is off the cache's subpixel grid, so the draws are rounded to it.
+    const SkMatrixProvider matrixProvider(SkMatrix::Translate(80.6f, 30.3f));
+    const SkIRect kClip = {0, 0, 90, 40};
+    SkResourceCache cache(1024 * 1024);
+    SkPathMaskDrawnSet drawn;
+
+    for (const SkPaint& paint : paints) {
+        SkPathMaskCache::Desc desc;
+        REPORTER_ASSERT(reporter, desc.init(path, paint, matrixProvider.localToDevice()));
+
+        // The last draw is clipped, so that a cached mask is also blitted through a clip.
+        SkBitmap bitmaps[4];
+        for (int i = 0; i < 4; ++i) {
+            bitmaps[i].allocN32Pixels(128, 64);
+            bitmaps[i].eraseColor(SK_ColorWHITE);
+            SkRasterClip clip(i < 3 ? bitmaps[i].bounds() : kClip);
+
+            SkDraw draw;
+            draw.fDst              = bitmaps[i].pixmap();
+            draw.fMatrixProvider   = &matrixProvider;
+            draw.fRC               = &clip;
+            draw.fPathMaskCache    = &cache;
+            draw.fPathMaskDrawnSet = &drawn;
+            draw.drawPath(path, paint);
+
+            SkMask mask;
+            SkCachedData* data = SkPathMaskCache::FindAndRef(desc, &mask, &cache);
+            REPORTER_ASSERT(reporter, SkToBool(data) == (i > 0), "draw %d", i);
+            if (data) {
+                data->unref();
+            }
+        }
+
+        for (int i = 1; i < 4; ++i) {
+            for (int y = 0; y < bitmaps[0].height(); ++y) {
+                for (int x = 0; x < bitmaps[0].width(); ++x) {
+                    SkColor e = bitmaps[0].getColor(x, y),
+                            a = bitmaps[i].getColor(x, y);
+                    if (i == 3 && !kClip.contains(x, y)) {
+                        e = SK_ColorWHITE;
+                    }
+                    if (e != a) {
+                        ERRORF(reporter, "draw %d differs at (%d, %d): %08x vs. %08x",
+                               i, x, y, a, e);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
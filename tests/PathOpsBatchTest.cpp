@@ -0,0 +1,117 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkPathPriv.h"
+#include "tests/PathOpsExtendedTest.h"
+#include "tests/Test.h"
+
+#include <vector>
+
+static std::vector<SkPath> make_batch_paths() {
+    std::vector<SkPath> paths;
+    SkRandom random;
+    // Three separate clumps of overlapping shapes, and a row of tiles which only share edges.
+    for (int clump = 0; clump < 3; ++clump) {
+        SkScalar originX = clump * 100.f;
+        for (int index = 0; index < 12; ++index) {
+            SkScalar x = originX + random.nextRangeScalar(0, 40),
+                     y = random.nextRangeScalar(0, 40),
+                     size = random.nextRangeScalar(10, 40);
+            SkPath path;
+            if (index & 1) {
+                path.addRect(SkRect::MakeXYWH(x, y, size, size));
+            } else {
+                path.moveTo(x, y);
+                path.lineTo(x + size, y + size / 2);
+                path.lineTo(x, y + size);
+                path.close();
+            }
+            paths.push_back(path);
+        }
+    }
+    for (int tile = 0; tile < 5; ++tile) {
+        paths.push_back(SkPath::Rect(SkRect::MakeXYWH(tile * 20.f, 150, 20, 20)));
+    }
+    return paths;
+}
+
+static void check_batch_op(skiatest::Reporter* reporter, const std::vector<SkPath>& paths,
+                           SkPathOp op, SkExecutor* executor) {
+    SkPath expected;
+    if (op == kUnion_SkPathOp) {
+        SkOpBuilder builder;
+        for (const SkPath& path : paths) {
+            builder.add(path, op);
+        }
+        REPORTER_ASSERT(reporter, builder.resolve(&expected));
+    } else {
+        expected = paths[0];
+        for (size_t index = 1; index < paths.size(); ++index) {
+            REPORTER_ASSERT(reporter, Op(expected, paths[index], op, &expected));
+        }
+    }
+
+    SkPath result;
+    REPORTER_ASSERT(reporter, BatchOp(paths.data(), SkToInt(paths.size()), op, &result, executor));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, expected, result));
+}
+
+DEF_TEST(PathOpsBatchUnion, reporter) {
+    std::vector<SkPath> paths = make_batch_paths();
+    check_batch_op(reporter, paths, kUnion_SkPathOp, nullptr);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    check_batch_op(reporter, paths, kUnion_SkPathOp, executor.get());
+
+    // Tiles which only share edges are merged, rather than appended to each other.
+    SkPath result;
+    REPORTER_ASSERT(reporter, BatchOp(paths.data() + 36, 5, kUnion_SkPathOp, &result));
+    SkPath row = SkPath::Rect(SkRect::MakeXYWH(0, 150, 100, 20));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, row, result));
+    REPORTER_ASSERT(reporter, result.getBounds() == row.getBounds());
+    int contours = 0;
+    for (auto [verb, pts, weight] : SkPathPriv::Iterate(result)) {
+        contours += verb == SkPathVerb::kMove;
+    }
+    REPORTER_ASSERT(reporter, contours == 1);
+
+    // An inverse path overlaps everything.
+    std::vector<SkPath> inverse = {paths[0], paths[20], paths[36]};
+    inverse[1].toggleInverseFillType();
+    check_batch_op(reporter, inverse, kUnion_SkPathOp, executor.get());
+
+    REPORTER_ASSERT(reporter, BatchOp(nullptr, 0, kUnion_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, result.isEmpty());
+}
+
+DEF_TEST(PathOpsBatchIntersect, reporter) {
+    std::vector<SkPath> paths;
+    for (int index = 0; index < 9; ++index) {
+        SkScalar offset = index * 3.f;
+        paths.push_back(SkPath::Circle(50 + offset, 50 - offset, 40));
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    check_batch_op(reporter, paths, kIntersect_SkPathOp, nullptr);
+    check_batch_op(reporter, paths, kIntersect_SkPathOp, executor.get());
+
+    // Disjoint bounds produce an empty result without any ops.
+    paths.push_back(SkPath::Rect(SkRect::MakeXYWH(200, 200, 10, 10)));
+    SkPath result = paths[0];
+    REPORTER_ASSERT(reporter, BatchOp(paths.data(), SkToInt(paths.size()), kIntersect_SkPathOp,
+                                      &result, executor.get()));
+    REPORTER_ASSERT(reporter, result.isEmpty());
+}
+
+DEF_TEST(PathOpsBatchUnsupported, reporter) {
+    SkPath paths[] = { SkPath::Rect({0, 0, 10, 10}), SkPath::Rect({5, 5, 15, 15}) };
+    SkPath result = SkPath::Circle(0, 0, 1);
+    REPORTER_ASSERT(reporter, !BatchOp(paths, 2, kDifference_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, !BatchOp(paths, 2, kXOR_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, result == SkPath::Circle(0, 0, 1));
+}
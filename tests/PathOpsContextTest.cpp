@@ -0,0 +1,131 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkRandom.h"
+#include "src/core/SkPathPriv.h"
+#include "tests/PathOpsExtendedTest.h"
+#include "tests/Test.h"
+
+static const SkPathOp kOps[] = {
+    kDifference_SkPathOp, kIntersect_SkPathOp, kUnion_SkPathOp, kXOR_SkPathOp,
+    kReverseDifference_SkPathOp,
+};
+
+static SkPath random_convex(SkRandom* random, SkScalar left, SkScalar top) {
+    SkScalar size = random->nextRangeScalar(10, 40);
+    SkRect rect = SkRect::MakeXYWH(left, top, size, size);
+    switch (random->nextULessThan(3)) {
+        case 0:
+            return SkPath::Rect(rect);
+        case 1:
+            return SkPath::Polygon({{rect.fLeft, rect.fTop}, {rect.fRight, rect.centerY()},
+                                    {rect.fLeft, rect.fBottom}}, true);
+        default:
+            return SkPath::Polygon({{rect.centerX(), rect.fTop}, {rect.fRight, rect.centerY()},
+                                    {rect.centerX(), rect.fBottom}, {rect.fLeft, rect.centerY()}},
+                                   true);
+    }
+}
+
+// Returns the same area with its first line drawn as a quad, so that none of the shortcuts for
+// rects and convex polygons apply.
+static SkPath with_quad(const SkPath& path) {
+    SkPath result;
+    bool first = true;
+    for (auto [verb, pts, weight] : SkPathPriv::Iterate(path)) {
+        switch (verb) {
+            case SkPathVerb::kMove:
+                result.moveTo(pts[0]);
+                break;
+            case SkPathVerb::kLine:
+                if (first) {
+                    result.quadTo((pts[0] + pts[1]) * 0.5f, pts[1]);
+                    first = false;
+                } else {
+                    result.lineTo(pts[1]);
+                }
+                break;
+            case SkPathVerb::kClose:
+                result.close();
+                break;
+            default:
+                SkASSERT(false);
+        }
+    }
+    result.setFillType(path.getFillType());
+    return result;
+}
+
+DEF_TEST(PathOpsTrivialOps, reporter) {
+    SkRandom random;
+    for (int index = 0; index < 200; ++index) {
+        SkPath one = random_convex(&random, random.nextRangeScalar(0, 40),
+                                   random.nextRangeScalar(0, 40));
+        SkPath two = random_convex(&random, random.nextRangeScalar(0, 40),
+                                   random.nextRangeScalar(0, 40));
+        for (SkPathOp op : kOps) {
+            SkPath fast, slow;
+            REPORTER_ASSERT(reporter, Op(one, two, op, &fast));
+            REPORTER_ASSERT(reporter, Op(with_quad(one), with_quad(two), op, &slow));
+            REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, slow, fast));
+        }
+    }
+
+    // Paths with disjoint bounds are combined without intersecting them.
+    SkPath one = SkPath::Circle(20, 20, 10);
+    SkPath two = SkPath::Rect({40, 10, 60, 30});
+    SkPath both = one;
+    both.addPath(two);
+    SkPath result;
+    REPORTER_ASSERT(reporter, Op(one, two, kUnion_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, both, result));
+    REPORTER_ASSERT(reporter, Op(one, two, kXOR_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, both, result));
+    REPORTER_ASSERT(reporter, Op(one, two, kDifference_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, one, result));
+    REPORTER_ASSERT(reporter, Op(one, two, kIntersect_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, result.isEmpty());
+
+    // Rects which only share an edge are still joined.
+    REPORTER_ASSERT(reporter, Op(two, SkPath::Rect({60, 10, 80, 30}), kUnion_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__,
+                                            SkPath::Rect({40, 10, 80, 30}), result));
+
+    // Nested rects.
+    REPORTER_ASSERT(reporter, Op(two, SkPath::Rect({45, 15, 50, 20}), kUnion_SkPathOp, &result));
+    SkRect rect;
+    REPORTER_ASSERT(reporter, result.isRect(&rect) && rect == two.getBounds());
+    REPORTER_ASSERT(reporter, Op(SkPath::Rect({45, 15, 50, 20}), two, kDifference_SkPathOp,
+                                 &result));
+    REPORTER_ASSERT(reporter, result.isEmpty());
+}
+
+DEF_TEST(PathOpsContext, reporter) {
+    SkRandom random;
+    SkOpContext context;
+    for (int index = 0; index < 100; ++index) {
+        // Alternate between small paths and a pair of large ones, which outgrow the context's
+        // initial storage.
+        SkPath one, two;
+        int count = index % 10 ? 2 : 60;
+        for (int shape = 0; shape < count; ++shape) {
+            one.addPath(random_convex(&random, random.nextRangeScalar(0, 100),
+                                      random.nextRangeScalar(0, 100)));
+            two.addPath(with_quad(random_convex(&random, random.nextRangeScalar(0, 100),
+                                                random.nextRangeScalar(0, 100))));
+        }
+        SkPathOp op = kOps[index % SK_ARRAY_COUNT(kOps)];
+        SkPath expected, result;
+        REPORTER_ASSERT(reporter, Op(one, two, op, &expected));
+        REPORTER_ASSERT(reporter, context.op(one, two, op, &result));
+        REPORTER_ASSERT(reporter, result == expected);
+
+        REPORTER_ASSERT(reporter, Simplify(one, &expected));
+        REPORTER_ASSERT(reporter, context.simplify(one, &result));
+        REPORTER_ASSERT(reporter, result == expected);
+    }
+}
@@ -6,14 +6,17 @@
  */
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/shaders/SkPictureShader.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
 // Test that the SkPictureShader cache is purged on shader deletion.
 DEF_TEST(PictureShader_caching, reporter) {
@@ -110,3 +113,114 @@ DEF_TEST(PictureShader_caching2, reporter) {
     SkResourceCache::VisitAll(counter, &data);
     REPORTER_ASSERT(reporter, data.counter == 0);
 }
+
+static int count_cache_entries(const SkPicture* picture) {
+    struct Data {
+        uint64_t sharedID;
+        int counter;
+    } data = {
+        SkPicturePriv::MakeSharedID(picture->uniqueID()),
+        0,
+    };
+    SkResourceCache::VisitAll([](const SkResourceCache::Rec& rec, void* dataPtr) {
+        if (rec.getKey().getSharedID() == ((Data*)dataPtr)->sharedID) {
+            ((Data*)dataPtr)->counter += 1;
+        }
+    }, &data);
+    return data.counter;
+}
+
+static sk_sp<SkPicture> make_circles_picture(int width, int height) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(width, height);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 10; ++i) {
+        paint.setColor(SkColorSetARGB(0xFF, 25 * i, 255 - 25 * i, 0x80));
+        canvas->drawCircle(width * (i + 1) / 12.0f, height * (10 - i) / 12.0f, width / 8.0f,
+                           paint);
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+// Scales between two powers of two share one rasterization of the picture.
+DEF_TEST(PictureShader_scaleBuckets, reporter) {
+    sk_sp<SkPicture> picture = make_circles_picture(100, 100);
+    SkPaint paint;
+    paint.setShader(picture->makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat,
+                                        SkFilterMode::kNearest));
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(200, 200);
+
+    // Each scale has its own tile, all downsampled from the tile at scale 2.
+    const SkScalar scales[] = { 1.1f, 1.3f, 1.6f, 1.9f };
+    for (SkScalar scale : scales) {
+        surface->getCanvas()->setMatrix(SkMatrix::Scale(scale, scale));
+        surface->getCanvas()->drawPaint(paint);
+    }
+    REPORTER_ASSERT(reporter, count_cache_entries(picture.get()) == SK_ARRAY_COUNT(scales) + 1);
+
+    // Scale 2 is the bucket itself.
+    surface->getCanvas()->setMatrix(SkMatrix::Scale(2, 2));
+    surface->getCanvas()->drawPaint(paint);
+    REPORTER_ASSERT(reporter, count_cache_entries(picture.get()) == SK_ARRAY_COUNT(scales) + 1);
+
+    // Scale 1 has no bucket of its own.
+    surface->getCanvas()->setMatrix(SkMatrix::I());
+    surface->getCanvas()->drawPaint(paint);
+    REPORTER_ASSERT(reporter, count_cache_entries(picture.get()) == SK_ARRAY_COUNT(scales) + 2);
+}
+
+// Large tiles are rasterized in bands, which should match drawing the picture in one piece. Edges
+// clipped by a band boundary may be anti-aliased slightly differently.
+DEF_TEST(PictureShader_bandedTile, reporter) {
+    sk_sp<SkPicture> picture = make_circles_picture(1200, 1000);
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(1200, 1000);
+    actual.allocN32Pixels(1200, 1000);
+    expected.eraseColor(SK_ColorTRANSPARENT);
+    actual.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas(expected).drawPicture(picture);
+
+    SkPaint paint;
+    paint.setShader(picture->makeShader(SkTileMode::kClamp, SkTileMode::kClamp,
+                                        SkFilterMode::kNearest));
+    SkCanvas(actual).drawPaint(paint);
+
+    int maxDiff = 0;
+    for (int y = 0; y < expected.height(); ++y) {
+        for (int x = 0; x < expected.width(); ++x) {
+            SkPMColor e = *expected.getAddr32(x, y),
+                      a = *actual.getAddr32(x, y);
+            for (int shift : {0, 8, 16, 24}) {
+                maxDiff = std::max(maxDiff, std::abs((int)((e >> shift) & 0xFF) -
+                                                     (int)((a >> shift) & 0xFF)));
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, maxDiff <= 2, "max diff %d", maxDiff);
+}
+
+// Concurrent draws that miss the cache wait for one rasterization of the tile.
+DEF_TEST(PictureShader_concurrentDraws, reporter) {
+    sk_sp<SkPicture> picture = make_circles_picture(300, 300);
+    sk_sp<SkShader> shader = picture->makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat,
+                                                 SkFilterMode::kLinear);
+
+    constexpr int kDraws = 8;
+    SkBitmap bitmaps[kDraws];
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkTaskGroup(*executor).batch(kDraws, [&](int i) {
+        bitmaps[i].allocN32Pixels(256, 256);
+        SkCanvas canvas(bitmaps[i]);
+        canvas.scale(1.5f, 1.5f);
+        SkPaint paint;
+        paint.setShader(shader);
+        canvas.drawPaint(paint);
+    });
+
+    for (int i = 1; i < kDraws; ++i) {
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(bitmaps[0], bitmaps[i]));
+    }
+    // The tile at 1.5 and its bucket at 2.
+    REPORTER_ASSERT(reporter, count_cache_entries(picture.get()) == 2);
+}
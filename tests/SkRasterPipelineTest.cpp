@@ -568,3 +568,85 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipeline_fusion, r) {
+    // SkRasterPipeline runs some common sequences of stages as single fused stages.  Splitting
+    // each sequence with clamp_0, which has no effect on these values, keeps it from fusing,
+    // so we can check that fusing doesn't change the results.
+    uint32_t src[64];
+    for (int i = 0; i < 64; i++) {
+        src[i] = (4*i+3) << 24 | (3*i) << 16 | (2*i) << 8 | (i+7);
+    }
+
+    // The coordinate matrices map each row into the 8x8 image of src, avoiding pixel edges.
+    const float scaleTranslate[] = { 1/8.0f, 4, 0.1f, 0.2f },
+                affine[]         = { 1/8.0f, 0.5f, 0.1f, 1/16.0f, 2, 0.2f };
+
+    auto run = [&](bool fuse, bool highp, uint32_t dst[64], uint32_t sampled[2][64]) {
+        auto split = [fuse](SkRasterPipeline* p) {
+            if (!fuse) {
+                p->append(SkRasterPipeline::clamp_0);
+            }
+        };
+
+        // load_8888 -> premul, and load_8888_dst -> srcover -> store_8888.
+        SkRasterPipeline_MemoryCtx srcCtx = { src, 0 },
+                                   dstCtx = { dst, 0 };
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::load_8888, &srcCtx);
+        split(&p);
+        p.append(SkRasterPipeline::premul);
+        p.append(SkRasterPipeline::load_8888_dst, &dstCtx);
+        p.append(SkRasterPipeline::srcover);
+        split(&p);
+        p.append(SkRasterPipeline::store_8888, &dstCtx);
+        p.runForTesting(0,0,64,1, highp);
+
+        // seed_shader -> matrix_scale_translate, and seed_shader -> matrix_2x3.  Those stages
+        // only produce coordinates, so they're checked by sampling src through them.
+        SkRasterPipeline_GatherCtx gatherCtx = { src, 8, 8, 8 };
+        SkRasterPipeline_MemoryCtx sampledCtx = { sampled, 64 };
+        for (int y = 0; y < 2; y++) {
+            SkRasterPipeline_<256> q;
+            q.append(SkRasterPipeline::seed_shader);
+            split(&q);
+            if (y == 0) {
+                q.append(SkRasterPipeline::matrix_scale_translate, scaleTranslate);
+            } else {
+                q.append(SkRasterPipeline::matrix_2x3, affine);
+            }
+            q.append(SkRasterPipeline::gather_8888, &gatherCtx);
+            q.append(SkRasterPipeline::store_8888, &sampledCtx);
+            q.runForTesting(0,y,64,1, highp);
+        }
+    };
+
+    for (bool highp : {false, true}) {
+        uint32_t want[64], got[64], wantSampled[2][64], gotSampled[2][64];
+        for (int i = 0; i < 64; i++) {
+            want[i] = got[i] = 0x80402010 + 0x01010101 * (uint32_t)i;
+        }
+        run(false, highp, want, wantSampled);
+        run(true , highp, got , gotSampled);
+
+        for (int i = 0; i < 64; i++) {
+            if (got[i] != want[i]) {
+                ERRORF(r, "highp=%d: got %08x, want %08x", highp, got[i], want[i]);
+            }
+            float x = i + 0.5f;
+            int expected[2] = {
+                std::min((int)(x * scaleTranslate[0] + scaleTranslate[2]), 7) +
+                        8 * (int)(0.5f * scaleTranslate[1] + scaleTranslate[3]),
+                std::min((int)(x * affine[0] + 1.5f * affine[1] + affine[2]), 7) +
+                        8 * (int)(x * affine[3] + 1.5f * affine[4] + affine[5]),
+            };
+            for (int y = 0; y < 2; y++) {
+                if (gotSampled[y][i] != wantSampled[y][i] ||
+                    gotSampled[y][i] != src[expected[y]]) {
+                    ERRORF(r, "highp=%d: sampled %08x, unfused %08x, want %08x",
+                           highp, gotSampled[y][i], wantSampled[y][i], src[expected[y]]);
+                }
+            }
+        }
+    }
+}
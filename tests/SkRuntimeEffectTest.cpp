@@ -10,11 +10,13 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkBlenders.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/gpu/GrDirectContext.h"
+#include "include/private/SkMutex.h"
 #include "include/sksl/SkSLDebugTrace.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkRuntimeEffectPriv.h"
@@ -30,6 +32,8 @@
 #include "tests/Test.h"
 
 #include <algorithm>
+#include <map>
+#include <string>
 #include <thread>
 
 void test_invalid_effect(skiatest::Reporter* r, const char* src, const char* expected) {
@@ -896,8 +900,8 @@ DEF_TEST(SkRuntimeShaderBuilderSetUniforms, r) {
 }
 
 DEF_TEST(SkRuntimeEffectThreaded, r) {
-    // SkRuntimeEffect uses a single compiler instance, but it's mutex locked.
-    // This tests that we can safely use it from more than one thread, and also
+    // SkRuntimeEffect uses a small pool of compiler instances, each of them mutex locked.
+    // This tests that we can safely use them from more than one thread, and also
     // that programs don't refer to shared structures owned by the compiler.
     // skbug.com/10589
     static constexpr char kSource[] = "half4 main(float2 p) { return sk_FragCoord.xyxy; }";
@@ -917,6 +921,66 @@ DEF_TEST(SkRuntimeEffectThreaded, r) {
     }
 }
 
+DEF_TEST(SkRuntimeEffectMakeBatch, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // The output of each effect depends on its index, so that they are all distinct.
+    static constexpr char kShader[]      = "half4 main(float2 p) { return half4(%d.0 / 32); }";
+    static constexpr char kColorFilter[] = "half4 main(half4 c) { return half4(%d.0/32, c.gba); }";
+    static constexpr char kBlender[]     = "half4 main(half4 s, half4 d) { return s * %d.0 / 32; }";
+    // Errors are reported per request, without affecting the rest of the batch.
+    static constexpr char kInvalid[]     = "half4 main(half4 c) { return undefined; }";
+
+    std::vector<SkRuntimeEffect::BatchRequest> requests;
+    for (int i = 0; i < 32; ++i) {
+        switch (i % 4) {
+            case 0: requests.push_back({SkRuntimeEffect::MakeForShader,
+                                        SkStringPrintf(kShader, i), {}});      break;
+            case 1: requests.push_back({SkRuntimeEffect::MakeForColorFilter,
+                                        SkStringPrintf(kColorFilter, i), {}}); break;
+            case 2: requests.push_back({SkRuntimeEffect::MakeForBlender,
+                                        SkStringPrintf(kBlender, i), {}});     break;
+            case 3: requests.push_back({SkRuntimeEffect::MakeForColorFilter,
+                                        SkString(kInvalid), {}});              break;
+        }
+    }
+
+    std::vector<SkRuntimeEffect::Result> results(requests.size());
+    std::vector<int> callCounts(requests.size(), 0);
+    SkRuntimeEffect::MakeBatch(SkMakeSpan(requests),
+                               [&](int index, SkRuntimeEffect::Result result) {
+                                   callCounts[index]++;
+                                   results[index] = std::move(result);
+                               },
+                               executor.get());
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        REPORTER_ASSERT(r, callCounts[i] == 1);
+        if (i % 4 == 3) {
+            REPORTER_ASSERT(r, !results[i].effect);
+            REPORTER_ASSERT(r, results[i].errorText.contains("unknown identifier 'undefined'"));
+            continue;
+        }
+        REPORTER_ASSERT(r, results[i].effect, "%s", results[i].errorText.c_str());
+        if (i % 4 == 1) {
+            // Effects work the same way, regardless of which compiler they were built with.
+            sk_sp<SkColorFilter> cf = results[i].effect->makeColorFilter(SkData::MakeEmpty());
+            SkColor4f c = cf->filterColor4f({1, 1, 1, 1}, sk_srgb_singleton(),
+                                            sk_srgb_singleton());
+            REPORTER_ASSERT(r, c.fR == i / 32.0f);
+        }
+    }
+
+    // Without an executor, the batch runs on the default one.
+    int calls = 0;
+    SkRuntimeEffect::MakeBatch(SkMakeSpan(requests).first(2),
+                               [&](int, SkRuntimeEffect::Result result) {
+                                   calls++;
+                                   REPORTER_ASSERT(r, result.effect);
+                               });
+    REPORTER_ASSERT(r, calls == 2);
+}
+
 DEF_TEST(SkRuntimeColorFilterSingleColor, r) {
     // Test runtime colorfilters support filterColor4f().
     auto [effect, err] =
@@ -935,6 +999,170 @@ DEF_TEST(SkRuntimeColorFilterSingleColor, r) {
     REPORTER_ASSERT(r, c.fA == 1.0f);
 }
 
+DEF_TEST(SkRuntimeEffectCacheCountLimit, r) {
+    static constexpr char kSourceA[] = "half4 main(half4 c) { return c.bgra; }";
+    static constexpr char kSourceB[] = "half4 main(half4 c) { return c.gbra; }";
+
+    // A cache of our own, so other tests using the global one can't evict from it.
+    SkRuntimeEffectCache cache(2);
+    REPORTER_ASSERT(r, cache.countLimit() == 2);
+
+    auto a = cache.findOrMake(SkRuntimeEffect::MakeForColorFilter, SkString{kSourceA});
+    auto b = cache.findOrMake(SkRuntimeEffect::MakeForColorFilter, SkString{kSourceB});
+    REPORTER_ASSERT(r, a && b && a != b);
+    REPORTER_ASSERT(r, b == cache.findOrMake(SkRuntimeEffect::MakeForColorFilter,
+                                             SkString{kSourceB}));
+    REPORTER_ASSERT(r, a == cache.findOrMake(SkRuntimeEffect::MakeForColorFilter,
+                                             SkString{kSourceA}));
+
+    // A was used last, so lowering the limit to one effect evicts B.
+    REPORTER_ASSERT(r, cache.setCountLimit(1) == 2);
+    REPORTER_ASSERT(r, a == cache.findOrMake(SkRuntimeEffect::MakeForColorFilter,
+                                             SkString{kSourceA}));
+    REPORTER_ASSERT(r, b != cache.findOrMake(SkRuntimeEffect::MakeForColorFilter,
+                                             SkString{kSourceB}));
+
+    // ... and compiling B again evicted A.
+    REPORTER_ASSERT(r, a != cache.findOrMake(SkRuntimeEffect::MakeForColorFilter,
+                                             SkString{kSourceA}));
+
+    // Failed compiles aren't cached.
+    REPORTER_ASSERT(r, !cache.findOrMake(SkRuntimeEffect::MakeForColorFilter,
+                                         SkString{"half4 main(half4 c) { return d; }"}));
+}
+
+DEF_TEST(SkRuntimeEffectPersistentCache, r) {
+    class TestCache : public SkRuntimeEffect::PersistentCache {
+    public:
+        sk_sp<SkData> load(const SkData& key) override {
+            SkAutoMutexExclusive lock(fMutex);
+            fLoads++;
+            auto found = fEntries.find(key_string(key));
+            return found != fEntries.end() ? found->second : nullptr;
+        }
+
+        void store(const SkData& key, const SkData& data) override {
+            SkAutoMutexExclusive lock(fMutex);
+            fStores++;
+            fEntries[key_string(key)] = SkData::MakeWithCopy(data.data(), data.size());
+        }
+
+        SkMutex                              fMutex;
+        std::map<std::string, sk_sp<SkData>> fEntries;
+        int                                  fLoads  = 0,
+                                             fStores = 0;
+
+    private:
+        static std::string key_string(const SkData& key) {
+            return std::string(static_cast<const char*>(key.data()), key.size());
+        }
+    };
+
+    // The child call and the uniform exercise the parts of the program that need reflection after
+    // being loaded from the cache.
+    const SkString source(R"(
+        uniform shader child;
+        uniform half4 tint;
+        half4 main(float2 p) { return child.eval(p) * tint; }
+    )");
+
+    auto draw = [](const sk_sp<SkRuntimeEffect>& effect) {
+        SkRuntimeShaderBuilder builder(effect);
+        builder.uniform("tint") = std::array<float, 4>{0.5f, 1, 0, 1};
+        builder.child("child") = SkShaders::Color(SK_ColorWHITE);
+
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(1, 1);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setShader(builder.makeShader());
+        canvas.drawPaint(paint);
+        return bitmap.getColor(0, 0);
+    };
+
+    TestCache cache;
+    SkRuntimeEffect::Options options;
+    options.persistentCache = &cache;
+
+    // A cold compile populates the persistent cache...
+    auto [cold, err] = SkRuntimeEffect::MakeForShader(source, options);
+    REPORTER_ASSERT(r, cold, "%s", err.c_str());
+    REPORTER_ASSERT(r, cache.fStores == 1 && cache.fEntries.size() == 1);
+
+    // ... and a warm one uses it, producing the same effect.
+    auto [warm, warmErr] = SkRuntimeEffect::MakeForShader(source, options);
+    REPORTER_ASSERT(r, warm, "%s", warmErr.c_str());
+    REPORTER_ASSERT(r, cache.fLoads == 2 && cache.fStores == 1);
+
+    REPORTER_ASSERT(r, warm != cold);
+    REPORTER_ASSERT(r, warm->source() == cold->source());
+    REPORTER_ASSERT(r, warm->uniformSize() == cold->uniformSize());
+    REPORTER_ASSERT(r, warm->children().size() == 1);
+    REPORTER_ASSERT(r, draw(warm) == draw(cold));
+    REPORTER_ASSERT(r, draw(warm) == SkColorSetARGB(0xFF, 0x80, 0xFF, 0x00));
+
+    // Different options produce different programs, so they don't share cache entries.
+    SkRuntimeEffect::Options es3Options = SkRuntimeEffectPriv::ES3Options();
+    es3Options.persistentCache = &cache;
+    auto [es3, es3Err] = SkRuntimeEffect::MakeForShader(source, es3Options);
+    REPORTER_ASSERT(r, es3, "%s", es3Err.c_str());
+    REPORTER_ASSERT(r, cache.fStores == 2 && cache.fEntries.size() == 2);
+
+    // Effects without the cache in their options don't use it.
+    auto [uncached, uncachedErr] = SkRuntimeEffect::MakeForShader(source);
+    REPORTER_ASSERT(r, uncached, "%s", uncachedErr.c_str());
+    REPORTER_ASSERT(r, cache.fLoads == 3 && cache.fStores == 2);
+
+    // Programs calling intrinsics resolve them against the runtime effect module when loaded.
+    const SkString intrinsics(R"(
+        half4 main(float2 p) {
+            return half4(half(sin(p.x)), mix(0.25, 0.75, half(fract(p.y))), 0, 1);
+        }
+    )");
+    auto [coldIntrinsics, coldIntrinsicsErr] = SkRuntimeEffect::MakeForShader(intrinsics, options);
+    REPORTER_ASSERT(r, coldIntrinsics, "%s", coldIntrinsicsErr.c_str());
+    auto [warmIntrinsics, warmIntrinsicsErr] = SkRuntimeEffect::MakeForShader(intrinsics, options);
+    REPORTER_ASSERT(r, warmIntrinsics, "%s", warmIntrinsicsErr.c_str());
+    REPORTER_ASSERT(r, cache.fStores == 3);
+    if (coldIntrinsics && warmIntrinsics) {
+        auto drawIntrinsics = [](const sk_sp<SkRuntimeEffect>& effect) {
+            SkBitmap bitmap;
+            bitmap.allocN32Pixels(1, 1);
+            SkCanvas canvas(bitmap);
+            SkPaint paint;
+            paint.setShader(effect->makeShader(/*uniforms=*/nullptr, /*children=*/nullptr,
+                                               /*childCount=*/0));
+            canvas.drawPaint(paint);
+            return bitmap.getColor(0, 0);
+        };
+        REPORTER_ASSERT(r, drawIntrinsics(warmIntrinsics) == drawIntrinsics(coldIntrinsics));
+        REPORTER_ASSERT(r, drawIntrinsics(warmIntrinsics) == SkColorSetARGB(0xFF, 0x7A, 0x80, 0));
+    }
+
+    // Unusable data is ignored (and replaced): truncated data fails cleanly...
+    int stores = cache.fStores;
+    for (auto& [key, data] : cache.fEntries) {
+        for (size_t size = 0; size < data->size(); ++size) {
+            SkRuntimeEffect::Options truncatedOptions = options;
+            TestCache truncated;
+            truncated.fEntries[key] = SkData::MakeSubset(data.get(), 0, size);
+            truncatedOptions.persistentCache = &truncated;
+            const SkString& sksl = key.find("mix") != std::string::npos ? intrinsics : source;
+            auto [effect, effectErr] = SkRuntimeEffect::MakeForShader(sksl, truncatedOptions);
+            REPORTER_ASSERT(r, effect, "%s", effectErr.c_str());
+            REPORTER_ASSERT(r, truncated.fStores == 1, "%zu of %zu bytes", size, data->size());
+        }
+    }
+
+    // ... as does garbage.
+    for (auto& [key, data] : cache.fEntries) {
+        data = SkData::MakeWithCString("garbage");
+    }
+    auto [recompiled, recompiledErr] = SkRuntimeEffect::MakeForShader(source, options);
+    REPORTER_ASSERT(r, recompiled, "%s", recompiledErr.c_str());
+    REPORTER_ASSERT(r, cache.fStores == stores + 1);
+}
+
 static void test_RuntimeEffectStructNameReuse(skiatest::Reporter* r, GrRecordingContext* rContext) {
     // Test that two different runtime effects can reuse struct names in a single paint operation
     auto [childEffect, err] = SkRuntimeEffect::MakeForShader(SkString(
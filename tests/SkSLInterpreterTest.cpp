@@ -297,6 +297,31 @@ DEF_TEST(SkSLInterpreterMatrix, r) {
     }
 }
 
+DEF_TEST(SkSLInterpreterSparseMatrix, r) {
+    // Products with diagonal or resized matrices skip the terms with a constant zero factor, but
+    // still produce the same results.
+    test(r,
+         "void main(inout half4 color) {"
+         "    color.rgb = half3x3(2) * color.rgb;"
+         "}",
+         1, 2, 3, 4,
+         2, 4, 6, 4);
+    test(r,
+         "void main(inout half4 color) {"
+         "    half4x4 m = half4x4(half2x2(color.a, 1, 0, color.a));"
+         "    color = m * color;"
+         "}",
+         1, 2, 3, 4,
+         4, 9, 3, 4);
+    test(r,
+         "void main(inout half4 color) {"
+         "    half2x2 m = half2x2(color.r, 0, 0, color.g) * half2x2(1, 0, color.b, 1);"
+         "    color = half4(m[0], m[1]);"
+         "}",
+         1, 2, 3, 4,
+         1, 0, 3, 2);
+}
+
 DEF_TEST(SkSLInterpreterTernary, r) {
     test(r, "void main(inout half4 color) { color.r = color.g > color.b ? color.g : color.b; }",
          0, 1, 2, 0, 2, 1, 2, 0);
@@ -412,6 +437,54 @@ DEF_TEST(SkSLInterpreterFor, r) {
          495, 0, 0, 0);
 }
 
+DEF_TEST(SkSLInterpreterForEarlyExit, r) {
+    auto optimized_size = [&](const char* src) -> size_t {
+        ProgramBuilder program(r, src);
+        if (!program) { return 0; }
+        const SkSL::FunctionDefinition* main = SkSL::Program_GetFunction(*program, "main");
+        skvm::Builder b;
+        SkSL::ProgramToSkVM(*program, *main, &b, /*debugTrace=*/nullptr, /*uniforms=*/{});
+        return b.optimize().size();
+    };
+
+    // Iterations after an unconditional break are never generated, so the size of the program
+    // doesn't depend on the loop count.
+    static constexpr char kShortLoop[] =
+            "void main(inout half4 color) {"
+            "    for (int i = 0; i < 4; ++i) {"
+            "        if (i == 2) { color.g = color.r; }"
+            "        color.r += half(i) * color.b;"
+            "        if (i == 2) break;"
+            "    }"
+            "}";
+    static constexpr char kLongLoop[] =
+            "void main(inout half4 color) {"
+            "    for (int i = 0; i < 100; ++i) {"
+            "        if (i == 2) { color.g = color.r; }"
+            "        color.r += half(i) * color.b;"
+            "        if (i == 2) break;"
+            "    }"
+            "}";
+    test(r, kShortLoop, 1, 0, 2, 0,
+                        7, 3, 2, 0);
+    test(r, kLongLoop, 1, 0, 2, 0,
+                       7, 3, 2, 0);
+    REPORTER_ASSERT(r, optimized_size(kShortLoop) == optimized_size(kLongLoop));
+
+    // The same goes for code following a return.
+    test(r,
+         "void main(inout half4 color) {"
+         "    for (int i = 0; i < 100; ++i) {"
+         "        half x = half(i);"
+         "        color.r += x;"
+         "        if (i == 3) return;"
+         "    }"
+         "    color.r = 0;"
+         "}",
+         0, 0, 0, 0,
+         6, 0, 0, 0);
+}
+
 DEF_TEST(SkSLInterpreterPrefixPostfix, r) {
     test(r, "void main(inout half4 color) { color.r = ++color.g; }", 1, 2, 3, 4, 3, 3, 3, 4);
     test(r, "void main(inout half4 color) { color.r = color.g++; }", 1, 2, 3, 4, 2, 3, 3, 4);
@@ -11,10 +11,16 @@ static DEFINE_bool(forceAnalyticAA, false,
             "Force analytic anti-aliasing even if the path is complicated: "
             "whether it's concave or convex, we consider a path complicated"
             "if its number of points is comparable to its resolution.");
+static DEFINE_bool(deltaAA, false,
+            "If true, use delta-based analytic anti-aliasing for complex (concave) paths");
+static DEFINE_bool(forceDeltaAA, false,
+            "Force delta-based analytic anti-aliasing for every path it can fill");
 
 void SetAnalyticAA() {
     gSkUseAnalyticAA   = FLAGS_analyticAA;
     gSkForceAnalyticAA = FLAGS_forceAnalyticAA;
+    gSkUseDeltaAA      = FLAGS_deltaAA;
+    gSkForceDeltaAA    = FLAGS_forceDeltaAA;
 }
 
 }